@@ -0,0 +1,291 @@
+// Copyright (c) 2021 The Blocknet developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BLOCKNET_ARENAMAP_H
+#define BLOCKNET_ARENAMAP_H
+
+#include <algorithm>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <stdint.h>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/**
+ * Open addressing hash map with its elements allocated from an arena.
+ *
+ * The table is a linear probing array of 8 byte slots, each holding 32 bits of
+ * the key hash and the index of the element in the arena. Elements are
+ * allocated in chunks instead of one heap node each, erased elements are
+ * recycled through a free list and clear() releases whole chunks.
+ *
+ * Like std::unordered_map, references to elements stay valid until the element
+ * is erased, and iterators are invalidated by inserts that grow the table.
+ * Erasing leaves a tombstone and never moves other elements, so erasing while
+ * iterating is fine. Only the subset of the std::unordered_map interface used
+ * by the coins cache is provided.
+ */
+template <typename K, typename T, typename Hash>
+class arenamap
+{
+public:
+    typedef K key_type;
+    typedef T mapped_type;
+    typedef std::pair<const K, T> value_type;
+    typedef size_t size_type;
+
+private:
+    struct Slot {
+        uint32_t tag;
+        uint32_t index; //!< arena index + 2, or one of EMPTY and TOMBSTONE
+    };
+    static const uint32_t EMPTY = 0;
+    static const uint32_t TOMBSTONE = 1;
+    static const uint32_t FIRST_INDEX = 2;
+
+    static const size_t MIN_TABLE_SIZE = 16;
+    static const size_t MIN_CHUNK_SHIFT = 5;  //!< 32 elements
+    static const size_t MAX_CHUNK_SHIFT = 12; //!< 4096 elements
+
+    typedef typename std::aligned_storage<sizeof(value_type), alignof(value_type)>::type Storage;
+
+    std::vector<Slot> m_table;
+    std::vector<std::unique_ptr<Storage[]>> m_chunks;
+    std::vector<uint32_t> m_free;
+    uint32_t m_next{0}; //!< first arena index never handed out
+    size_t m_chunk_shift{MIN_CHUNK_SHIFT};
+    size_t m_size{0};
+    size_t m_tombstones{0};
+    Hash m_hash;
+
+    value_type* At(uint32_t index) const
+    {
+        return reinterpret_cast<value_type*>(&m_chunks[index >> m_chunk_shift][index & ((uint32_t{1} << m_chunk_shift) - 1)]);
+    }
+
+    static uint32_t Tag(uint64_t hash) { return static_cast<uint32_t>(hash >> 32); }
+
+    size_t NextOccupied(size_t pos) const
+    {
+        while (pos < m_table.size() && m_table[pos].index < FIRST_INDEX)
+            ++pos;
+        return pos;
+    }
+
+    /** Slot holding key, or m_table.size() if there is none. */
+    size_t FindSlot(const K& key, uint64_t hash) const
+    {
+        if (m_table.empty())
+            return 0;
+        const size_t mask = m_table.size() - 1;
+        const uint32_t tag = Tag(hash);
+        for (size_t pos = hash & mask; ; pos = (pos + 1) & mask) {
+            const Slot& slot = m_table[pos];
+            if (slot.index == EMPTY)
+                return m_table.size();
+            if (slot.index != TOMBSTONE && slot.tag == tag && At(slot.index - FIRST_INDEX)->first == key)
+                return pos;
+        }
+    }
+
+    /** First empty slot or tombstone on the probe sequence of hash. */
+    size_t FreeSlot(uint64_t hash) const
+    {
+        const size_t mask = m_table.size() - 1;
+        size_t pos = hash & mask;
+        while (m_table[pos].index >= FIRST_INDEX)
+            pos = (pos + 1) & mask;
+        return pos;
+    }
+
+    void Rehash(size_t capacity)
+    {
+        std::vector<Slot> old(capacity, Slot{0, EMPTY});
+        old.swap(m_table);
+        m_tombstones = 0;
+        for (const Slot& slot : old) {
+            if (slot.index < FIRST_INDEX)
+                continue;
+            const uint64_t hash = m_hash(At(slot.index - FIRST_INDEX)->first);
+            m_table[FreeSlot(hash)] = slot;
+        }
+    }
+
+    uint32_t Allocate()
+    {
+        if (!m_free.empty()) {
+            const uint32_t index = m_free.back();
+            m_free.pop_back();
+            return index;
+        }
+        if ((m_next >> m_chunk_shift) >= m_chunks.size())
+            m_chunks.emplace_back(new Storage[size_t{1} << m_chunk_shift]);
+        return m_next++;
+    }
+
+    template <bool Const>
+    class iter
+    {
+        friend class arenamap;
+        template <bool> friend class iter;
+
+        const arenamap* m_map{nullptr};
+        size_t m_pos{0};
+
+        iter(const arenamap* map, size_t pos) : m_map(map), m_pos(pos) {}
+
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef typename std::conditional<Const, const arenamap::value_type, arenamap::value_type>::type value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef value_type* pointer;
+        typedef value_type& reference;
+
+        iter() {}
+        template <bool C = Const, typename = typename std::enable_if<C>::type>
+        iter(const iter<false>& other) : m_map(other.m_map), m_pos(other.m_pos) {}
+
+        reference operator*() const { return *m_map->At(m_map->m_table[m_pos].index - FIRST_INDEX); }
+        pointer operator->() const { return &**this; }
+        iter& operator++() { m_pos = m_map->NextOccupied(m_pos + 1); return *this; }
+        iter operator++(int) { iter ret = *this; ++*this; return ret; }
+
+        template <bool C>
+        bool operator==(const iter<C>& other) const { return m_pos == other.m_pos && m_map == other.m_map; }
+        template <bool C>
+        bool operator!=(const iter<C>& other) const { return !(*this == other); }
+    };
+
+public:
+    typedef iter<false> iterator;
+    typedef iter<true> const_iterator;
+
+    arenamap() {}
+    arenamap(const arenamap&) = delete;
+    arenamap& operator=(const arenamap&) = delete;
+    ~arenamap() { clear(); }
+
+    iterator begin() { return iterator(this, NextOccupied(0)); }
+    iterator end() { return iterator(this, m_table.size()); }
+    const_iterator begin() const { return const_iterator(this, NextOccupied(0)); }
+    const_iterator end() const { return const_iterator(this, m_table.size()); }
+
+    size_type size() const { return m_size; }
+    bool empty() const { return m_size == 0; }
+
+    iterator find(const K& key) { return iterator(this, FindSlot(key, m_hash(key))); }
+    const_iterator find(const K& key) const { return const_iterator(this, FindSlot(key, m_hash(key))); }
+
+    template <typename... Args>
+    std::pair<iterator, bool> emplace(std::piecewise_construct_t, std::tuple<const K&> key, std::tuple<Args...> args)
+    {
+        const uint64_t hash = m_hash(std::get<0>(key));
+        const size_t found = FindSlot(std::get<0>(key), hash);
+        if (found != m_table.size())
+            return std::make_pair(iterator(this, found), false);
+
+        // Keep at least one in eight slots empty so that probing terminates
+        // and probe sequences stay short.
+        if ((m_size + m_tombstones + 1) * 8 > m_table.size() * 7) {
+            size_t capacity = std::max(m_table.size(), size_t{MIN_TABLE_SIZE});
+            while ((m_size + 1) * 2 > capacity)
+                capacity *= 2;
+            Rehash(capacity);
+        }
+
+        const uint32_t index = Allocate();
+        try {
+            new (At(index)) value_type(std::piecewise_construct, std::move(key), std::move(args));
+        } catch (...) {
+            m_free.push_back(index);
+            throw;
+        }
+        const size_t pos = FreeSlot(hash);
+        if (m_table[pos].index == TOMBSTONE)
+            --m_tombstones;
+        m_table[pos] = Slot{Tag(hash), index + FIRST_INDEX};
+        ++m_size;
+        return std::make_pair(iterator(this, pos), true);
+    }
+
+    template <typename V>
+    std::pair<iterator, bool> emplace(const K& key, V&& value)
+    {
+        return emplace(std::piecewise_construct, std::forward_as_tuple(key), std::forward_as_tuple(std::forward<V>(value)));
+    }
+
+    T& operator[](const K& key)
+    {
+        return emplace(std::piecewise_construct, std::forward_as_tuple(key), std::tuple<>()).first->second;
+    }
+
+    iterator erase(const_iterator it)
+    {
+        Slot& slot = m_table[it.m_pos];
+        const uint32_t index = slot.index - FIRST_INDEX;
+        At(index)->~value_type();
+        m_free.push_back(index);
+        --m_size;
+        // A slot followed by an empty one ends every probe sequence through
+        // it, so it can be emptied instead of becoming a tombstone.
+        if (m_table[(it.m_pos + 1) & (m_table.size() - 1)].index == EMPTY) {
+            slot.index = EMPTY;
+        } else {
+            slot.index = TOMBSTONE;
+            ++m_tombstones;
+        }
+        return iterator(this, NextOccupied(it.m_pos + 1));
+    }
+
+    /** Destroy all elements and release the arena. The table keeps its capacity. */
+    void clear()
+    {
+        if (m_size > 0 || m_tombstones > 0) {
+            for (Slot& slot : m_table) {
+                if (slot.index >= FIRST_INDEX)
+                    At(slot.index - FIRST_INDEX)->~value_type();
+                slot.index = EMPTY;
+            }
+        }
+        m_chunks.clear();
+        std::vector<uint32_t>().swap(m_free);
+        m_next = 0;
+        m_size = 0;
+        m_tombstones = 0;
+    }
+
+    /**
+     * Size the table for n elements without growing. If the map has not
+     * allocated any element yet this also picks an arena chunk size to match.
+     */
+    void reserve(size_type n)
+    {
+        if (m_next == 0) {
+            m_chunk_shift = MIN_CHUNK_SHIFT;
+            while (m_chunk_shift < MAX_CHUNK_SHIFT && (size_t{1} << (m_chunk_shift + 8)) < n)
+                ++m_chunk_shift;
+        }
+        size_t capacity = MIN_TABLE_SIZE;
+        while ((n + 1) * 8 > capacity * 7)
+            capacity *= 2;
+        if (capacity > m_table.size())
+            Rehash(capacity);
+    }
+
+    /** Call f with the size in bytes of each heap allocation held by the map. */
+    template <typename F>
+    void for_each_allocation(F f) const
+    {
+        f(m_table.capacity() * sizeof(Slot));
+        f(m_chunks.capacity() * sizeof(std::unique_ptr<Storage[]>));
+        for (size_t i = 0; i < m_chunks.size(); ++i)
+            f(sizeof(Storage) << m_chunk_shift);
+        f(m_free.capacity() * sizeof(uint32_t));
+    }
+};
+
+#endif // BLOCKNET_ARENAMAP_H
@@ -0,0 +1,93 @@
+// Copyright (c) 2021 The Blocknet developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+#include <coins.h>
+#include <random.h>
+
+#include <unordered_map>
+#include <vector>
+
+// Compares the coins cache map against the std::unordered_map it replaced,
+// on the operations CCoinsViewCache performs: inserting fetched coins, looking
+// them up again, and emptying the map on flush.
+
+typedef std::unordered_map<COutPoint, CCoinsCacheEntry, SaltedOutpointHasher> CCoinsUnorderedMap;
+
+static const size_t COINS_MAP_ENTRIES = 20000;
+
+static std::vector<COutPoint> MakeOutpoints(size_t count)
+{
+    FastRandomContext rng(true);
+    std::vector<COutPoint> outpoints;
+    outpoints.reserve(count);
+    for (size_t i = 0; i < count; ++i)
+        outpoints.emplace_back(rng.rand256(), rng.randrange(4));
+    return outpoints;
+}
+
+static CCoinsCacheEntry MakeEntry(size_t i)
+{
+    CTxOut out(static_cast<CAmount>(i), CScript() << OP_DUP << OP_HASH160 << std::vector<unsigned char>(20, i & 0xff) << OP_EQUALVERIFY << OP_CHECKSIG);
+    return CCoinsCacheEntry(Coin(std::move(out), 1, false));
+}
+
+template <typename Map>
+static void CoinsMapInsert(benchmark::State& state)
+{
+    const std::vector<COutPoint> outpoints = MakeOutpoints(COINS_MAP_ENTRIES);
+    while (state.KeepRunning()) {
+        Map map;
+        for (size_t i = 0; i < outpoints.size(); ++i)
+            map.emplace(outpoints[i], MakeEntry(i));
+        assert(map.size() == outpoints.size());
+    }
+}
+
+template <typename Map>
+static void CoinsMapLookup(benchmark::State& state)
+{
+    const std::vector<COutPoint> outpoints = MakeOutpoints(COINS_MAP_ENTRIES);
+    const std::vector<COutPoint> missing = MakeOutpoints(COINS_MAP_ENTRIES / 4);
+    Map map;
+    for (size_t i = 0; i < outpoints.size(); ++i)
+        map.emplace(outpoints[i], MakeEntry(i));
+    size_t i = 0;
+    while (state.KeepRunning()) {
+        // Mostly hits with some misses, as when connecting a block
+        for (int j = 0; j < 4; ++j)
+            assert(map.find(outpoints[i++ % outpoints.size()]) != map.end());
+        assert(map.find(missing[i % missing.size()]) == map.end());
+    }
+}
+
+template <typename Map>
+static void CoinsMapErase(benchmark::State& state)
+{
+    const std::vector<COutPoint> outpoints = MakeOutpoints(COINS_MAP_ENTRIES);
+    while (state.KeepRunning()) {
+        Map map;
+        for (size_t i = 0; i < outpoints.size(); ++i)
+            map.emplace(outpoints[i], MakeEntry(i));
+        // Spend half the coins, then drain the rest like BatchWrite does
+        for (size_t i = 0; i < outpoints.size(); i += 2)
+            map.erase(map.find(outpoints[i]));
+        for (auto it = map.begin(); it != map.end(); it = map.erase(it)) {}
+        assert(map.empty());
+    }
+}
+
+static void CoinsMapInsertUnordered(benchmark::State& state) { CoinsMapInsert<CCoinsUnorderedMap>(state); }
+static void CoinsMapInsertArena(benchmark::State& state) { CoinsMapInsert<CCoinsMap>(state); }
+static void CoinsMapLookupUnordered(benchmark::State& state) { CoinsMapLookup<CCoinsUnorderedMap>(state); }
+static void CoinsMapLookupArena(benchmark::State& state) { CoinsMapLookup<CCoinsMap>(state); }
+static void CoinsMapEraseUnordered(benchmark::State& state) { CoinsMapErase<CCoinsUnorderedMap>(state); }
+static void CoinsMapEraseArena(benchmark::State& state) { CoinsMapErase<CCoinsMap>(state); }
+
+BENCHMARK(CoinsMapInsertUnordered, 20);
+BENCHMARK(CoinsMapInsertArena, 20);
+BENCHMARK(CoinsMapLookupUnordered, 500 * 1000);
+BENCHMARK(CoinsMapLookupArena, 500 * 1000);
+BENCHMARK(CoinsMapEraseUnordered, 10);
+BENCHMARK(CoinsMapEraseArena, 10);
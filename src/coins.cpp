@@ -217,6 +217,11 @@ void CCoinsViewCache::Uncache(const COutPoint& hash)
     }
 }
 
+void CCoinsViewCache::ReserveCache(size_t nUsage) {
+    // Each entry costs its arena storage plus on average two table slots.
+    cacheCoins.reserve(nUsage / (sizeof(CCoinsMap::value_type) + 16));
+}
+
 unsigned int CCoinsViewCache::GetCacheSize() const {
     return cacheCoins.size();
 }
@@ -25,11 +25,15 @@
 #include <validation.h>
 #include <validationinterface.h>
 
+#include <atomic>
+#include <memory>
 #include <regex>
+#include <set>
 #include <string>
 #include <utility>
 
 #include <boost/algorithm/string.hpp>
+#include <boost/signals2/signal.hpp>
 #include <boost/thread.hpp>
 
 /**
@@ -128,6 +132,7 @@ static const uint8_t NETWORK_VERSION = 0x01;
 static const CAmount VOTING_UTXO_INPUT_AMOUNT = 1 * COIN;
 static const int VINHASH_SIZE = 12;
 static const int PROPOSAL_USERDEFINED_LIMIT = 139;
+static const int VOTE_RECOVERY_MIN_BATCH = 32; // minimum number of votes per pubkey recovery thread
 typedef std::array<unsigned char, VINHASH_SIZE> VinHash;
 
 /**
@@ -523,7 +528,7 @@ public:
         // Ensure the pubkey of the utxo matches the pubkey of the vote signature
         if (keyid.IsNull())
             return false;
-        if (pubkey.GetID() != keyid)
+        if (getPubKey().GetID() != keyid)
             return false;
         return true;
     }
@@ -577,6 +582,7 @@ public:
         signature.clear();
         if (!key.SignCompact(sigHash(), signature))
             return false;
+        pubkeyRecovered = true;
         return pubkey.RecoverCompact(sigHash(), signature);
     }
 
@@ -683,13 +689,30 @@ public:
     }
 
     /**
-     * Get the pubkey associated with the vote's signature.
+     * Get the pubkey associated with the vote's signature. The pubkey is
+     * recovered from the signature on first use.
      * @return
      */
     const CPubKey & getPubKey() const {
+        recoverPubKey();
         return pubkey;
     }
 
+    /**
+     * Recovers the pubkey from the vote's signature if this hasn't happened
+     * yet. Pubkey recovery is expensive and is deferred until the pubkey is
+     * needed, votes that are discarded earlier never pay for it. Votes loaded
+     * from the governance db already carry their pubkey.
+     * @return true if the vote has a valid pubkey.
+     */
+    bool recoverPubKey() const {
+        if (!pubkeyRecovered) {
+            pubkey.RecoverCompact(csighash, signature);
+            pubkeyRecovered = true;
+        }
+        return pubkey.IsValid();
+    }
+
     /**
      * Get the COutPoint of the vote. This is the outpoint of the OP_RETURN data
      * in the "voting" transaction. This shouldn't be confused with the vote's
@@ -746,7 +769,8 @@ public:
         if (ser_action.ForRead()) { // assign memory only fields
             chash = getHash(false);
             csighash = sigHash(false);
-            pubkey.RecoverCompact(csighash, signature);
+            pubkey = CPubKey(); // recovered lazily, see getPubKey()
+            pubkeyRecovered = false;
         }
     }
 
@@ -770,7 +794,8 @@ protected:
     COutPoint utxo; // voting on behalf of this utxo
 
 protected: // memory only
-    CPubKey pubkey;
+    mutable CPubKey pubkey; // recovered from signature on demand
+    mutable bool pubkeyRecovered{false};
     COutPoint outpoint; // of vote's OP_RETURN outpoint
     int64_t time{0}; // block time of vote
     CAmount amount{0}; // of vote's utxo (this is not the OP_RETURN outpoint amount, which is 0)
@@ -782,6 +807,42 @@ protected: // memory only
     uint256 csighash; // cached sighash
 };
 
+/**
+ * Recovers the signature pubkeys of the specified votes in a single batch,
+ * sharding the votes across worker threads when the batch is large enough.
+ * Votes that already carry a pubkey are skipped.
+ * @param votes
+ * @param nthreads Maximum number of threads to use, 0 uses all available cores.
+ */
+static void RecoverVotePubKeys(const std::vector<const Vote*> & votes, const int & nthreads = 0) {
+    const int cores = nthreads <= 0 ? GetNumCores() : nthreads;
+    const int total = static_cast<int>(votes.size());
+    const int shards = std::max(1, std::min(cores, total / VOTE_RECOVERY_MIN_BATCH));
+    auto recover = [&votes](const int start, const int end) {
+        for (int i = start; i < end; ++i)
+            votes[i]->recoverPubKey();
+    };
+    if (shards == 1) {
+        recover(0, total);
+        return;
+    }
+    const int slice = total / shards;
+    boost::thread_group tg;
+    for (int k = 0; k < shards; ++k) {
+        const int start = k*slice;
+        const int end = k == shards-1 ? total : start+slice;
+        try {
+            tg.create_thread([start,end,&recover] {
+                RenameThread("blocknet-govrecover");
+                recover(start, end);
+            });
+        } catch (...) {
+            recover(start, end); // try single threaded on failure
+        }
+    }
+    tg.join_all();
+}
+
 /**
  * Check that utxo isn't already spent
  * @param vote
@@ -930,10 +991,12 @@ public:
             if (chash.IsNull())
                 chash = getHash(false);
             if (csighash.IsNull())
-                csighash = getHash(false);
+                csighash = sigHash(false);
         }
         READWRITE(chash);
         READWRITE(csighash);
+        if (ser_action.ForRead()) // persisted pubkey avoids recovery on load
+            pubkeyRecovered = pubkey.IsValid();
     }
 
     void SetNull() {
@@ -945,6 +1008,7 @@ public:
         signature.clear();
         utxo.SetNull();
         pubkey = CPubKey();
+        pubkeyRecovered = false;
         outpoint.SetNull();
         time = 0;
         amount = 0;
@@ -968,7 +1032,8 @@ public:
         vinhash = v.vinhash;
         signature = v.signature;
         utxo = v.utxo;
-        pubkey = v.pubkey;
+        pubkey = v.getPubKey(); // persist the recovered pubkey
+        pubkeyRecovered = v.pubkeyRecovered;
         outpoint = v.outpoint;
         time = v.time;
         amount = v.amount;
@@ -1039,10 +1104,26 @@ struct Hasher {
  */
 class Governance : public CValidationInterface {
 public:
+    /**
+     * Expected payees of a superblock derived from its vote set. Shared by staking and
+     * superblock validation for as long as the governance state doesn't change.
+     */
+    struct SuperblockCommitment {
+        int superblock{0};
+        uint64_t version{0}; // governance state the payees were derived from
+        bool hasResults{false}; // at least one proposal passed
+        std::vector<CTxOut> payees;
+    };
+
     explicit Governance(const int64_t cache) {
         db = MakeUnique<GovernanceDB>(cache, false, fReindex);
     }
 
+    /** Notifies listeners of a proposal accepted on the chain tip. */
+    boost::signals2::signal<void (const Proposal & proposal)> NotifyProposalAccepted;
+    /** Notifies listeners of a vote accepted on the chain tip. */
+    boost::signals2::signal<void (const Vote & vote)> NotifyVoteAccepted;
+
     /**
      * Returns true if the proposal with the specified name exists.
      * @param name
@@ -1124,7 +1205,9 @@ public:
         votes.clear();
         stackvotes.clear();
         sbvotes.clear();
+        utxovotes.clear();
         db->Reset(true);
+        ++version;
         return true;
     }
 
@@ -1438,9 +1521,19 @@ public:
             }
         }
 
+        ++version;
         return true;
     }
 
+    /**
+     * Returns the version of the governance state, which changes whenever
+     * blocks are connected or disconnected from the governance system.
+     * @return
+     */
+    uint64_t getVersion() const {
+        return version;
+    }
+
     /**
      * Fetch the specified proposal.
      * @param hash Proposal hash
@@ -1564,6 +1657,32 @@ public:
         return vos;
     }
 
+    /**
+     * Fetch the unspent votes cast with the specified utxo along with their proposals. Only
+     * proposals who's superblocks are at or ahead of the specified block are included.
+     * @param utxo Voting utxo
+     * @param since Block number to start search from
+     * @return
+     */
+    std::vector<std::pair<Proposal, Vote>> getVotesForUtxo(const COutPoint & utxo, const int & since) {
+        LOCK(mu);
+        std::vector<std::pair<Proposal, Vote>> r;
+        const auto it = utxovotes.find(utxo);
+        if (it == utxovotes.end())
+            return r;
+        for (const auto & voteHash : it->second) {
+            const auto vit = votes.find(voteHash);
+            if (vit == votes.end() || vit->second.spent())
+                continue;
+            const auto & vote = vit->second;
+            const auto pit = proposals.find(vote.getProposal());
+            if (pit == proposals.end() || pit->second.getSuperblock() < since)
+                continue;
+            r.emplace_back(pit->second, vote);
+        }
+        return r;
+    }
+
     /**
      * Fetch all votes in the specified superblock that haven't been spent.
      * @param superblock Block number of superblock
@@ -1756,7 +1875,10 @@ public:
                 psRet.insert(proposal);
         }
         // Insert votes after proposals in case votes depend on proposals in
-        // the same block.
+        // the same block. Votes are filtered with the cheap checks first so
+        // that signature pubkeys are only recovered (in batch) for votes that
+        // are still candidates.
+        std::vector<std::pair<Vote, const std::set<VinHash>*>> candidates;
         for (auto vote : vs) {
             // If we are processing the chain tip we want to perform a proposal
             // check here. Check that the vote is associated with a valid proposal.
@@ -1775,13 +1897,25 @@ public:
                 }
             }
 
-            const auto voteHash = vote.getHash();
-
             // Load the vote utxo (performs cs_main lock)
             if (!vote.loadVoteUTXO())
                 continue;
-            const auto vhash = vh.find(voteHash);
-            if (vhash == vh.end() || !vote.isValid(vhash->second, params))
+            const auto vhash = vh.find(vote.getHash());
+            if (vhash == vh.end() || !vote.isValidVinHash(vhash->second))
+                continue;
+            candidates.emplace_back(std::move(vote), &vhash->second);
+        }
+
+        std::vector<const Vote*> recover;
+        recover.reserve(candidates.size());
+        for (const auto & item : candidates)
+            recover.push_back(&item.first);
+        RecoverVotePubKeys(recover);
+
+        for (auto & item : candidates) {
+            auto & vote = item.first;
+            const auto voteHash = vote.getHash();
+            if (!vote.isValid(*item.second, params))
                 continue;
 
             // Handle vote changes, if a vote already exists and the user
@@ -1909,15 +2043,11 @@ public:
         if (!block->IsProofOfStake())
             return false;
 
-        // Get the results and sort descending by passing percent.
-        // We want to sort descending because the most valuable
-        // proposals are those with the highest passing percentage,
-        // in this case we want them at the beginning of the list.
-        const auto & results = getSuperblockResults(blockHeight, params);
-        if (results.empty())
+        const auto commitment = getSuperblockCommitment(blockHeight, params);
+        if (!commitment->hasResults)
             return true;
 
-        auto payees = getSuperblockPayees(blockHeight, results, params);
+        auto payees = commitment->payees;
         if (payees.empty())
             return false;
 
@@ -1948,6 +2078,40 @@ public:
         return vouts.size() <= 2 && payees.empty();
     }
 
+    /**
+     * Returns the expected payees of the specified superblock. The payees are derived from
+     * the vote set once per governance state, which changes whenever blocks are connected
+     * or disconnected (including reorgs).
+     * @param superblock
+     * @param params
+     * @return
+     */
+    std::shared_ptr<const SuperblockCommitment> getSuperblockCommitment(const int & superblock, const Consensus::Params & params) {
+        const uint64_t v = version;
+        {
+            LOCK(sbmu);
+            if (sbcommitment && sbcommitment->superblock == superblock && sbcommitment->version == v)
+                return sbcommitment;
+        }
+
+        // Get the results and sort descending by passing percent.
+        // We want to sort descending because the most valuable
+        // proposals are those with the highest passing percentage,
+        // in this case we want them at the beginning of the list.
+        auto commitment = std::make_shared<SuperblockCommitment>();
+        commitment->superblock = superblock;
+        commitment->version = v;
+        const auto & results = getSuperblockResults(superblock, params);
+        commitment->hasResults = !results.empty();
+        if (commitment->hasResults)
+            commitment->payees = getSuperblockPayees(superblock, results, params);
+
+        LOCK(sbmu);
+        if (!sbcommitment || sbcommitment->version <= v) // do not replace a newer commitment
+            sbcommitment = commitment;
+        return commitment;
+    }
+
     /**
      * Returns true if the specified utxo exists in an active and valid proposal who's voting period has ended.
      * @param utxo
@@ -1981,15 +2145,7 @@ public:
      * @return
      */
     bool utxoInVote(const COutPoint & utxo, const int & blockHeight, const Consensus::Params & params) {
-        const auto sproposals = getProposalsSince(blockHeight);
-        for (const auto & proposal : sproposals) {
-            const auto svotes = getVotes(proposal.getHash());
-            for (const auto & vote : svotes) {
-                if (utxo == vote.getUtxo())
-                    return true;
-            }
-        }
-        return false;
+        return !getVotesForUtxo(utxo, blockHeight).empty();
     }
 
     /**
@@ -2002,13 +2158,9 @@ public:
      */
     void utxosInVotes(const std::set<COutPoint> & utxos, const int & blockHeight, std::set<COutPoint> & utxosRet, const Consensus::Params & params) {
         utxosRet.clear();
-        const auto sproposals = getProposalsSince(blockHeight);
-        for (const auto & proposal : sproposals) {
-            const auto svotes = getVotes(proposal.getHash());
-            for (const auto & vote : svotes) {
-                if (utxos.count(vote.getUtxo()))
-                    utxosRet.insert(vote.getUtxo());
-            }
+        for (const auto & utxo : utxos) {
+            if (utxoInVote(utxo, blockHeight, params))
+                utxosRet.insert(utxo);
         }
     }
 
@@ -2308,6 +2460,10 @@ protected:
             return;
         processBlock(block.get(), pindex->nHeight, params);
         db->BlockConnected(block, pindex, txn_conflicted);
+        ++version;
+        // Voting on the next superblock is over, derive its payees ahead of staking and validation
+        if (isSuperblock(pindex->nHeight + 1, params))
+            getSuperblockCommitment(pindex->nHeight + 1, params);
     }
 
     void BlockDisconnected(const std::shared_ptr<const CBlock>& block) override {
@@ -2384,8 +2540,10 @@ protected:
                 removeProposal(proposal);
         }
 
-        if (blockHeight == maxInt)
+        if (blockHeight == maxInt) {
+            ++version;
             return; // do not unspend votes if block height is undefined
+        }
 
         // Unspend any vote utxos that were spent by this
         // block. Only unspend those votes where the block
@@ -2416,6 +2574,7 @@ protected:
                 unspendVote(v.getHash(), blockHeight, prevouts[v.getUtxo()]);
             }
         }
+        ++version;
     }
 
     /**
@@ -2448,9 +2607,21 @@ protected:
                 addProposal(p, processingChainTip);
             for (const auto & v : vs)
                 addVote(v, processingChainTip);
-            // If not processing tip or no votes, then no more to do
-            if (!processingChainTip || votes.empty())
-                return;
+        }
+        // If not processing tip then no more to do
+        if (!processingChainTip)
+            return;
+
+        // Notify listeners outside the lock
+        for (const auto & p : ps)
+            NotifyProposalAccepted(p);
+        for (const auto & v : vs)
+            NotifyVoteAccepted(v);
+
+        {
+            LOCK(mu);
+            if (votes.empty())
+                return; // no votes, no more to do
         }
 
         // This section requires chain tip processing flag to be set
@@ -2500,6 +2671,7 @@ protected:
         const auto & voteHash = vote.getHash();
         stackvotes[voteHash].push_back(vote);
         votes[voteHash] = vote; // add to votes data provider
+        utxovotes[vote.getUtxo()].insert(voteHash);
 
         const auto & proposal = proposals[vote.getProposal()];
         auto & vs = sbvotes[proposal.getSuperblock()];
@@ -2527,11 +2699,13 @@ protected:
             if (stackvotes[voteHash].empty()) {
                 stackvotes.erase(voteHash);
                 votes.erase(voteHash);
+                unindexVote(vote.getUtxo(), voteHash);
             } else
                 votes[voteHash] = stackvotes[voteHash].back();
         } else {
             stackvotes.erase(voteHash);
             votes.erase(voteHash);
+            unindexVote(vote.getUtxo(), voteHash);
         }
 
         // Erase from db
@@ -2577,6 +2751,7 @@ protected:
             if (stackvotes[voteHash].empty()) {
                 stackvotes.erase(voteHash);
                 votes.erase(voteHash);
+                unindexVote(vote.getUtxo(), voteHash);
             } else
                 votes[voteHash] = stackvotes[voteHash].back();
 
@@ -2599,6 +2774,20 @@ protected:
         return false;
     }
 
+    /**
+     * Removes the vote from the utxo index.
+     * @param utxo Voting utxo
+     * @param voteHash
+     */
+    void unindexVote(const COutPoint & utxo, const uint256 & voteHash) EXCLUSIVE_LOCKS_REQUIRED(mu) {
+        auto it = utxovotes.find(utxo);
+        if (it == utxovotes.end())
+            return;
+        it->second.erase(voteHash);
+        if (it->second.empty())
+            utxovotes.erase(it);
+    }
+
     /**
      * Adds the proposal
      * @param proposal
@@ -2630,7 +2819,11 @@ protected:
     std::unordered_map<uint256, Vote, Hasher> votes GUARDED_BY(mu);
     std::unordered_map<uint256, std::vector<Vote>, Hasher> stackvotes GUARDED_BY(mu);
     std::unordered_map<int, std::unordered_map<uint256, Vote, Hasher>> sbvotes GUARDED_BY(mu);
+    std::unordered_map<COutPoint, std::set<uint256>, Hasher> utxovotes GUARDED_BY(mu); // vote hashes by voting utxo
     std::unique_ptr<GovernanceDB> db;
+    std::atomic<uint64_t> version{0};
+    Mutex sbmu;
+    std::shared_ptr<const SuperblockCommitment> sbcommitment GUARDED_BY(sbmu);
 };
 
 }
@@ -534,21 +534,14 @@ bool SubmitVotes(const std::vector<ProposalVote> & proposalVotes, const std::vec
 bool RevoteOnStake(const int & stakedHeight, const COutPoint & utxo, const CKey & key, const std::pair<CTxOut,COutPoint> & stakeUtxo,
         CWallet *wallet, CTransactionRef & tx, const Consensus::Params & params)
 {
-    auto props = Governance::instance().getProposals(); // copy
     std::vector<std::pair<Proposal, Vote>> selprops;
     // Find all proposals in current or future superblock that have votes that
-    // match the staked utxo
-    for (auto & ps : props) {
-        // Are we in a current or future proposal
-        if (ps.getSuperblock() > stakedHeight && !Governance::insideVoteCutoff(ps.getSuperblock(), stakedHeight, params)) {
-            auto vvs = Governance::instance().getVotes(ps.getHash()); // copy
-            for (const auto & vs : vvs) {
-                if (vs.getUtxo() == utxo && ps.isValid(params)) {
-                    selprops.emplace_back(ps, vs);
-                    break;
-                }
-            }
-        }
+    // match the staked utxo. Most staked utxos have no votes, in which case the
+    // index lookup lets us bail out before touching the wallet.
+    for (auto & item : Governance::instance().getVotesForUtxo(utxo, stakedHeight + 1)) {
+        const auto & ps = item.first;
+        if (!Governance::insideVoteCutoff(ps.getSuperblock(), stakedHeight, params) && ps.isValid(params))
+            selprops.push_back(item);
     }
 
     if (selprops.empty())
@@ -196,7 +196,7 @@ static bool HTTPReq_JSONRPC(HTTPRequest* req, const std::string &)
 
         // array of requests
         } else if (valRequest.isArray())
-            strReply = JSONRPCExecBatch(jreq, valRequest.get_array());
+            strReply = JSONRPCExecBatch(jreq, valRequest.get_array(), HTTPEnqueueBatchWork);
         else
             throw JSONRPCError(RPC_PARSE_ERROR, "Top-level object parse error");
 
@@ -14,6 +14,7 @@
 #include <sync.h>
 #include <ui_interface.h>
 
+#include <deque>
 #include <memory>
 #include <stdio.h>
 #include <stdlib.h>
@@ -61,6 +62,22 @@ private:
     HTTPRequestHandler func;
 };
 
+/** Work item running an arbitrary function on a work queue */
+class HTTPFunctionWorkItem final : public HTTPClosure
+{
+public:
+    explicit HTTPFunctionWorkItem(std::function<void()> _func) : func(std::move(_func))
+    {
+    }
+    void operator()() override
+    {
+        func();
+    }
+
+private:
+    std::function<void()> func;
+};
+
 /** Simple work queue for distributing work over multiple threads.
  * Work items are simply callable objects.
  */
@@ -148,6 +165,8 @@ struct evhttp* eventHTTP = nullptr;
 static std::vector<CSubNet> rpc_allow_subnets;
 //! Work queue for handling longer requests off the event loop thread
 static WorkQueue<HTTPClosure>* workQueue = nullptr;
+//! Work queue for the concurrent elements of JSON-RPC batch requests
+static WorkQueue<HTTPClosure>* batchWorkQueue = nullptr;
 //! Handlers for (sub)paths
 std::vector<HTTPPathHandler> pathHandlers;
 //! Bound listening sockets
@@ -347,6 +366,13 @@ static void HTTPWorkQueueRun(WorkQueue<HTTPClosure>* queue)
     queue->Run();
 }
 
+/** Simple wrapper to set thread name and run the batch work queue */
+static void HTTPBatchWorkQueueRun(WorkQueue<HTTPClosure>* queue)
+{
+    RenameThread("blocknet-httpbatch");
+    queue->Run();
+}
+
 /** libevent event log callback */
 static void libevent_log_cb(int severity, const char *msg)
 {
@@ -405,6 +431,9 @@ bool InitHTTPServer()
     LogPrintf("HTTP: creating work queue of depth %d\n", workQueueDepth);
 
     workQueue = new WorkQueue<HTTPClosure>(workQueueDepth);
+    // Batch elements have their own queue so that large batch requests can't
+    // take up the request work queue and get other clients rejected
+    batchWorkQueue = new WorkQueue<HTTPClosure>(HTTP_BATCH_WORKQUEUE_PER_THREAD * HTTPBatchThreads());
     // transfer ownership to eventBase/HTTP via .release()
     eventBase = base_ctr.release();
     eventHTTP = http_ctr.release();
@@ -427,6 +456,7 @@ bool UpdateHTTPServerLogging(bool enable) {
 
 std::thread threadHTTP;
 static std::vector<std::thread> g_thread_http_workers;
+static std::vector<std::thread> g_thread_http_batch_workers;
 
 void StartHTTPServer()
 {
@@ -438,6 +468,11 @@ void StartHTTPServer()
     for (int i = 0; i < rpcThreads; i++) {
         g_thread_http_workers.emplace_back(HTTPWorkQueueRun, workQueue);
     }
+    const int batchThreads = HTTPBatchThreads();
+    LogPrintf("HTTP: starting %d batch worker threads\n", batchThreads);
+    for (int i = 0; i < batchThreads; i++) {
+        g_thread_http_batch_workers.emplace_back(HTTPBatchWorkQueueRun, batchWorkQueue);
+    }
 }
 
 void InterruptHTTPServer()
@@ -449,6 +484,8 @@ void InterruptHTTPServer()
     }
     if (workQueue)
         workQueue->Interrupt();
+    if (batchWorkQueue)
+        batchWorkQueue->Interrupt();
 }
 
 void StopHTTPServer()
@@ -463,6 +500,14 @@ void StopHTTPServer()
         delete workQueue;
         workQueue = nullptr;
     }
+    if (batchWorkQueue) {
+        for (auto& thread: g_thread_http_batch_workers) {
+            thread.join();
+        }
+        g_thread_http_batch_workers.clear();
+        delete batchWorkQueue;
+        batchWorkQueue = nullptr;
+    }
     // Unlisten sockets, these are what make the event loop running, which means
     // that after this and all connections are closed the event loop will quit.
     for (evhttp_bound_socket *socket : boundSockets) {
@@ -489,6 +534,22 @@ struct event_base* EventBase()
     return eventBase;
 }
 
+int HTTPBatchThreads()
+{
+    return std::max((int)gArgs.GetArg("-rpcbatchthreads", DEFAULT_HTTP_BATCH_THREADS), 1);
+}
+
+bool HTTPEnqueueBatchWork(std::function<void()> func)
+{
+    if (!batchWorkQueue)
+        return false;
+    std::unique_ptr<HTTPFunctionWorkItem> item(new HTTPFunctionWorkItem(std::move(func)));
+    if (!batchWorkQueue->Enqueue(item.get()))
+        return false;
+    item.release(); // queue takes ownership
+    return true;
+}
+
 static void httpevent_callback_fn(evutil_socket_t, short, void* data)
 {
     // Static handler: simply call inner handler
@@ -578,10 +639,37 @@ void HTTPRequest::WriteReply(int nStatus, const std::string& strReply)
     if (ShutdownRequested()) {
         WriteHeader("Connection", "close");
     }
-    // Send event to main http thread to send reply message
     struct evbuffer* evb = evhttp_request_get_output_buffer(req);
     assert(evb);
     evbuffer_add(evb, strReply.data(), strReply.size());
+    SendReply(nStatus);
+}
+
+void HTTPRequest::WriteReply(int nStatus, std::shared_ptr<const std::vector<unsigned char>> reply)
+{
+    assert(!replySent && req);
+    if (ShutdownRequested()) {
+        WriteHeader("Connection", "close");
+    }
+    struct evbuffer* evb = evhttp_request_get_output_buffer(req);
+    assert(evb);
+    if (!reply->empty()) {
+        // The output buffer holds a reference on the data until it has been
+        // written to the socket, at which point the cleanup callback releases it.
+        auto ref = new std::shared_ptr<const std::vector<unsigned char>>(std::move(reply));
+        if (evbuffer_add_reference(evb, (*ref)->data(), (*ref)->size(), [](const void*, size_t, void* extra) {
+                delete static_cast<std::shared_ptr<const std::vector<unsigned char>>*>(extra);
+            }, ref) != 0) {
+            evbuffer_add(evb, (*ref)->data(), (*ref)->size());
+            delete ref;
+        }
+    }
+    SendReply(nStatus);
+}
+
+void HTTPRequest::SendReply(int nStatus)
+{
+    // Send event to main http thread to send reply message
     auto req_copy = req;
     HTTPEvent* ev = new HTTPEvent(eventBase, true, [req_copy, nStatus]{
         evhttp_send_reply(req_copy, nStatus, nullptr, nullptr);
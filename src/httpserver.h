@@ -8,10 +8,15 @@
 #include <string>
 #include <stdint.h>
 #include <functional>
+#include <memory>
+#include <vector>
 
 static const int DEFAULT_HTTP_THREADS=4;
 static const int DEFAULT_HTTP_WORKQUEUE=16;
 static const int DEFAULT_HTTP_SERVER_TIMEOUT=30;
+static const int DEFAULT_HTTP_BATCH_THREADS=4;
+/** Queued JSON-RPC batch elements per batch worker thread */
+static const int HTTP_BATCH_WORKQUEUE_PER_THREAD=4;
 
 struct evhttp_request;
 struct event_base;
@@ -51,6 +56,14 @@ void UnregisterHTTPHandler(const std::string &prefix, bool exactMatch);
  */
 struct event_base* EventBase();
 
+/** Queue a function on the JSON-RPC batch work queue, to be run by one of the
+ * batch worker threads. Returns false if the work queue is full or not running.
+ */
+bool HTTPEnqueueBatchWork(std::function<void()> func);
+
+/** Number of threads evaluating JSON-RPC batch elements (-rpcbatchthreads) */
+int HTTPBatchThreads();
+
 /** In-flight HTTP request.
  * Thin C++ wrapper around evhttp_request.
  */
@@ -60,6 +73,9 @@ private:
     struct evhttp_request* req;
     bool replySent;
 
+    /** Hand the request back to the main http thread to send the reply. */
+    void SendReply(int nStatus);
+
 public:
     explicit HTTPRequest(struct evhttp_request* req);
     ~HTTPRequest();
@@ -114,6 +130,15 @@ public:
      * main thread, do not call any other HTTPRequest methods after calling this.
      */
     void WriteReply(int nStatus, const std::string& strReply = "");
+
+    /**
+     * Write HTTP reply with a shared binary body without copying it. The
+     * buffer is referenced by the output buffer and kept alive until libevent
+     * has finished sending it.
+     *
+     * @note Can be called only once, see WriteReply above.
+     */
+    void WriteReply(int nStatus, std::shared_ptr<const std::vector<unsigned char>> reply);
 };
 
 /** Event handler closure.
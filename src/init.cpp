@@ -80,6 +80,7 @@
 #include <zmq/zmqabstractnotifier.h>
 #include <zmq/zmqnotificationinterface.h>
 #include <zmq/zmqrpc.h>
+#include <xbridge/xuiconnector.h>
 #endif
 
 bool fFeeEstimatesInitialized = false;
@@ -185,6 +186,42 @@ static std::unique_ptr<ECCVerifyHandle> globalVerifyHandle;
 
 static boost::thread_group threadGroup;
 static CScheduler scheduler;
+static CScheduler validationScheduler;
+
+#if ENABLE_ZMQ
+// Governance, servicenode and xbridge events published over zmq
+static std::vector<boost::signals2::connection> g_zmq_blocknet_connections;
+
+static void ConnectZMQBlocknetSignals()
+{
+    auto *zmq = g_zmq_notification_interface;
+    auto & gov = gov::Governance::instance();
+    auto & smgr = sn::ServiceNodeMgr::instance();
+    g_zmq_blocknet_connections = {
+        gov.NotifyProposalAccepted.connect([zmq](const gov::Proposal & proposal) { zmq->NotifyProposal(proposal); }),
+        gov.NotifyVoteAccepted.connect([zmq](const gov::Vote & vote) { zmq->NotifyVote(vote); }),
+        smgr.NotifyServiceNodeRegistered.connect([zmq](const sn::ServiceNode & snode) { zmq->NotifyServiceNodeRegistered(snode); }),
+        smgr.NotifyServiceNodePing.connect([zmq](const sn::ServiceNodePing & ping) { zmq->NotifyServiceNodePing(ping); }),
+        smgr.NotifyServiceNodeStateChanged.connect([zmq](const sn::ServiceNode & snode) { zmq->NotifyServiceNodeStateChanged(snode); }),
+        xuiConnector.NotifyXBridgeTransactionReceived.connect([zmq](const xbridge::TransactionDescrPtr & order) {
+            if (order)
+                zmq->NotifyXBridgeOrder(*order);
+        }),
+        xuiConnector.NotifyXBridgeTransactionChanged.connect([zmq](const uint256 & id) {
+            auto order = xbridge::App::instance().transaction(id);
+            if (order)
+                zmq->NotifyXBridgeOrder(*order);
+        }),
+    };
+}
+
+static void DisconnectZMQBlocknetSignals()
+{
+    for (auto & conn : g_zmq_blocknet_connections)
+        conn.disconnect();
+    g_zmq_blocknet_connections.clear();
+}
+#endif
 
 void Interrupt()
 {
@@ -300,6 +337,7 @@ void Shutdown(InitInterfaces& interfaces)
 
 #if ENABLE_ZMQ
     if (g_zmq_notification_interface) {
+        DisconnectZMQBlocknetSignals();
         UnregisterValidationInterface(g_zmq_notification_interface);
         delete g_zmq_notification_interface;
         g_zmq_notification_interface = nullptr;
@@ -412,6 +450,7 @@ void SetupServerArgs()
     gArgs.AddArg("-persistmempool", strprintf("Whether to save the mempool on shutdown and load on restart (default: %u)", DEFAULT_PERSIST_MEMPOOL), false, OptionsCategory::OPTIONS);
     gArgs.AddArg("-pid=<file>", strprintf("Specify pid file. Relative paths will be prefixed by a net-specific datadir location. (default: %s)", BITCOIN_PID_FILENAME), false, OptionsCategory::OPTIONS);
     gArgs.AddArg("-prune=<n>", "Pruning is not supported", false, OptionsCategory::OPTIONS);
+    gArgs.AddArg("-rawblockcache=<n>", strprintf("Number of recently served raw blocks to keep in memory for peers, REST, RPC and zmq consumers (0 to disable, default: %u)", DEFAULT_RAW_BLOCK_CACHE_SIZE), false, OptionsCategory::OPTIONS);
     gArgs.AddArg("-reindex", "Rebuild chain state and block index from the blk*.dat files on disk", false, OptionsCategory::OPTIONS);
     gArgs.AddArg("-reindex-chainstate", "Rebuild chain state from the currently indexed blocks. When in pruning mode or if blocks on disk might be corrupted, use full -reindex instead.", false, OptionsCategory::OPTIONS);
     gArgs.AddArg("-staking", "Mine blocks on this node (default: 1). Can be used to specify search interval, staking=number_of_seconds (default: 15)", false, OptionsCategory::OPTIONS);
@@ -423,6 +462,7 @@ void SetupServerArgs()
     hidden_args.emplace_back("-sysperms");
 #endif
     gArgs.AddArg("-txindex", "Blocknet requires txindex to support the Proof of Stake protocol.", false, OptionsCategory::OPTIONS);
+    gArgs.AddArg("-validationcallbackthreads=<n>", strprintf("Number of threads servicing block and transaction notifications to subsystems, each subsystem keeps its notifications in order (1 to %d, default: %d)", MAX_VALIDATION_CALLBACK_THREADS, DEFAULT_VALIDATION_CALLBACK_THREADS), false, OptionsCategory::OPTIONS);
     gArgs.AddArg("-lowmemoryload", "Use less memory during initial load. This may result in longer load times, however, may improve loading on memory constrained devices if out of memory errors persist (e.g. Rasp Pi)", false, OptionsCategory::OPTIONS);
 
     gArgs.AddArg("-addnode=<ip>", "Add a node to connect to and attempt to keep the connection open (see the `addnode` RPC command help for more info). This option can be specified multiple times to add multiple nodes.", false, OptionsCategory::CONNECTION);
@@ -475,19 +515,31 @@ void SetupServerArgs()
     gArgs.AddArg("-zmqpubhashtx=<address>", "Enable publish hash transaction in <address>", false, OptionsCategory::ZMQ);
     gArgs.AddArg("-zmqpubrawblock=<address>", "Enable publish raw block in <address>", false, OptionsCategory::ZMQ);
     gArgs.AddArg("-zmqpubrawtx=<address>", "Enable publish raw transaction in <address>", false, OptionsCategory::ZMQ);
+    gArgs.AddArg("-zmqpubgovernance=<address>", "Enable publish governance proposals and votes in <address>", false, OptionsCategory::ZMQ);
+    gArgs.AddArg("-zmqpubservicenode=<address>", "Enable publish servicenode registrations, pings and state changes in <address>", false, OptionsCategory::ZMQ);
+    gArgs.AddArg("-zmqpubxbridgeorder=<address>", "Enable publish XBridge order state changes in <address>", false, OptionsCategory::ZMQ);
     gArgs.AddArg("-zmqpubhashblockhwm=<n>", strprintf("Set publish hash block outbound message high water mark (default: %d)", CZMQAbstractNotifier::DEFAULT_ZMQ_SNDHWM), false, OptionsCategory::ZMQ);
     gArgs.AddArg("-zmqpubhashtxhwm=<n>", strprintf("Set publish hash transaction outbound message high water mark (default: %d)", CZMQAbstractNotifier::DEFAULT_ZMQ_SNDHWM), false, OptionsCategory::ZMQ);
     gArgs.AddArg("-zmqpubrawblockhwm=<n>", strprintf("Set publish raw block outbound message high water mark (default: %d)", CZMQAbstractNotifier::DEFAULT_ZMQ_SNDHWM), false, OptionsCategory::ZMQ);
     gArgs.AddArg("-zmqpubrawtxhwm=<n>", strprintf("Set publish raw transaction outbound message high water mark (default: %d)", CZMQAbstractNotifier::DEFAULT_ZMQ_SNDHWM), false, OptionsCategory::ZMQ);
+    gArgs.AddArg("-zmqpubgovernancehwm=<n>", strprintf("Set publish governance outbound message high water mark (default: %d)", CZMQAbstractNotifier::DEFAULT_ZMQ_SNDHWM), false, OptionsCategory::ZMQ);
+    gArgs.AddArg("-zmqpubservicenodehwm=<n>", strprintf("Set publish servicenode outbound message high water mark (default: %d)", CZMQAbstractNotifier::DEFAULT_ZMQ_SNDHWM), false, OptionsCategory::ZMQ);
+    gArgs.AddArg("-zmqpubxbridgeorderhwm=<n>", strprintf("Set publish XBridge order outbound message high water mark (default: %d)", CZMQAbstractNotifier::DEFAULT_ZMQ_SNDHWM), false, OptionsCategory::ZMQ);
 #else
     hidden_args.emplace_back("-zmqpubhashblock=<address>");
     hidden_args.emplace_back("-zmqpubhashtx=<address>");
     hidden_args.emplace_back("-zmqpubrawblock=<address>");
     hidden_args.emplace_back("-zmqpubrawtx=<address>");
+    hidden_args.emplace_back("-zmqpubgovernance=<address>");
+    hidden_args.emplace_back("-zmqpubservicenode=<address>");
+    hidden_args.emplace_back("-zmqpubxbridgeorder=<address>");
     hidden_args.emplace_back("-zmqpubhashblockhwm=<n>");
     hidden_args.emplace_back("-zmqpubhashtxhwm=<n>");
     hidden_args.emplace_back("-zmqpubrawblockhwm=<n>");
     hidden_args.emplace_back("-zmqpubrawtxhwm=<n>");
+    hidden_args.emplace_back("-zmqpubgovernancehwm=<n>");
+    hidden_args.emplace_back("-zmqpubservicenodehwm=<n>");
+    hidden_args.emplace_back("-zmqpubxbridgeorderhwm=<n>");
 #endif
 
     gArgs.AddArg("-checkblocks=<n>", strprintf("How many blocks to check at startup (default: %u, 0 = all)", DEFAULT_CHECKBLOCKS), true, OptionsCategory::DEBUG_TEST);
@@ -514,6 +566,7 @@ void SetupServerArgs()
     gArgs.AddArg("-debug=<category>", "Output debugging information (default: -nodebug, supplying <category> is optional). "
         "If <category> is not supplied or if <category> = 1, output all debugging information. <category> can be: " + ListLogCategories() + ".", false, OptionsCategory::DEBUG_TEST);
     gArgs.AddArg("-debugexclude=<category>", strprintf("Exclude debugging information for a category. Can be used in conjunction with -debug=1 to output debug logs for all categories except one or more specified categories."), false, OptionsCategory::DEBUG_TEST);
+    gArgs.AddArg("-lockprofile", strprintf("Record lock wait and hold times per call site, see getlockcontention (default: %u)", DEFAULT_LOCK_PROFILE), true, OptionsCategory::DEBUG_TEST);
     gArgs.AddArg("-logips", strprintf("Include IP addresses in debug output (default: %u)", DEFAULT_LOGIPS), false, OptionsCategory::DEBUG_TEST);
     gArgs.AddArg("-logtimestamps", strprintf("Prepend debug output with timestamp (default: %u)", DEFAULT_LOGTIMESTAMPS), false, OptionsCategory::DEBUG_TEST);
     gArgs.AddArg("-logtimemicros", strprintf("Add microsecond precision to debug timestamps (default: %u)", DEFAULT_LOGTIMEMICROS), true, OptionsCategory::DEBUG_TEST);
@@ -549,6 +602,8 @@ void SetupServerArgs()
     gArgs.AddArg("-rest", strprintf("Accept public REST requests (default: %u)", DEFAULT_REST_ENABLE), false, OptionsCategory::RPC);
     gArgs.AddArg("-rpcallowip=<ip>", "Allow JSON-RPC connections from specified source. Valid for <ip> are a single IP (e.g. 1.2.3.4), a network/netmask (e.g. 1.2.3.4/255.255.255.0) or a network/CIDR (e.g. 1.2.3.4/24). This option can be specified multiple times", false, OptionsCategory::RPC);
     gArgs.AddArg("-rpcauth=<userpw>", "Username and HMAC-SHA-256 hashed password for JSON-RPC connections. The field <userpw> comes in the format: <USERNAME>:<SALT>$<HASH>. A canonical python script is included in share/rpcauth. The client then connects normally using the rpcuser=<USERNAME>/rpcpassword=<PASSWORD> pair of arguments. This option can be specified multiple times", false, OptionsCategory::RPC);
+    gArgs.AddArg("-rpcbatchconcurrency=<n>", strprintf("Set the number of read-only calls of a JSON-RPC batch request evaluated concurrently, 1 evaluates calls in order (default: %d)", DEFAULT_RPC_BATCH_CONCURRENCY), false, OptionsCategory::RPC);
+    gArgs.AddArg("-rpcbatchthreads=<n>", strprintf("Set the number of threads evaluating the read-only calls of JSON-RPC batch requests (default: %d)", DEFAULT_HTTP_BATCH_THREADS), false, OptionsCategory::RPC);
     gArgs.AddArg("-rpcbind=<addr>[:port]", "Bind to given address to listen for JSON-RPC connections. Do not expose the RPC server to untrusted networks such as the public internet! This option is ignored unless -rpcallowip is also passed. Port is optional and overrides -rpcport. Use [host]:port notation for IPv6. This option can be specified multiple times (default: 127.0.0.1 and ::1 i.e., localhost)", false, OptionsCategory::RPC);
     gArgs.AddArg("-rpccookiefile=<loc>", "Location of the auth cookie. Relative paths will be prefixed by a net-specific datadir location. (default: data dir)", false, OptionsCategory::RPC);
     gArgs.AddArg("-rpcpassword=<pw>", "Password for JSON-RPC connections", false, OptionsCategory::RPC);
@@ -1073,6 +1128,7 @@ bool AppInitParameterInteraction()
     }
     fCheckBlockIndex = gArgs.GetBoolArg("-checkblockindex", chainparams.DefaultConsistencyChecks());
     fCheckpointsEnabled = gArgs.GetBoolArg("-checkpoints", DEFAULT_CHECKPOINTS_ENABLED);
+    g_lock_profile = gArgs.GetBoolArg("-lockprofile", DEFAULT_LOCK_PROFILE);
 
     hashAssumeValid = uint256S(gArgs.GetArg("-assumevalid", chainparams.GetConsensus().defaultAssumeValid.GetHex()));
     if (!hashAssumeValid.IsNull())
@@ -1219,6 +1275,8 @@ bool AppInitParameterInteraction()
 
     nMaxTipAge = gArgs.GetArg("-maxtipage", DEFAULT_MAX_TIP_AGE);
 
+    nRawBlockCacheSize = std::max<int64_t>(0, gArgs.GetArg("-rawblockcache", DEFAULT_RAW_BLOCK_CACHE_SIZE));
+
     fEnableReplacement = gArgs.GetBoolArg("-mempoolreplacement", DEFAULT_ENABLE_REPLACEMENT);
     if ((!fEnableReplacement) && gArgs.IsArgSet("-mempoolreplacement")) {
         // Minimal effort at forwards compatibility
@@ -1348,7 +1406,16 @@ bool AppInitMain(InitInterfaces& interfaces)
     CScheduler::Function serviceLoop = std::bind(&CScheduler::serviceQueue, &scheduler);
     threadGroup.create_thread(std::bind(&TraceThread<CScheduler::Function>, "scheduler", serviceLoop));
 
-    GetMainSignals().RegisterBackgroundSignalScheduler(scheduler);
+    // Start the validation interface callback threads, every subscriber has
+    // its own queue so that slow subscribers don't hold up the others
+    const int nValidationThreads = std::max(1, std::min<int>(MAX_VALIDATION_CALLBACK_THREADS,
+            gArgs.GetArg("-validationcallbackthreads", DEFAULT_VALIDATION_CALLBACK_THREADS)));
+    LogPrintf("Using %d threads for validation interface callbacks\n", nValidationThreads);
+    CScheduler::Function validationLoop = std::bind(&CScheduler::serviceQueue, &validationScheduler);
+    for (int i = 0; i < nValidationThreads; ++i)
+        threadGroup.create_thread(std::bind(&TraceThread<CScheduler::Function>, "valsched", validationLoop));
+
+    GetMainSignals().RegisterBackgroundSignalScheduler(validationScheduler);
     GetMainSignals().RegisterWithMempoolSignals(mempool);
 
     // Create client interfaces for wallets that are supposed to be loaded
@@ -1400,7 +1467,7 @@ bool AppInitMain(InitInterfaces& interfaces)
     g_connman = std::unique_ptr<CConnman>(new CConnman(GetRand(std::numeric_limits<uint64_t>::max()), GetRand(std::numeric_limits<uint64_t>::max())));
 
     peerLogic.reset(new PeerLogicValidation(g_connman.get(), g_banman.get(), scheduler, gArgs.GetBoolArg("-enablebip61", DEFAULT_ENABLE_BIP61)));
-    RegisterValidationInterface(peerLogic.get());
+    RegisterValidationInterface(peerLogic.get(), "net");
 
     // sanitize comments per BIP-0014, format user agent and check total size
     std::vector<std::string> uacomments;
@@ -1492,7 +1559,7 @@ bool AppInitMain(InitInterfaces& interfaces)
     g_zmq_notification_interface = CZMQNotificationInterface::Create();
 
     if (g_zmq_notification_interface) {
-        RegisterValidationInterface(g_zmq_notification_interface);
+        RegisterValidationInterface(g_zmq_notification_interface, "zmq");
     }
 #endif
     uint64_t nMaxOutboundLimit = 0; //unlimited unless -maxuploadtarget is set
@@ -1534,7 +1601,11 @@ bool AppInitMain(InitInterfaces& interfaces)
     LogPrintf("* Using %.1f MiB for governance database\n", nGovDBCache * (1.0 / 1024 / 1024));
 
     // Governance setup
-    RegisterValidationInterface(&gov::Governance::instance(nGovDBCache));
+    RegisterValidationInterface(&gov::Governance::instance(nGovDBCache), "governance");
+#if ENABLE_ZMQ
+    if (g_zmq_notification_interface)
+        ConnectZMQBlocknetSignals();
+#endif
 
     // Blocknet PoS requires txindex
     g_txindex = MakeUnique<TxIndex>(nTxIndexCache, false, fReindex);
@@ -1621,6 +1692,8 @@ bool AppInitMain(InitInterfaces& interfaces)
 
                 // The on-disk coinsdb is now in a good state, create the cache
                 pcoinsTip.reset(new CCoinsViewCache(pcoinscatcher.get()));
+                // Size the cache table for -dbcache so it does not rehash while warming up
+                pcoinsTip->ReserveCache(nCoinCacheUsage);
 
                 is_coinsview_empty = fReset || fReindexChainState || pcoinsTip->GetBestBlock().IsNull();
                 if (!is_coinsview_empty) {
@@ -1898,9 +1971,13 @@ bool AppInitMain(InitInterfaces& interfaces)
     }
 
 #ifdef ENABLE_WALLET
-    // Start the staker
-    if (gArgs.GetBoolArg("-staking", true))
+    // Start the staker and the threads it searches wallets on
+    if (gArgs.GetBoolArg("-staking", true)) {
+        const int searchThreads = std::min(GetNumCores(), MAX_STAKE_SEARCH_THREADS);
+        for (int i = 0; i < searchThreads - 1; ++i)
+            threadGroup.create_thread(&ThreadStakeSearch);
         threadGroup.create_thread(&ThreadStakeMinter);
+    }
 #endif
 
     // ********************************************************* Step 13: finished
@@ -1963,7 +2040,7 @@ bool AppInitMain(InitInterfaces& interfaces)
         }
 
         // Servicenode validation interface
-        RegisterValidationInterface(&smgr);
+        RegisterValidationInterface(&smgr, "servicenode");
     }
 #endif
 
@@ -369,7 +369,7 @@ bool stakeTargetHitV06(const uint256 & hashProofOfStake, const int64_t & nValueI
     return (UintToArith256(hashProofOfStake) < bnCoinDayWeight * bnTargetPerCoinDay);
 }
 
-bool stakeTargetHitV07(const uint256 & hashProofOfStake, const int64_t & currentStakingTime, const int64_t & prevStakingTime, const int64_t & nValueIn, const arith_uint256 & bnTargetPerCoinDay, const int & nPowTargetSpacing) {
+double stakeWeightMultiplierV07(const int64_t & currentStakingTime, const int64_t & prevStakingTime, const int & nPowTargetSpacing) {
     const auto numberOfSpaces = static_cast<double>(currentStakingTime - prevStakingTime) / nPowTargetSpacing;
     double multiplier{0};
     if (numberOfSpaces <= 1) { // if lte to target spacing
@@ -380,6 +380,11 @@ bool stakeTargetHitV07(const uint256 & hashProofOfStake, const int64_t & current
         multiplier = std::max<double>(1.0, pw);
         multiplier = std::min<double>(2.0, multiplier); // max 2x staking weight
     }
+    return multiplier;
+}
+
+bool stakeTargetHitV07(const uint256 & hashProofOfStake, const int64_t & currentStakingTime, const int64_t & prevStakingTime, const int64_t & nValueIn, const arith_uint256 & bnTargetPerCoinDay, const int & nPowTargetSpacing) {
+    const double multiplier = stakeWeightMultiplierV07(currentStakingTime, prevStakingTime, nPowTargetSpacing);
     const auto stakeWeightMultiplier = arith_uint256(multiplier * 100);
     // Stake weight is 1/200 of the staked input amount multiplied by the multiplier with 100 denominator removed
     const auto bnCoinDayWeight = arith_uint256(nValueIn) * stakeWeightMultiplier / 100 / 100;
@@ -387,6 +392,40 @@ bool stakeTargetHitV07(const uint256 & hashProofOfStake, const int64_t & current
     return (UintToArith256(hashProofOfStake) < bnCoinDayWeight * bnTargetPerCoinDay);
 }
 
+double expectedStakeTime(const int64_t & nValueIn, const unsigned int & nBits, const int64_t & nBlockTime, const Consensus::Params & consensus) {
+    arith_uint256 bnTargetPerCoinDay;
+    bnTargetPerCoinDay.SetCompact(nBits);
+    // Each second is one kernel hash per input, and the chance of a hash meeting
+    // the target is the target scaled by the stake weight (see stakeTargetHit).
+    const double targetChance = static_cast<double>(nValueIn) * bnTargetPerCoinDay.getdouble() / pow(2.0, 256);
+    if (targetChance <= 0)
+        return 0;
+
+    if (!IsProtocolV07(nBlockTime, consensus)) {
+        const double hitChance = targetChance / (IsProtocolV06(nBlockTime, consensus) ? 200 : 100);
+        return 1.0 / std::min(hitChance, 1.0);
+    }
+
+    // The v07 stake weight grows with the time since the previous block, which
+    // resets the weight for every staker. Assume blocks arrive at the target
+    // spacing: the expected time is the expected time to hit within one spacing
+    // (expected min(T, spacing)) divided by the chance to hit within it.
+    const int spacing = consensus.nPowTargetSpacing;
+    double logMiss{0}; // log of the chance of no hit in the first t seconds
+    double withinSpacing{0};
+    for (int t = 1; t <= spacing; ++t) {
+        withinSpacing += exp(logMiss);
+        // Same rounding of the multiplier as stakeTargetHitV07
+        const double multiplier = floor(stakeWeightMultiplierV07(t, 0, spacing) * 100) / 100;
+        const double hitChance = std::min(targetChance * multiplier / 100, 1.0);
+        if (hitChance >= 1.0)
+            return withinSpacing;
+        logMiss += log1p(-hitChance);
+    }
+    const double hitWithinSpacing = -expm1(logMiss);
+    return hitWithinSpacing > 0 ? withinSpacing / hitWithinSpacing : 0;
+}
+
 bool CheckStakeKernelHash(const CBlockIndex *pindexPrev, const CBlockIndex *pindexStake, const unsigned int & nBits,
         const CAmount & txInAmount, const COutPoint & prevout, const int64_t & nBlockTime, const unsigned int & nNonce,
         uint256 & hashProofOfStake, const Consensus::Params & consensus)
@@ -31,6 +31,12 @@ bool stakeTargetHit(const uint256 & hashProofOfStake, const int64_t & nValueIn,
 bool stakeTargetHitV06(const uint256 & hashProofOfStake, const int64_t & nValueIn, const arith_uint256 & bnTargetPerCoinDay);
 bool stakeTargetHitV07(const uint256 & hashProofOfStake, const int64_t & currentStakingTime, const int64_t & prevStakingTime, const int64_t & nValueIn, const arith_uint256 & bnTargetPerCoinDay, const int & nPowTargetSpacing);
 
+// Stake weight multiplier of the v07 protocol for a stake at currentStakingTime after a block at prevStakingTime
+double stakeWeightMultiplierV07(const int64_t & currentStakingTime, const int64_t & prevStakingTime, const int & nPowTargetSpacing);
+
+// Expected seconds until the specified amount hits the stake target under the protocol active at nBlockTime, 0 if never
+double expectedStakeTime(const int64_t & nValueIn, const unsigned int & nBits, const int64_t & nBlockTime, const Consensus::Params & consensus);
+
 bool CheckStakeKernelHash(const CBlockIndex *pindexPrev, const CBlockIndex *pindexStake, const unsigned int & nBits,
         const CAmount & txInAmount, const COutPoint & prevout, const int64_t & nBlockTime, const unsigned int & nNonce,
         uint256 & hashProofOfStake, const Consensus::Params & consensus);
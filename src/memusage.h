@@ -5,6 +5,7 @@
 #ifndef BITCOIN_MEMUSAGE_H
 #define BITCOIN_MEMUSAGE_H
 
+#include <arenamap.h>
 #include <indirectmap.h>
 
 #include <stdlib.h>
@@ -165,6 +166,16 @@ static inline size_t DynamicUsage(const std::unordered_map<X, Y, Z>& m)
     return MallocUsage(sizeof(unordered_node<std::pair<const X, Y> >)) * m.size() + MallocUsage(sizeof(void*) * m.bucket_count());
 }
 
+// arenamap reports its table, arena chunks and free list
+
+template<typename X, typename Y, typename Z>
+static inline size_t DynamicUsage(const arenamap<X, Y, Z>& m)
+{
+    size_t usage = 0;
+    m.for_each_allocation([&usage](size_t bytes) { usage += MallocUsage(bytes); });
+    return usage;
+}
+
 }
 
 #endif // BITCOIN_MEMUSAGE_H
@@ -289,9 +289,9 @@ std::unique_ptr<CBlockTemplate> BlockAssembler::CreateNewBlockPoS(const CInputCo
     coinstakeTx.vout[0].SetNull(); // coinstake
     coinstakeTx.vout[0].nValue = 0;
     if (gov::Governance::isSuperblock(nHeight, chainparams.GetConsensus())) {
-        const auto & results = gov::Governance::instance().getSuperblockResults(nHeight, chainparams.GetConsensus());
-        if (!results.empty()) {
-            const auto &payees = gov::Governance::getSuperblockPayees(nHeight, results, chainparams.GetConsensus());
+        const auto commitment = gov::Governance::instance().getSuperblockCommitment(nHeight, chainparams.GetConsensus());
+        if (commitment->hasResults) {
+            const auto & payees = commitment->payees;
             if (payees.empty())
                 throw std::runtime_error(strprintf("%s: Bad superblock payees, failed to stake", __func__));
             coinstakeTx.vout.resize(2 + payees.size()); // coinstake + stake payment + payees
@@ -1064,19 +1064,27 @@ void static ProcessGetBlockData(CNode* pfrom, const CChainParams& chainparams, c
         std::shared_ptr<const CBlock> pblock;
         if (a_recent_block && a_recent_block->GetHash() == pindex->GetBlockHash()) {
             pblock = a_recent_block;
-        } else if (inv.type == MSG_WITNESS_BLOCK) {
-            // Fast-path: in this case it is possible to serve the block directly from disk,
-            // as the network format matches the format on disk
-            std::vector<uint8_t> block_data;
-            if (!ReadRawBlockFromDisk(block_data, pindex, chainparams.MessageStart())) {
+        } else if (inv.type == MSG_WITNESS_BLOCK || (inv.type == MSG_BLOCK && pfrom->nVersion > LEGACY_PROTOCOL_VERSION)) {
+            // Fast-path: in this case it is possible to serve the block directly from the
+            // raw block cache or disk, as the network format matches the format on disk.
+            // Blocks without witness data serialize identically for non-witness peers.
+            CRawBlockRef rawBlock;
+            if (!ReadRawBlockFromDiskCached(rawBlock, pindex, chainparams.MessageStart())) {
                 assert(!"cannot load block from disk");
             }
-            connman->PushMessage(pfrom, msgMaker.Make(NetMsgType::BLOCK, MakeSpan(block_data)));
-            // Don't set pblock as we've sent the block
+            if (inv.type == MSG_WITNESS_BLOCK || !rawBlock->fHasWitness) {
+                connman->PushMessage(pfrom, msgMaker.Make(NetMsgType::BLOCK, MakeSpan(rawBlock->data)));
+                // Don't set pblock as we've sent the block
+            } else {
+                std::shared_ptr<CBlock> pblockRead = std::make_shared<CBlock>();
+                if (!ReadBlockFromDiskCached(*pblockRead, pindex, chainparams.MessageStart()))
+                    assert(!"cannot load block from disk");
+                pblock = pblockRead;
+            }
         } else {
             // Send block from disk
             std::shared_ptr<CBlock> pblockRead = std::make_shared<CBlock>();
-            if (!ReadBlockFromDisk(*pblockRead, pindex, consensusParams))
+            if (!ReadBlockFromDiskCached(*pblockRead, pindex, chainparams.MessageStart()))
                 assert(!"cannot load block from disk");
             pblock = pblockRead;
         }
@@ -1797,6 +1805,8 @@ bool static ProcessMessage(CNode* pfrom, const std::string& strCommand, CDataStr
             connman->PushMessage(pfrom, msgMaker.Make(NetMsgType::SENDCMPCT, fAnnounceUsingCMPCTBLOCK, nCMPCTBLOCKVersion));
         }
         pfrom->fSuccessfullyConnected = true;
+        if (pfrom->fXRouter && xrouter::App::isEnabled())
+            xrouter::App::instance().onNodeConnected(pfrom);
 
         // Used for logging purposes, update the mean block height across connected nodes
         double meanHeights; int nodeCount;
@@ -2083,7 +2093,7 @@ bool static ProcessMessage(CNode* pfrom, const std::string& strCommand, CDataStr
         }
 
         CBlock block;
-        bool ret = ReadBlockFromDisk(block, pindex, chainparams.GetConsensus());
+        bool ret = ReadBlockFromDiskCached(block, pindex, chainparams.MessageStart());
         assert(ret);
 
         SendBlockTransactions(block, req, pfrom, connman);
@@ -3529,7 +3539,7 @@ bool PeerLogicValidation::SendMessages(CNode* pto)
                     }
                     if (!fGotBlockFromCache) {
                         CBlock block;
-                        bool ret = ReadBlockFromDisk(block, pBestIndex, consensusParams);
+                        bool ret = ReadBlockFromDiskCached(block, pBestIndex, Params().MessageStart());
                         assert(ret);
                         CBlockHeaderAndShortTxIDs cmpctblock(block, state.fWantsCmpctWitness);
                         connman->PushMessage(pto, msgMaker.Make(nSendFlags, NetMsgType::CMPCTBLOCK, cmpctblock));
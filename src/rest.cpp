@@ -7,18 +7,23 @@
 #include <chain.h>
 #include <chainparams.h>
 #include <core_io.h>
+#include <governance/governance.h>
+#include <hash.h>
 #include <httpserver.h>
 #include <index/txindex.h>
 #include <primitives/block.h>
 #include <primitives/transaction.h>
 #include <rpc/blockchain.h>
 #include <rpc/server.h>
+#include <servicenode/servicenodemgr.h>
 #include <streams.h>
 #include <sync.h>
 #include <txmempool.h>
 #include <util/strencodings.h>
 #include <validation.h>
 #include <version.h>
+#include <xbridge/util/xutil.h>
+#include <xbridge/xbridgeapp.h>
 
 #include <boost/algorithm/string.hpp>
 
@@ -62,6 +67,102 @@ struct CCoin {
     }
 };
 
+/** Servicenode entry as served by /rest/servicenodes. */
+struct CRestServiceNode {
+    CPubKey snodePubKey;
+    uint8_t tier{0};
+    CKeyID paymentAddress;
+    int64_t pingTime{0};
+    bool exr{false};
+    std::vector<std::string> services;
+
+    ADD_SERIALIZE_METHODS;
+
+    template <typename Stream, typename Operation>
+    inline void SerializationOp(Stream& s, Operation ser_action)
+    {
+        READWRITE(snodePubKey);
+        READWRITE(tier);
+        READWRITE(paymentAddress);
+        READWRITE(pingTime);
+        READWRITE(exr);
+        READWRITE(services);
+    }
+};
+
+/** Proposal and its vote tally as served by /rest/proposals. */
+struct CRestProposal {
+    uint256 hash;
+    std::string name;
+    int32_t superblock{0};
+    CAmount amount{0};
+    std::string address;
+    std::string url;
+    std::string description;
+    int32_t yes{0};
+    int32_t no{0};
+    int32_t abstain{0};
+    std::string status;
+
+    ADD_SERIALIZE_METHODS;
+
+    template <typename Stream, typename Operation>
+    inline void SerializationOp(Stream& s, Operation ser_action)
+    {
+        READWRITE(hash);
+        READWRITE(name);
+        READWRITE(superblock);
+        READWRITE(amount);
+        READWRITE(address);
+        READWRITE(url);
+        READWRITE(description);
+        READWRITE(yes);
+        READWRITE(no);
+        READWRITE(abstain);
+        READWRITE(status);
+    }
+};
+
+/** Open XBridge order as served by /rest/xbridge/orderbook. */
+struct CRestOrder {
+    uint256 id;
+    std::string maker;
+    uint64_t makerSize{0};
+    std::string taker;
+    uint64_t takerSize{0};
+    uint64_t created{0};
+    uint64_t updated{0};
+    std::string status;
+
+    ADD_SERIALIZE_METHODS;
+
+    template <typename Stream, typename Operation>
+    inline void SerializationOp(Stream& s, Operation ser_action)
+    {
+        READWRITE(id);
+        READWRITE(maker);
+        READWRITE(makerSize);
+        READWRITE(taker);
+        READWRITE(takerSize);
+        READWRITE(created);
+        READWRITE(updated);
+        READWRITE(status);
+    }
+};
+
+/**
+ * Last rendered reply per output format, keyed on its ETag. Lets repeated
+ * requests against an unchanged structure skip rebuilding the body.
+ */
+struct CRestReplyCache {
+    Mutex cs;
+    std::map<RetFormat, std::pair<std::string, std::string>> entries GUARDED_BY(cs);
+};
+
+static CRestReplyCache g_rest_servicenodes_cache;
+static CRestReplyCache g_rest_proposals_cache;
+static CRestReplyCache g_rest_orderbook_cache;
+
 static bool RESTERR(HTTPRequest* req, enum HTTPStatusCode status, std::string message)
 {
     req->WriteHeader("Content-Type", "text/plain");
@@ -114,6 +215,64 @@ static bool CheckWarmup(HTTPRequest* req)
     return true;
 }
 
+/**
+ * Sets the ETag header and answers 304 Not Modified if the client already
+ * holds the representation identified by etag.
+ * @return true if the request was answered
+ */
+static bool RESTNotModified(HTTPRequest* req, const std::string& etag)
+{
+    req->WriteHeader("ETag", etag);
+    const auto inm = req->GetHeader("If-None-Match");
+    if (!inm.first)
+        return false;
+    std::vector<std::string> tags;
+    boost::split(tags, inm.second, boost::is_any_of(","));
+    for (auto& tag : tags) {
+        boost::trim(tag);
+        if (boost::starts_with(tag, "W/"))
+            tag = tag.substr(2);
+        if (tag == "*" || tag == etag) {
+            req->WriteReply(HTTP_NOT_MODIFIED);
+            return true;
+        }
+    }
+    return false;
+}
+
+static std::string RESTETag(const std::string& kind, const std::string& version, RetFormat rf)
+{
+    return strprintf("\"%s-%s-%s\"", kind, version, rf == RetFormat::BINARY ? "bin" : "json");
+}
+
+/**
+ * Writes a versioned reply. The body is built at most once per ETag and
+ * format, conditional requests are answered with 304 without building it.
+ */
+static bool RESTWriteVersioned(HTTPRequest* req, RetFormat rf, const std::string& etag,
+                               CRestReplyCache& cache, const std::function<std::string()>& build)
+{
+    if (RESTNotModified(req, etag))
+        return true;
+
+    std::string body;
+    {
+        LOCK(cache.cs);
+        auto it = cache.entries.find(rf);
+        if (it != cache.entries.end() && it->second.first == etag)
+            body = it->second.second;
+    }
+    if (body.empty()) {
+        body = build();
+        LOCK(cache.cs);
+        cache.entries[rf] = std::make_pair(etag, body);
+    }
+
+    req->WriteHeader("Content-Type", rf == RetFormat::BINARY ? "application/octet-stream" : "application/json");
+    req->WriteReply(HTTP_OK, body);
+    return true;
+}
+
 static bool rest_headers(HTTPRequest* req,
                          const std::string& strURIPart)
 {
@@ -204,7 +363,6 @@ static bool rest_block(HTTPRequest* req,
     if (!ParseHashStr(hashStr, hash))
         return RESTERR(req, HTTP_BAD_REQUEST, "Invalid hash: " + hashStr);
 
-    CBlock block;
     CBlockIndex* pblockindex = nullptr;
     CBlockIndex* tip = nullptr;
     {
@@ -217,7 +375,29 @@ static bool rest_block(HTTPRequest* req,
 
         if (IsBlockPruned(pblockindex))
             return RESTERR(req, HTTP_NOT_FOUND, hashStr + " not available (pruned data)");
+    }
 
+    // Binary and hex formats are served from the raw block bytes whenever they
+    // match the requested serialization, skipping deserialization entirely.
+    if (rf == RetFormat::BINARY || rf == RetFormat::HEX) {
+        CRawBlockRef rawBlock;
+        if (!ReadRawBlockFromDiskCached(rawBlock, pblockindex, Params().MessageStart()))
+            return RESTERR(req, HTTP_NOT_FOUND, hashStr + " not found");
+        if (!(RPCSerializationFlags() & SERIALIZE_TRANSACTION_NO_WITNESS) || !rawBlock->fHasWitness) {
+            if (rf == RetFormat::BINARY) {
+                req->WriteHeader("Content-Type", "application/octet-stream");
+                req->WriteReply(HTTP_OK, std::shared_ptr<const std::vector<unsigned char>>(rawBlock, &rawBlock->data));
+            } else {
+                req->WriteHeader("Content-Type", "text/plain");
+                req->WriteReply(HTTP_OK, HexStr(rawBlock->data) + "\n");
+            }
+            return true;
+        }
+    }
+
+    CBlock block;
+    {
+        LOCK(cs_main);
         if (!ReadBlockFromDisk(block, pblockindex, Params().GetConsensus()))
             return RESTERR(req, HTTP_NOT_FOUND, hashStr + " not found");
     }
@@ -621,6 +801,188 @@ static bool rest_blockhash_by_height(HTTPRequest* req,
     }
 }
 
+static bool rest_servicenodes(HTTPRequest* req, const std::string& strURIPart)
+{
+    if (!CheckWarmup(req))
+        return false;
+    std::string param;
+    const RetFormat rf = ParseDataFormat(param, strURIPart);
+    if (rf != RetFormat::BINARY && rf != RetFormat::JSON)
+        return RESTERR(req, HTTP_NOT_FOUND, "output format not found (available: bin, json)");
+
+    // Read the version before the list so a concurrent change is never
+    // served under a stale tag.
+    const auto etag = RESTETag("snodes", std::to_string(sn::ServiceNodeMgr::instance().getVersion()), rf);
+    return RESTWriteVersioned(req, rf, etag, g_rest_servicenodes_cache, [rf]() -> std::string {
+        std::vector<CRestServiceNode> snodes;
+        for (const auto& snode : sn::ServiceNodeMgr::instance().list()) {
+            CRestServiceNode entry;
+            entry.snodePubKey = snode.getSnodePubKey();
+            entry.tier = snode.getTier();
+            entry.paymentAddress = snode.getPaymentAddress();
+            entry.pingTime = snode.getPingTime();
+            entry.exr = snode.isEXRCompatible();
+            entry.services = snode.serviceList();
+            snodes.push_back(std::move(entry));
+        }
+
+        if (rf == RetFormat::BINARY) {
+            CDataStream ssSnodes(SER_NETWORK, PROTOCOL_VERSION);
+            ssSnodes << snodes;
+            return ssSnodes.str();
+        }
+
+        UniValue ret(UniValue::VARR);
+        for (const auto& snode : snodes) {
+            UniValue obj(UniValue::VOBJ);
+            obj.pushKV("snodekey", HexStr(snode.snodePubKey));
+            obj.pushKV("tier", sn::ServiceNodeMgr::tierString(static_cast<sn::ServiceNode::Tier>(snode.tier)));
+            obj.pushKV("address", EncodeDestination(snode.paymentAddress));
+            obj.pushKV("timelastseen", snode.pingTime);
+            obj.pushKV("exr", snode.exr);
+            UniValue services(UniValue::VARR);
+            for (const auto& service : snode.services)
+                services.push_back(service);
+            obj.pushKV("services", services);
+            ret.push_back(obj);
+        }
+        return ret.write() + "\n";
+    });
+}
+
+static bool rest_proposals(HTTPRequest* req, const std::string& strURIPart)
+{
+    if (!CheckWarmup(req))
+        return false;
+    std::string param;
+    const RetFormat rf = ParseDataFormat(param, strURIPart);
+    if (rf != RetFormat::BINARY && rf != RetFormat::JSON)
+        return RESTERR(req, HTTP_NOT_FOUND, "output format not found (available: bin, json)");
+
+    // Proposal status depends on the chain height and governance is updated
+    // asynchronously from block connection, key on both.
+    uint256 tip;
+    {
+        LOCK(cs_main);
+        if (chainActive.Tip())
+            tip = chainActive.Tip()->GetBlockHash();
+    }
+    const auto version = strprintf("%u-%s", gov::Governance::instance().getVersion(), tip.GetHex().substr(0, 16));
+    const auto etag = RESTETag("proposals", version, rf);
+    return RESTWriteVersioned(req, rf, etag, g_rest_proposals_cache, [rf]() -> std::string {
+        const auto& consensus = Params().GetConsensus();
+        const auto superblock = gov::NextSuperblock(consensus);
+        const auto proposals = gov::Governance::instance().getProposalsSince(gov::PreviousSuperblock(consensus));
+        std::map<int, std::map<gov::Proposal, gov::Tally>> superblockResults;
+
+        std::vector<CRestProposal> entries;
+        for (const auto& proposal : proposals) {
+            if (proposal.getSuperblock() <= superblock && !superblockResults.count(proposal.getSuperblock()))
+                superblockResults[proposal.getSuperblock()] = gov::Governance::instance().getSuperblockResults(proposal.getSuperblock(), consensus);
+            const auto& results = superblockResults[proposal.getSuperblock()];
+            std::string status = "pending";
+            if (proposal.getSuperblock() == superblock)
+                status = results.count(proposal) ? "passing" : "failing";
+            else if (proposal.getSuperblock() < superblock)
+                status = results.count(proposal) ? "passed" : "failed";
+            const auto tally = gov::Governance::getTally(proposal.getHash(), gov::Governance::instance().getVotes(proposal.getHash()), consensus);
+
+            CRestProposal entry;
+            entry.hash = proposal.getHash();
+            entry.name = proposal.getName();
+            entry.superblock = proposal.getSuperblock();
+            entry.amount = proposal.getAmount();
+            entry.address = proposal.getAddress();
+            entry.url = proposal.getUrl();
+            entry.description = proposal.getDescription();
+            entry.yes = tally.yes;
+            entry.no = tally.no;
+            entry.abstain = tally.abstain;
+            entry.status = status;
+            entries.push_back(std::move(entry));
+        }
+
+        if (rf == RetFormat::BINARY) {
+            CDataStream ssProposals(SER_NETWORK, PROTOCOL_VERSION);
+            ssProposals << entries;
+            return ssProposals.str();
+        }
+
+        UniValue ret(UniValue::VARR);
+        for (const auto& entry : entries) {
+            UniValue prop(UniValue::VOBJ);
+            prop.pushKV("hash", entry.hash.ToString());
+            prop.pushKV("name", entry.name);
+            prop.pushKV("superblock", entry.superblock);
+            prop.pushKV("amount", entry.amount / COIN);
+            prop.pushKV("address", entry.address);
+            prop.pushKV("url", entry.url);
+            prop.pushKV("description", entry.description);
+            prop.pushKV("votes_yes", entry.yes);
+            prop.pushKV("votes_no", entry.no);
+            prop.pushKV("votes_abstain", entry.abstain);
+            prop.pushKV("status", entry.status);
+            ret.push_back(prop);
+        }
+        return ret.write() + "\n";
+    });
+}
+
+static bool rest_xbridge_orderbook(HTTPRequest* req, const std::string& strURIPart)
+{
+    if (!CheckWarmup(req))
+        return false;
+    std::string param;
+    const RetFormat rf = ParseDataFormat(param, strURIPart);
+    if (rf != RetFormat::BINARY && rf != RetFormat::JSON)
+        return RESTERR(req, HTTP_NOT_FOUND, "output format not found (available: bin, json)");
+
+    // Read the version before the orders so a concurrent change is never
+    // served under a stale tag.
+    const auto etag = RESTETag("orderbook", std::to_string(xbridge::App::instance().ordersVersion()), rf);
+    return RESTWriteVersioned(req, rf, etag, g_rest_orderbook_cache, [rf]() -> std::string {
+        std::vector<CRestOrder> orders;
+        for (const auto& item : xbridge::App::instance().transactions()) {
+            const auto& tr = item.second;
+            LOCK(tr->_lock);
+            if (tr->state == xbridge::TransactionDescr::trCancelled
+              || tr->state == xbridge::TransactionDescr::trFinished
+              || tr->state == xbridge::TransactionDescr::trExpired)
+                continue;
+            CRestOrder order;
+            order.id = tr->id;
+            order.maker = tr->fromCurrency;
+            order.makerSize = tr->fromAmount;
+            order.taker = tr->toCurrency;
+            order.takerSize = tr->toAmount;
+            order.created = xbridge::timeToInt(tr->created);
+            order.updated = xbridge::timeToInt(tr->txtime);
+            order.status = tr->strState();
+            orders.push_back(std::move(order));
+        }
+
+        if (rf == RetFormat::BINARY) {
+            CDataStream ssOrders(SER_NETWORK, PROTOCOL_VERSION);
+            ssOrders << orders;
+            return ssOrders.str();
+        }
+        UniValue ret(UniValue::VARR);
+        for (const auto& order : orders) {
+            UniValue obj(UniValue::VOBJ);
+            obj.pushKV("id", order.id.GetHex());
+            obj.pushKV("maker", order.maker);
+            obj.pushKV("maker_size", xbridge::xBridgeStringValueFromAmount(order.makerSize));
+            obj.pushKV("taker", order.taker);
+            obj.pushKV("taker_size", xbridge::xBridgeStringValueFromAmount(order.takerSize));
+            obj.pushKV("updated_at", xbridge::iso8601(xbridge::intToTime(order.updated)));
+            obj.pushKV("created_at", xbridge::iso8601(xbridge::intToTime(order.created)));
+            obj.pushKV("status", order.status);
+            ret.push_back(obj);
+        }
+        return ret.write() + "\n";
+    });
+}
+
 static const struct {
     const char* prefix;
     bool (*handler)(HTTPRequest* req, const std::string& strReq);
@@ -634,6 +996,9 @@ static const struct {
       {"/rest/headers/", rest_headers},
       {"/rest/getutxos", rest_getutxos},
       {"/rest/blockhashbyheight/", rest_blockhash_by_height},
+      {"/rest/servicenodes", rest_servicenodes},
+      {"/rest/proposals", rest_proposals},
+      {"/rest/xbridge/orderbook", rest_xbridge_orderbook},
 };
 
 void StartREST()
@@ -896,6 +896,15 @@ static UniValue getblock(const JSONRPCRequest& request)
         throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "Block not found");
     }
 
+    if (verbosity <= 0 && !IsBlockPruned(pblockindex))
+    {
+        // Serve the bytes as stored on disk when they match the requested serialization
+        CRawBlockRef rawBlock;
+        if (ReadRawBlockFromDiskCached(rawBlock, pblockindex, Params().MessageStart())
+            && (!(RPCSerializationFlags() & SERIALIZE_TRANSACTION_NO_WITNESS) || !rawBlock->fHasWitness))
+            return HexStr(rawBlock->data);
+    }
+
     const CBlock block = GetBlockChecked(pblockindex);
 
     if (verbosity <= 0)
@@ -1083,6 +1092,81 @@ static UniValue gettxoutsetinfo(const JSONRPCRequest& request)
     return ret;
 }
 
+static UniValue dumptxoutset(const JSONRPCRequest& request)
+{
+    if (request.fHelp || request.params.size() != 1)
+        throw std::runtime_error(
+            RPCHelpMan{"dumptxoutset",
+                "\nWrite the unspent transaction output set at the current tip to a snapshot file.\n"
+                "Note this call may take some time.\n",
+                {
+                    {"path", RPCArg::Type::STR, RPCArg::Optional::NO, "Path to the output file. If relative, will be prefixed by datadir."},
+                },
+                RPCResult{
+            "{\n"
+            "  \"coins_written\": n,          (numeric) The number of coins written to the snapshot\n"
+            "  \"base_hash\": \"hex\",         (string) The hash of the block the snapshot was taken at\n"
+            "  \"base_height\": n,            (numeric) The height of the block the snapshot was taken at\n"
+            "  \"nchaintx\": n,               (numeric) The number of transactions up to and including the base block\n"
+            "  \"txoutset_hash\": \"hash\",    (string) The hash of the snapshot contents\n"
+            "  \"path\": \"xxxx\"              (string) The absolute path the snapshot was written to\n"
+            "}\n"
+                },
+                RPCExamples{
+                    HelpExampleCli("dumptxoutset", "utxo.dat")
+            + HelpExampleRpc("dumptxoutset", "\"utxo.dat\"")
+                },
+            }.ToString());
+
+    const fs::path path = fs::absolute(request.params[0].get_str(), GetDataDir());
+    // Write to a temporary path and then move into place, so a partial file is
+    // never mistaken for a complete snapshot.
+    const fs::path temppath = fs::absolute(request.params[0].get_str() + ".incomplete", GetDataDir());
+    if (fs::exists(path))
+        throw JSONRPCError(RPC_INVALID_PARAMETER, path.string() + " already exists. If you are sure this is what you want, move it out of the way first");
+
+    FILE* file{fsbridge::fopen(temppath, "wb")};
+    CAutoFile afile{file, SER_DISK, CLIENT_VERSION};
+    if (afile.IsNull())
+        throw JSONRPCError(RPC_INVALID_PARAMETER, "Unable to open " + temppath.string() + " for writing");
+
+    std::unique_ptr<CCoinsViewCursor> pcursor;
+    CUTXOSnapshotMetadata metadata;
+    const CBlockIndex* tip;
+    {
+        // Both cursors are taken under cs_main after a flush, so they see the
+        // same coins. Counting is cheap next to writing, which is done unlocked.
+        LOCK(cs_main);
+        FlushStateToDisk();
+        std::unique_ptr<CCoinsViewCursor> pcounter(pcoinsdbview->Cursor());
+        pcursor.reset(pcoinsdbview->Cursor());
+        tip = LookupBlockIndex(pcursor->GetBestBlock());
+        if (!tip)
+            throw JSONRPCError(RPC_INTERNAL_ERROR, "Unable to find the coins database best block");
+        metadata.base_blockhash = tip->GetBlockHash();
+        for (; pcounter->Valid(); pcounter->Next())
+            ++metadata.coins_count;
+    }
+
+    uint256 hash;
+    if (!WriteUTXOSnapshot(afile, *pcursor, metadata, hash)) {
+        afile.fclose();
+        fs::remove(temppath);
+        throw JSONRPCError(RPC_INTERNAL_ERROR, "Unable to write UTXO snapshot");
+    }
+    afile.fclose();
+    fs::rename(temppath, path);
+
+    UniValue result(UniValue::VOBJ);
+    result.pushKV("coins_written", metadata.coins_count);
+    result.pushKV("base_hash", tip->GetBlockHash().ToString());
+    result.pushKV("base_height", tip->nHeight);
+    result.pushKV("nchaintx", (int64_t)tip->nChainTx);
+    result.pushKV("txoutset_hash", hash.ToString());
+    result.pushKV("path", path.string());
+    return result;
+}
+
 UniValue gettxout(const JSONRPCRequest& request)
 {
     if (request.fHelp || request.params.size() < 2 || request.params.size() > 3)
@@ -2299,22 +2383,23 @@ static const CRPCCommand commands[] =
 { //  category              name                      actor (function)         argNames
   //  --------------------- ------------------------  -----------------------  ----------
     { "blockchain",         "getblockchaininfo",      &getblockchaininfo,      {} },
-    { "blockchain",         "getchaintxstats",        &getchaintxstats,        {"nblocks", "blockhash"} },
-    { "blockchain",         "getblockstats",          &getblockstats,          {"hash_or_height", "stats"} },
-    { "blockchain",         "getbestblockhash",       &getbestblockhash,       {} },
-    { "blockchain",         "getblockcount",          &getblockcount,          {} },
-    { "blockchain",         "getblock",               &getblock,               {"blockhash","verbosity|verbose"} },
-    { "blockchain",         "getblockhash",           &getblockhash,           {"height"} },
-    { "blockchain",         "getblockheader",         &getblockheader,         {"blockhash","verbose"} },
+    { "blockchain",         "getchaintxstats",        &getchaintxstats,        {"nblocks", "blockhash"}, true },
+    { "blockchain",         "getblockstats",          &getblockstats,          {"hash_or_height", "stats"}, true },
+    { "blockchain",         "getbestblockhash",       &getbestblockhash,       {}, true },
+    { "blockchain",         "getblockcount",          &getblockcount,          {}, true },
+    { "blockchain",         "getblock",               &getblock,               {"blockhash","verbosity|verbose"}, true },
+    { "blockchain",         "getblockhash",           &getblockhash,           {"height"}, true },
+    { "blockchain",         "getblockheader",         &getblockheader,         {"blockhash","verbose"}, true },
     { "blockchain",         "getchaintips",           &getchaintips,           {} },
-    { "blockchain",         "getdifficulty",          &getdifficulty,          {} },
-    { "blockchain",         "getmempoolancestors",    &getmempoolancestors,    {"txid","verbose"} },
-    { "blockchain",         "getmempooldescendants",  &getmempooldescendants,  {"txid","verbose"} },
-    { "blockchain",         "getmempoolentry",        &getmempoolentry,        {"txid"} },
+    { "blockchain",         "getdifficulty",          &getdifficulty,          {}, true },
+    { "blockchain",         "getmempoolancestors",    &getmempoolancestors,    {"txid","verbose"}, true },
+    { "blockchain",         "getmempooldescendants",  &getmempooldescendants,  {"txid","verbose"}, true },
+    { "blockchain",         "getmempoolentry",        &getmempoolentry,        {"txid"}, true },
     { "blockchain",         "getmempoolinfo",         &getmempoolinfo,         {} },
-    { "blockchain",         "getrawmempool",          &getrawmempool,          {"verbose"} },
-    { "blockchain",         "gettxout",               &gettxout,               {"txid","n","include_mempool"} },
+    { "blockchain",         "getrawmempool",          &getrawmempool,          {"verbose"}, true },
+    { "blockchain",         "gettxout",               &gettxout,               {"txid","n","include_mempool"}, true },
     { "blockchain",         "gettxoutsetinfo",        &gettxoutsetinfo,        {} },
+    { "blockchain",         "dumptxoutset",           &dumptxoutset,           {"path"} },
     { "blockchain",         "pruneblockchain",        &pruneblockchain,        {"height"} },
     { "blockchain",         "savemempool",            &savemempool,            {} },
     { "blockchain",         "verifychain",            &verifychain,            {"checklevel","nblocks"} },
@@ -150,6 +150,11 @@ static const CRPCConvertParam vRPCConvertParams[] =
     { "disconnectnode", 1, "nodeid" },
     { "splitbalance", 0, "amount" },
     { "splitbalance", 2, "hex_only" },
+    { "planstakesplit", 1, "submit" },
+    { "planstakesplit", 2, "max_idle_percent" },
+    { "getlockcontention", 0, "count" },
+    { "getlockcontention", 1, "sites" },
+    { "getlockcontention", 2, "reset" },
     // Echo with conversion (For testing only)
     { "echojson", 0, "arg0" },
     { "echojson", 1, "arg1" },
@@ -321,7 +321,7 @@ static const CRPCCommand commands[] =
 { //  category              name                      actor (function)         argNames
   //  --------------------- ------------------------  -----------------------  ----------
     { "governance",         "createproposal",         &createproposal,         {"name", "superblock", "amount", "address", "url", "description"} },
-    { "governance",         "listproposals",          &listproposals,          {"sinceblock"} },
+    { "governance",         "listproposals",          &listproposals,          {"sinceblock"}, true },
     { "governance",         "vote",                   &vote,                   {"proposal", "vote", "address"} },
     { "governance",         "proposalfee",            &proposalfee,            {} },
     { "governance",         "nextsuperblock",         &nextsuperblock,         {} },
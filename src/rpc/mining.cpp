@@ -757,7 +757,7 @@ static UniValue submitblock(const JSONRPCRequest& request)
 
     bool new_block;
     submitblock_StateCatcher sc(block.GetHash());
-    RegisterValidationInterface(&sc);
+    RegisterValidationInterface(&sc, "submitblock");
     bool accepted = ProcessNewBlock(Params(), blockptr, /* fForceProcessing */ true, /* fNewBlock */ &new_block);
     UnregisterValidationInterface(&sc);
     if (!new_block && accepted) {
@@ -995,6 +995,22 @@ static UniValue getstakingstatus(const JSONRPCRequest& request)
                     "  \"fullyunlocked\": n,        (boolean) Wallet fully unlocked\n"
                     "  \"unlockedforstaking\": n,   (boolean) Wallet unlocked for staking only\n"
                     "  \"status\": \"xxx\",         (string) Status message\n"
+                    "  \"stats\": {                (json object) Staker telemetry, values are from the last stake search unless noted\n"
+                    "    \"eligibleinputs\": n,       (numeric) Number of inputs that meet the staking criteria\n"
+                    "    \"stakeableamount\": x.xxx,  (numeric) Total amount of the eligible inputs\n"
+                    "    \"lockedwallets\": n,        (numeric) Number of wallets skipped because they are locked\n"
+                    "    \"kernelhashes\": n,         (numeric) Number of kernel hashes evaluated\n"
+                    "    \"hashespersecond\": n,      (numeric) Kernel hash rate of the stake search\n"
+                    "    \"selectms\": n,             (numeric) Milliseconds spent selecting inputs from the wallets\n"
+                    "    \"lockwaitms\": n,           (numeric) Milliseconds of selectms spent waiting on wallet and chain locks\n"
+                    "    \"searchms\": n,             (numeric) Milliseconds spent searching for stakes\n"
+                    "    \"expectedtime\": n,         (numeric) Expected seconds until the next stake at the current difficulty, 0 if unknown\n"
+                    "    \"totalkernelhashes\": n,    (numeric) Kernel hashes evaluated since the staker started\n"
+                    "    \"stakesfound\": n,          (numeric) Stakes submitted since the staker started\n"
+                    "    \"missedstale\": n,          (numeric) Stakes that lost the race to a new chain tip since the staker started\n"
+                    "    \"missedwalletlocked\": n,   (numeric) Stakes missed because the wallet was locked since the staker started\n"
+                    "    \"missedfailed\": n,         (numeric) Stakes that couldn't be submitted since the staker started\n"
+                    "  }\n"
                     "}\n"
                 },
                 RPCExamples{
@@ -1017,14 +1033,20 @@ static UniValue getstakingstatus(const JSONRPCRequest& request)
     const auto lastUpdatedTime = g_staker ? g_staker->LastUpdateTime() : 0;
     const auto lastUpdatedStr = xbridge::iso8601(boost::posix_time::from_time_t(lastUpdatedTime));
     const auto lastBlock = g_staker ? g_staker->LastBlockHeight() : 0;
+    const auto stats = g_staker ? g_staker->GetStats() : StakeMgr::StakeStats{};
 
+    // Use the staker's stakeable amount once it has searched for stakes, this
+    // avoids computing the balance of every wallet under cs_wallet per call.
     CAmount balance{0};
     bool allLocked{true};
     for (const auto & pwallet : GetWallets()) {
         if (!pwallet->IsLocked())
             allLocked = false;
-        balance += pwallet->GetBalance();
+        if (lastBlock == 0)
+            balance += pwallet->GetBalance();
     }
+    if (lastBlock > 0)
+        balance = stats.stakeableAmount;
 
     const auto staking = stakingEnabled && !allLocked && balance > 0 && connected && !IsInitialBlockDownload();
 
@@ -1050,6 +1072,23 @@ static UniValue getstakingstatus(const JSONRPCRequest& request)
     obj.pushKV("unlockedforstaking", util::unlockedForStakingOnly);
     obj.pushKV("hasoutgoingpeers", connected);
     obj.pushKV("status", msg);
+
+    UniValue statsObj(UniValue::VOBJ);
+    statsObj.pushKV("eligibleinputs", stats.eligibleInputs);
+    statsObj.pushKV("stakeableamount", ValueFromAmount(stats.stakeableAmount));
+    statsObj.pushKV("lockedwallets", stats.lockedWallets);
+    statsObj.pushKV("kernelhashes", (uint64_t)stats.kernelHashes);
+    statsObj.pushKV("hashespersecond", stats.searchMicros > 0 ? (uint64_t)(stats.kernelHashes * 1000000 / stats.searchMicros) : 0);
+    statsObj.pushKV("selectms", stats.selectMicros / 1000);
+    statsObj.pushKV("lockwaitms", stats.lockWaitMicros / 1000);
+    statsObj.pushKV("searchms", stats.searchMicros / 1000);
+    statsObj.pushKV("expectedtime", (int64_t)stats.expectedStakeTime);
+    statsObj.pushKV("totalkernelhashes", (uint64_t)stats.totalKernelHashes);
+    statsObj.pushKV("stakesfound", (uint64_t)stats.stakesFound);
+    statsObj.pushKV("missedstale", (uint64_t)stats.missedStale);
+    statsObj.pushKV("missedwalletlocked", (uint64_t)stats.missedWalletLocked);
+    statsObj.pushKV("missedfailed", (uint64_t)stats.missedFailed);
+    obj.pushKV("stats", statsObj);
     return obj;
 #else
     obj.pushKV("staking", false);
@@ -20,6 +20,7 @@
 #include <timedata.h>
 #include <util/system.h>
 #include <util/strencodings.h>
+#include <validationinterface.h>
 #include <warnings.h>
 
 #include <stdint.h>
@@ -574,6 +575,132 @@ UniValue logging(const JSONRPCRequest& request)
     return result;
 }
 
+static UniValue getvalidationqueueinfo(const JSONRPCRequest& request)
+{
+    if (request.fHelp || request.params.size() > 0)
+        throw std::runtime_error(
+            RPCHelpMan{"getvalidationqueueinfo",
+                "\nReturns the block and transaction notification queue of each subscribed subsystem.\n",
+                {},
+                RPCResult{
+            "[\n"
+            "  {\n"
+            "    \"name\": \"xxxx\",          (string) Name of the subscriber\n"
+            "    \"pending\": n,              (numeric) Number of notifications waiting to be processed\n"
+            "    \"processed\": n,            (numeric) Number of notifications processed\n"
+            "    \"avglatency\": n,           (numeric) Average time in microseconds from notification to completion\n"
+            "    \"maxlatency\": n,           (numeric) Maximum time in microseconds from notification to completion\n"
+            "    \"avgruntime\": n,           (numeric) Average time in microseconds spent processing a notification\n"
+            "  }\n"
+            "  ,...\n"
+            "]\n"
+                },
+                RPCExamples{
+                    HelpExampleCli("getvalidationqueueinfo", "")
+            + HelpExampleRpc("getvalidationqueueinfo", "")
+                },
+            }.ToString());
+
+    UniValue result(UniValue::VARR);
+    for (const auto & stats : GetMainSignals().GetQueueStats()) {
+        UniValue obj(UniValue::VOBJ);
+        obj.pushKV("name", stats.name);
+        obj.pushKV("pending", (uint64_t)stats.pending);
+        obj.pushKV("processed", stats.processed);
+        obj.pushKV("avglatency", stats.processed > 0 ? stats.totalLatency / (int64_t)stats.processed : 0);
+        obj.pushKV("maxlatency", stats.maxLatency);
+        obj.pushKV("avgruntime", stats.processed > 0 ? stats.totalRunTime / (int64_t)stats.processed : 0);
+        result.push_back(obj);
+    }
+    return result;
+}
+
+static UniValue getlockcontention(const JSONRPCRequest& request)
+{
+    if (request.fHelp || request.params.size() > 3)
+        throw std::runtime_error(
+            RPCHelpMan{"getlockcontention",
+                "\nReturns the mutexes with the most time spent waiting on them, along with the call sites that waited the longest. "
+                "Times are in microseconds. Profiling is enabled with -lockprofile.\n",
+                {
+                    {"count", RPCArg::Type::NUM, RPCArg::Optional::OMITTED, "20", "Number of mutexes to return"},
+                    {"sites", RPCArg::Type::NUM, RPCArg::Optional::OMITTED, "5", "Number of call sites to return per mutex"},
+                    {"reset", RPCArg::Type::BOOL, RPCArg::Optional::OMITTED, "false", "Clear the counters after returning them"},
+                },
+                RPCResult{
+            "{\n"
+            "  \"enabled\": true|false,     (boolean) Whether lock profiling is enabled\n"
+            "  \"locks\": [\n"
+            "    {\n"
+            "      \"name\": \"xxxx\",          (string) Name of the mutex as used at the call site\n"
+            "      \"acquisitions\": n,         (numeric) Number of times the mutex was locked\n"
+            "      \"contentions\": n,          (numeric) Number of times the mutex was already held\n"
+            "      \"wait\": n,                 (numeric) Total time spent waiting on the mutex\n"
+            "      \"maxwait\": n,              (numeric) Longest single wait\n"
+            "      \"hold\": n,                 (numeric) Total time the mutex was held\n"
+            "      \"sites\": [                 (array) Call sites ordered by wait time\n"
+            "        {\n"
+            "          \"location\": \"file:line\", (string) Source location of the lock\n"
+            "          \"acquisitions\": n,\n"
+            "          \"contentions\": n,\n"
+            "          \"wait\": n,\n"
+            "          \"maxwait\": n,\n"
+            "          \"hold\": n\n"
+            "        }\n"
+            "        ,...\n"
+            "      ]\n"
+            "    }\n"
+            "    ,...\n"
+            "  ]\n"
+            "}\n"
+                },
+                RPCExamples{
+                    HelpExampleCli("getlockcontention", "")
+            + HelpExampleCli("getlockcontention", "10 3 true")
+            + HelpExampleRpc("getlockcontention", "10, 3, true")
+                },
+            }.ToString());
+
+    const int count = request.params[0].isNull() ? 20 : request.params[0].get_int();
+    const int sites = request.params[1].isNull() ? 5 : request.params[1].get_int();
+    const bool reset = request.params[2].isNull() ? false : request.params[2].get_bool();
+    if (count < 0 || sites < 0)
+        throw JSONRPCError(RPC_INVALID_PARAMETER, "count and sites must not be negative");
+
+    UniValue locks(UniValue::VARR);
+    for (const auto & stats : GetLockContention(sites)) {
+        if (locks.size() >= static_cast<size_t>(count))
+            break;
+        UniValue obj(UniValue::VOBJ);
+        obj.pushKV("name", stats.name);
+        obj.pushKV("acquisitions", stats.acquisitions);
+        obj.pushKV("contentions", stats.contentions);
+        obj.pushKV("wait", stats.waitNanos / 1000);
+        obj.pushKV("maxwait", stats.maxWaitNanos / 1000);
+        obj.pushKV("hold", stats.holdNanos / 1000);
+        UniValue siteArr(UniValue::VARR);
+        for (const auto & site : stats.sites) {
+            UniValue siteObj(UniValue::VOBJ);
+            siteObj.pushKV("location", site.location);
+            siteObj.pushKV("acquisitions", site.acquisitions);
+            siteObj.pushKV("contentions", site.contentions);
+            siteObj.pushKV("wait", site.waitNanos / 1000);
+            siteObj.pushKV("maxwait", site.maxWaitNanos / 1000);
+            siteObj.pushKV("hold", site.holdNanos / 1000);
+            siteArr.push_back(siteObj);
+        }
+        obj.pushKV("sites", siteArr);
+        locks.push_back(obj);
+    }
+    if (reset)
+        ResetLockContention();
+
+    UniValue result(UniValue::VOBJ);
+    result.pushKV("enabled", g_lock_profile.load());
+    result.pushKV("locks", locks);
+    return result;
+}
+
 static UniValue echo(const JSONRPCRequest& request)
 {
     if (request.fHelp)
@@ -597,11 +724,13 @@ static const CRPCCommand commands[] =
   //  --------------------- ------------------------  -----------------------  ----------
     { "control",            "getmemoryinfo",          &getmemoryinfo,          {"mode"} },
     { "control",            "logging",                &logging,                {"include", "exclude"}},
-    { "util",               "validateaddress",        &validateaddress,        {"address"} },
+    { "control",            "getvalidationqueueinfo", &getvalidationqueueinfo, {} },
+    { "control",            "getlockcontention",      &getlockcontention,      {"count", "sites", "reset"} },
+    { "util",               "validateaddress",        &validateaddress,        {"address"}, true },
     { "util",               "createmultisig",         &createmultisig,         {"nrequired","keys","address_type"} },
     { "util",               "deriveaddresses",        &deriveaddresses,        {"descriptor", "range"} },
     { "util",               "getdescriptorinfo",      &getdescriptorinfo,      {"descriptor"} },
-    { "util",               "verifymessage",          &verifymessage,          {"address","signature","message"} },
+    { "util",               "verifymessage",          &verifymessage,          {"address","signature","message"}, true },
     { "util",               "signmessagewithprivkey", &signmessagewithprivkey, {"privkey","message"} },
 
     /* Not shown in help */
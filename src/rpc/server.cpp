@@ -20,7 +20,10 @@
 #include <boost/algorithm/string/split.hpp>
 #include <boost/algorithm/string/case_conv.hpp>
 
+#include <atomic>
+#include <condition_variable>
 #include <memory> // for unique_ptr
+#include <set>
 #include <unordered_map>
 
 static CCriticalSection cs_rpcWarmup;
@@ -493,11 +496,87 @@ static UniValue JSONRPCExecOne(JSONRPCRequest jreq, const UniValue& req)
     return rpc_result;
 }
 
-std::string JSONRPCExecBatch(const JSONRPCRequest& jreq, const UniValue& vReq)
+static bool IsConcurrentBatchRequest(const UniValue& req)
 {
+    if (!req.isObject())
+        return false;
+    const UniValue& method = find_value(req.get_obj(), "method");
+    if (!method.isStr())
+        return false;
+    const CRPCCommand* pcmd = tableRPC[method.get_str()];
+    return pcmd && pcmd->concurrentBatch;
+}
+
+/** Shared state of the batch elements being evaluated concurrently */
+struct JSONRPCBatchRun {
+    const JSONRPCRequest* jreq;
+    const UniValue* vReq;
+    std::vector<UniValue>* results;
+    unsigned int end;
+    std::atomic<unsigned int> next;
+    std::atomic<unsigned int> remaining;
+    Mutex mutex;
+    std::condition_variable cond;
+
+    /** Evaluates batch elements until none are left */
+    void Work() {
+        unsigned int idx;
+        while ((idx = next++) < end) {
+            (*results)[idx] = JSONRPCExecOne(*jreq, (*vReq)[idx]);
+            if (--remaining == 0) {
+                WAIT_LOCK(mutex, lock);
+                cond.notify_all();
+            }
+        }
+    }
+};
+
+static void JSONRPCExecConcurrent(const JSONRPCRequest& jreq, const UniValue& vReq, unsigned int begin,
+                                  unsigned int end, std::vector<UniValue>& results, int concurrency,
+                                  const RPCWorkDispatcher& dispatch)
+{
+    auto run = std::make_shared<JSONRPCBatchRun>();
+    run->jreq = &jreq;
+    run->vReq = &vReq;
+    run->results = &results;
+    run->end = end;
+    run->next = begin;
+    run->remaining = end - begin;
+
+    // Helpers only touch the request once they've claimed an element, this
+    // thread waits for all claimed elements so the request outlives them.
+    const int helpers = std::min<int>(concurrency, end - begin) - 1;
+    for (int i = 0; i < helpers; ++i) {
+        if (!dispatch([run]() { run->Work(); }))
+            break; // the work queue is full, evaluate the remainder here
+    }
+    run->Work();
+
+    WAIT_LOCK(run->mutex, lock);
+    run->cond.wait(lock, [&run]() { return run->remaining == 0; });
+}
+
+std::string JSONRPCExecBatch(const JSONRPCRequest& jreq, const UniValue& vReq, const RPCWorkDispatcher& dispatch)
+{
+    const int concurrency = dispatch ? gArgs.GetArg("-rpcbatchconcurrency", DEFAULT_RPC_BATCH_CONCURRENCY) : 1;
+    std::vector<UniValue> results(vReq.size());
+    unsigned int reqIdx = 0;
+    while (reqIdx < vReq.size()) {
+        // Find the run of consecutive elements that may be evaluated concurrently
+        unsigned int end = reqIdx;
+        while (concurrency > 1 && end < vReq.size() && IsConcurrentBatchRequest(vReq[end]))
+            ++end;
+        if (end - reqIdx > 1) {
+            JSONRPCExecConcurrent(jreq, vReq, reqIdx, end, results, concurrency, dispatch);
+            reqIdx = end;
+        } else {
+            results[reqIdx] = JSONRPCExecOne(jreq, vReq[reqIdx]);
+            ++reqIdx;
+        }
+    }
+
     UniValue ret(UniValue::VARR);
-    for (unsigned int reqIdx = 0; reqIdx < vReq.size(); reqIdx++)
-        ret.push_back(JSONRPCExecOne(jreq, vReq[reqIdx]));
+    ret.push_backV(results);
 
     return ret.write() + "\n";
 }
@@ -10,6 +10,7 @@
 #include <rpc/protocol.h>
 #include <uint256.h>
 
+#include <functional>
 #include <list>
 #include <map>
 #include <stdint.h>
@@ -18,6 +19,8 @@
 #include <univalue.h>
 
 static const unsigned int DEFAULT_RPC_SERIALIZE_VERSION = 1;
+/** Default number of batch elements evaluated concurrently per JSON-RPC batch request */
+static const int DEFAULT_RPC_BATCH_CONCURRENCY = 4;
 
 class CRPCCommand;
 
@@ -131,10 +134,15 @@ typedef UniValue(*rpcfn_type)(const JSONRPCRequest& jsonRequest);
 class CRPCCommand
 {
 public:
+    CRPCCommand(std::string category, std::string name, rpcfn_type actor, std::vector<std::string> argNames, bool concurrentBatch = false)
+        : category(std::move(category)), name(std::move(name)), actor(actor), argNames(std::move(argNames)), concurrentBatch(concurrentBatch) {}
+
     std::string category;
     std::string name;
     rpcfn_type actor;
     std::vector<std::string> argNames;
+    /** Read-only and thread-safe, calls may be evaluated concurrently within a batch request */
+    bool concurrentBatch;
 };
 
 /**
@@ -201,7 +209,14 @@ extern std::string HelpExampleRpc(const std::string& methodname, const std::stri
 void StartRPC();
 void InterruptRPC();
 void StopRPC();
-std::string JSONRPCExecBatch(const JSONRPCRequest& jreq, const UniValue& vReq);
+/** Queues a function to run on another thread, returns false if it couldn't be queued */
+typedef std::function<bool(std::function<void()>)> RPCWorkDispatcher;
+/**
+ * Execute a JSON-RPC batch request. Consecutive calls to commands marked
+ * concurrentBatch are evaluated concurrently (up to -rpcbatchconcurrency at a time) when a
+ * dispatcher is given, the reply preserves the order of the request.
+ */
+std::string JSONRPCExecBatch(const JSONRPCRequest& jreq, const UniValue& vReq, const RPCWorkDispatcher& dispatch = nullptr);
 
 // Retrieves any serialization flags requested in command line argument
 int RPCSerializationFlags();
@@ -910,10 +910,10 @@ static const CRPCCommand commands[] =
     { "servicenode",        "servicenodeexport",       &servicenodeexport,       {"alias", "password"} },
     { "servicenode",        "servicenodeimport",       &servicenodeimport,       {"alias", "password"} },
     { "servicenode",        "servicenodestatus",       &servicenodestatus,       {} },
-    { "servicenode",        "servicenodelist",         &servicenodelist,         {} },
+    { "servicenode",        "servicenodelist",         &servicenodelist,         {}, true },
     { "servicenode",        "servicenodesendping",     &servicenodesendping,     {} },
     { "servicenode",        "servicenoderemove",       &servicenoderemove,       {"alias"} },
-    { "servicenode",        "servicenodecount",        &servicenodecount,        {} },
+    { "servicenode",        "servicenodecount",        &servicenodecount,        {}, true },
     { "servicenode",        "servicenode",             &servicenodelegacy,       {"command"} },
 };
 // clang-format on
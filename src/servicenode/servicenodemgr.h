@@ -21,13 +21,18 @@
 #include <wallet/wallet.h>
 #endif // ENABLE_WALLET
 
+#include <algorithm>
+#include <atomic>
 #include <iostream>
 #include <numeric>
 #include <set>
+#include <unordered_map>
 #include <utility>
+#include <vector>
 
 #include <boost/algorithm/string.hpp>
 #include <boost/filesystem.hpp>
+#include <boost/signals2/signal.hpp>
 
 /**
  * Servicenode namepsace
@@ -78,6 +83,13 @@ class ServiceNodeMgr : public CValidationInterface {
 public:
     ServiceNodeMgr() = default;
 
+    /** Notifies listeners of an accepted servicenode registration. */
+    boost::signals2::signal<void (const ServiceNode & snode)> NotifyServiceNodeRegistered;
+    /** Notifies listeners of an accepted servicenode ping. */
+    boost::signals2::signal<void (const ServiceNodePing & ping)> NotifyServiceNodePing;
+    /** Notifies listeners of a servicenode becoming valid or invalid. */
+    boost::signals2::signal<void (const ServiceNode & snode)> NotifyServiceNodeStateChanged;
+
     /**
      * Singleton instance.
      * @return
@@ -93,7 +105,13 @@ public:
     void reset() {
         LOCK(mu);
         snodes.clear();
+        serviceIds.clear();
+        serviceNames.clear();
+        serviceSnodes.clear();
+        freeServiceIds.clear();
+        snodeServices.clear();
         pings.clear();
+        ++version;
         seenPackets.clear();
         snodeEntries.clear();
         seenBlocks.clear();
@@ -140,6 +158,7 @@ public:
             return false;
 
         snode = *snptr;
+        NotifyServiceNodeRegistered(snode);
         return true;
     }
 
@@ -190,6 +209,7 @@ public:
             return false;
 
         addSn(ping.getSnode(), false); // skip validity check here because it's checked in the ping's
+        NotifyServiceNodePing(ping);
         return true;
     }
 
@@ -386,6 +406,15 @@ public:
         return true;
     }
 
+    /**
+     * Returns the version of the servicenode list, which changes whenever
+     * servicenodes or their pings change.
+     * @return
+     */
+    uint64_t getVersion() const {
+        return version;
+    }
+
     /**
      * Returns a copy of the most recent servicenode list.
      * @return
@@ -398,6 +427,71 @@ public:
         return l;
     }
 
+    /**
+     * Returns a copy of the servicenodes that support all of the specified services.
+     * Uses the service index instead of checking every snode's service list.
+     * @param services
+     * @return
+     */
+    std::vector<ServiceNode> listWithServices(const std::set<std::string> & services) {
+        if (services.empty())
+            return list();
+        LOCK(mu);
+        std::vector<const std::set<CPubKey>*> sets; sets.reserve(services.size());
+        for (const auto & service : services) {
+            auto it = serviceIds.find(service);
+            if (it == serviceIds.end() || serviceSnodes[it->second].empty())
+                return {}; // no snode has this service
+            sets.push_back(&serviceSnodes[it->second]);
+        }
+        // Walk the smallest set and check membership in the others
+        std::sort(sets.begin(), sets.end(), [](const std::set<CPubKey> *a, const std::set<CPubKey> *b) {
+            return a->size() < b->size();
+        });
+        std::vector<ServiceNode> l;
+        for (const auto & snodePubKey : *sets.front()) {
+            bool all{true};
+            for (int i = 1; i < static_cast<int>(sets.size()) && all; ++i)
+                all = sets[i]->count(snodePubKey) > 0;
+            if (!all)
+                continue;
+            auto it = snodes.find(snodePubKey);
+            if (it != snodes.end())
+                l.push_back(*it->second);
+        }
+        return l;
+    }
+
+    /**
+     * Returns a copy of the servicenodes that support the specified service.
+     * @param service
+     * @return
+     */
+    std::vector<ServiceNode> listWithService(const std::string & service) {
+        return listWithServices({service});
+    }
+
+    /**
+     * Returns true if the servicenode with the specified pubkey supports the service.
+     * @param snodePubKey
+     * @param service
+     * @return
+     */
+    bool hasService(const CPubKey & snodePubKey, const std::string & service) {
+        LOCK(mu);
+        auto it = serviceIds.find(service);
+        return it != serviceIds.end() && serviceSnodes[it->second].count(snodePubKey) > 0;
+    }
+
+    /**
+     * Returns the number of services supported by at least one servicenode.
+     * @return
+     */
+    size_t serviceCount() {
+        LOCK(mu);
+        return serviceIds.size();
+    }
+
     /**
      * Returns the servicenode ping with the specified snode pubkey.
      * @param snodePubKey
@@ -515,9 +609,12 @@ public:
      */
     void removeSnEntries() {
         LOCK(mu);
-        for (const auto & entry : snodeEntries)
+        for (const auto & entry : snodeEntries) {
             snodes.erase(entry.key.GetPubKey());
+            unindexSn(entry.key.GetPubKey());
+        }
         snodeEntries.clear();
+        ++version;
     }
 
     /**
@@ -846,6 +943,7 @@ protected:
         // only add if this ping is newer than last known ping
         if (!pings.count(pubkey) || pings[pubkey].getPingTime() < ping.getPingTime()) {
             pings[pubkey] = ping;
+            ++version;
             return true;
         }
         return false;
@@ -866,6 +964,8 @@ protected:
         {
             LOCK(mu);
             snodes[ptr->getSnodePubKey()] = ptr;
+            indexSn(ptr);
+            ++version;
         }
         return ptr;
     }
@@ -901,6 +1001,8 @@ protected:
             return false;
         LOCK(mu);
         snodes.erase(snodePubKey);
+        unindexSn(snodePubKey);
+        ++version;
         return true;
     }
 
@@ -958,8 +1060,11 @@ protected:
             }
         }
         for (const auto & utxo : snode.getCollateral()) {
-            if (utxos.count(utxo) && snodes.count(utxos[utxo]->getSnodePubKey()))
+            if (utxos.count(utxo) && snodes.count(utxos[utxo]->getSnodePubKey())) {
                 snodes.erase(utxos[utxo]->getSnodePubKey());
+                unindexSn(utxos[utxo]->getSnodePubKey());
+                ++version;
+            }
         }
     }
 
@@ -1225,10 +1330,12 @@ protected:
         }
 
         // Check that existing snodes are valid
+        std::vector<ServiceNodePtr> changed;
         {
             LOCK(mu);
             for (auto & item : snodes) {
                 auto snode = item.second;
+                const bool wasInvalid = snode->getInvalid();
                 for (const auto & collateral : snode->getCollateral()) {
                     if (spent.count(collateral)) {
                         snode->markInvalid(true, blockNumber);
@@ -1240,17 +1347,90 @@ protected:
                     snode->markInvalid(false); // reset state before is valid check
                     snode->markInvalid(!snode->isValid(GetTxFunc, IsServiceNodeBlockValidFunc));
                 }
+                if (snode->getInvalid() != wasInvalid)
+                    changed.push_back(snode);
             }
         }
+        if (!changed.empty())
+            ++version;
+        for (const auto & snode : changed)
+            NotifyServiceNodeStateChanged(*snode);
+    }
+
+protected:
+    /**
+     * Returns the id of the service name, assigning a free or the next id to names
+     * not seen before. Requires mu.
+     * @param service
+     * @return
+     */
+    uint32_t serviceId(const std::string & service) {
+        auto it = serviceIds.find(service);
+        if (it != serviceIds.end())
+            return it->second;
+        uint32_t id;
+        if (!freeServiceIds.empty()) {
+            id = freeServiceIds.back();
+            freeServiceIds.pop_back();
+            serviceNames[id] = service;
+        } else {
+            id = static_cast<uint32_t>(serviceSnodes.size());
+            serviceNames.push_back(service);
+            serviceSnodes.emplace_back();
+        }
+        serviceIds[service] = id;
+        return id;
+    }
+
+    /**
+     * Replaces the indexed services of the snode with its current service list. Called
+     * whenever the snode is registered or pinged. Requires mu.
+     * @param snode
+     */
+    void indexSn(const ServiceNodePtr & snode) {
+        const auto & snodePubKey = snode->getSnodePubKey();
+        unindexSn(snodePubKey);
+        auto & ids = snodeServices[snodePubKey];
+        for (const auto & service : snode->serviceList()) {
+            const auto id = serviceId(service);
+            if (serviceSnodes[id].insert(snodePubKey).second)
+                ids.push_back(id);
+        }
+    }
+
+    /**
+     * Removes the snode from the service index. The ids of services no snode
+     * supports anymore are freed. Requires mu.
+     * @param snodePubKey
+     */
+    void unindexSn(const CPubKey & snodePubKey) {
+        auto it = snodeServices.find(snodePubKey);
+        if (it == snodeServices.end())
+            return;
+        for (const auto & id : it->second) {
+            serviceSnodes[id].erase(snodePubKey);
+            if (!serviceSnodes[id].empty())
+                continue;
+            serviceIds.erase(serviceNames[id]);
+            std::string().swap(serviceNames[id]);
+            freeServiceIds.push_back(id);
+        }
+        snodeServices.erase(it);
     }
 
 protected:
     Mutex mu;
     std::map<CPubKey, ServiceNodePtr> snodes;
+    std::unordered_map<std::string, uint32_t> serviceIds; // interned service names
+    std::vector<std::string> serviceNames; // service names by service id
+    std::vector<std::set<CPubKey>> serviceSnodes; // snodes by service id
+    std::vector<uint32_t> freeServiceIds; // ids of services no snode supports
+    std::unordered_map<CPubKey, std::vector<uint32_t>, Hasher> snodeServices; // service ids by snode
     std::unordered_map<CPubKey, ServiceNodePing, Hasher> pings;
     std::set<uint256> seenPackets;
     std::set<ServiceNodeConfigEntry> snodeEntries;
     std::vector<int> seenBlocks;
+    std::atomic<uint64_t> version{0};
 };
 
 }
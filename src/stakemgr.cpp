@@ -5,6 +5,7 @@
 
 #include <stakemgr.h>
 
+#include <checkqueue.h>
 #include <governance/governance.h>
 #include <kernel.h>
 #include <miner.h>
@@ -15,6 +16,31 @@
 
 std::unique_ptr<StakeMgr> g_staker;
 
+/** Searches a single wallet for stakes, see StakeMgr::Update */
+class CStakeSearchCheck {
+public:
+    CStakeSearchCheck() = default;
+    explicit CStakeSearchCheck(std::function<void()> search) : search(std::move(search)) {}
+    bool operator()() {
+        if (search)
+            search();
+        return true;
+    }
+    void swap(CStakeSearchCheck & check) {
+        std::swap(search, check.search);
+    }
+private:
+    std::function<void()> search;
+};
+
+//! Wallets are searched one at a time, each search is a long running task
+static CCheckQueue<CStakeSearchCheck> stakesearchqueue(1);
+
+void ThreadStakeSearch() {
+    RenameThread("blocknet-stakesrch");
+    stakesearchqueue.Thread();
+}
+
 void ThreadStakeMinter() {
     RenameThread("blocknet-staker");
     LogPrintf("Staker has started\n");
@@ -85,38 +111,112 @@ bool StakeMgr::Update(std::vector<std::shared_ptr<CWallet>> & wallets, const CBl
         stakeTimes.clear();
     }
 
-    std::vector<StakeOutput> selected; // selected coins that meet criteria for staking
     const auto argStakeAmount = static_cast<CAmount>(gArgs.GetArg("-minstakeamount", 0));
     const auto minStakeAmount = argStakeAmount == 0 ? 1 : argStakeAmount * COIN;
     const auto tipHeight = tip->nHeight;
 
-    for (const auto & pwallet : wallets) {
-        const std::vector<COutput> & coins = StakeOutputs(pwallet.get(), minStakeAmount);
-        // Find suitable staking coins
-        for (const COutput & out : coins) {
-            if (SuitableCoin(out, tipHeight, params))
-                selected.emplace_back(std::make_shared<COutput>(out), pwallet);
-        }
-    }
-
     // Always search for stake from last block time if the tip changed
     lastUpdateTime = tipChanged ? tip->GetBlockTime() + 1 : lastUpdateTime + 1;
+    const int64_t fromTime = lastUpdateTime;
+
+    // Results of searching a single wallet. Stakes are kept per input in the
+    // order the wallet returned them so that merging is deterministic.
+    struct WalletSearch {
+        std::vector<std::map<int64_t, std::vector<StakeCoin>>> stakes;
+        int inputs{0};
+        CAmount stakeableAmount{0};
+        bool locked{false};
+        int64_t lockWaitMicros{0};
+        int64_t selectMicros{0};
+        int64_t searchMicros{0};
+        int64_t endTime{0};
+    };
+    std::vector<WalletSearch> searches(wallets.size());
+
+    // Select suitable staking coins from the wallet and cache all possible
+    // stakes between last update and few seconds into the future. Only this
+    // wallet's locks are taken.
+    auto searchWallet = [&](const size_t & i) {
+        auto & search = searches[i];
+        auto wallet = wallets[i];
+        try {
+            const auto selectStart = GetTimeMicros();
+            search.locked = wallet->IsLocked();
+            std::vector<std::shared_ptr<COutput>> selected;
+            for (const COutput & out : StakeOutputs(wallet.get(), minStakeAmount, &search.lockWaitMicros)) {
+                if (SuitableCoin(out, tipHeight, params)) {
+                    selected.push_back(std::make_shared<COutput>(out));
+                    search.stakeableAmount += out.GetInputCoin().txout.nValue;
+                }
+            }
+            search.inputs = static_cast<int>(selected.size());
+            const auto searchStart = GetTimeMicros();
+            search.selectMicros = searchStart - selectStart;
+
+            for (const auto & out : selected) {
+                if (ShutdownRequested())
+                    break;
+                std::map<int64_t, std::vector<StakeCoin>> stakes;
+                const auto coinAdjustedTime = GetAdjustedTime(); // update here b/c this loop could be long running process
+                const auto blockTime = std::max(tip->GetBlockTime()+1, coinAdjustedTime);
+                search.endTime = blockTime + params.PoSFutureBlockTimeLimit(blockTime); // current time + seconds into future
+                if (!GetStakesMeetingTarget(out, wallet, tip, coinAdjustedTime, blockTime, fromTime, search.endTime, stakes, params))
+                    continue;
+                if (!stakes.empty())
+                    search.stakes.push_back(std::move(stakes));
+            }
+            search.searchMicros = GetTimeMicros() - searchStart;
+        } catch (std::exception & e) {
+            LogPrintf("Staker failed to search wallet (%s): %s\n", wallet->GetDisplayName(), e.what());
+        }
+    };
 
-    // Cache all possible stakes between last update and few seconds into the future
-    for (const auto & item : selected) {
-        boost::this_thread::interruption_point();
-        const auto out = item.out;
-        auto wallet = item.wallet;
-        std::map<int64_t, std::vector<StakeCoin>> stakes;
-        adjustedTime = GetAdjustedTime(); // update here b/c this loop could be long running process
-        const auto blockTime = std::max(tip->GetBlockTime()+1, adjustedTime);
-        endTime = blockTime + params.PoSFutureBlockTimeLimit(blockTime); // current time + seconds into future
-        if (!GetStakesMeetingTarget(out, wallet, tip, adjustedTime, blockTime, lastUpdateTime, endTime, stakes, params))
-            continue;
-        if (!stakes.empty()) {
+    // Wallets are searched on the stake search threads so that nodes with many
+    // wallets keep up with the staking timeslots. The staker thread joins in
+    // until all wallets are done.
+    const uint64_t hashesStart = kernelHashes;
+    if (wallets.size() <= 1) {
+        for (size_t i = 0; i < wallets.size(); ++i)
+            searchWallet(i);
+    } else {
+        std::vector<CStakeSearchCheck> checks;
+        checks.reserve(wallets.size());
+        for (size_t i = 0; i < wallets.size(); ++i)
+            checks.emplace_back([&searchWallet, i]() { searchWallet(i); });
+        CCheckQueueControl<CStakeSearchCheck> control(&stakesearchqueue);
+        control.Add(checks);
+        control.Wait();
+    }
+    boost::this_thread::interruption_point();
+    const uint64_t hashes = kernelHashes - hashesStart;
+
+    // Merge in wallet order. The first input found for a stake time wins.
+    StakeStats last;
+    for (auto & search : searches) {
+        for (const auto & stakes : search.stakes) {
             LOCK(mu);
             stakeTimes.insert(stakes.begin(), stakes.end());
         }
+        endTime = std::max(endTime, search.endTime);
+        last.eligibleInputs += search.inputs;
+        last.stakeableAmount += search.stakeableAmount;
+        last.lockedWallets += search.locked ? 1 : 0;
+        last.lockWaitMicros += search.lockWaitMicros;
+        last.selectMicros += search.selectMicros;
+        last.searchMicros += search.searchMicros;
+    }
+
+    {
+        LOCK(statsMu);
+        stats.eligibleInputs = last.eligibleInputs;
+        stats.stakeableAmount = last.stakeableAmount;
+        stats.lockedWallets = last.lockedWallets;
+        stats.kernelHashes = hashes;
+        stats.selectMicros = last.selectMicros;
+        stats.lockWaitMicros = last.lockWaitMicros;
+        stats.searchMicros = last.searchMicros;
+        stats.expectedStakeTime = expectedStakeTime(last.stakeableAmount, tip->nBits, adjustedTime, params);
+        stats.totalKernelHashes += hashes;
     }
 
     lastBlockHeight = tipHeight;
@@ -138,10 +238,31 @@ bool StakeMgr::TryStake(const CBlockIndex *tip, const CChainParams & chainparams
         stakeTimes.clear(); // reset stake selections after trying stakes
     }
 
+    uint64_t missedWalletLocked{0};
+    {
+        LOCK(statsMu);
+        missedWalletLocked = stats.missedWalletLocked;
+    }
+
     for (const auto & nextStake : nextStakes) {
-        if (StakeBlock(nextStake, chainparams))
+        if (StakeBlock(nextStake, chainparams)) {
+            LOCK(statsMu);
+            ++stats.stakesFound;
             return true;
+        }
+    }
+
+    // None of the stakes made it into the chain, record why
+    bool tipChanged{false};
+    {
+        LOCK(cs_main);
+        tipChanged = chainActive.Tip() != tip;
     }
+    LOCK(statsMu);
+    if (tipChanged)
+        ++stats.missedStale;
+    else if (stats.missedWalletLocked == missedWalletLocked)
+        ++stats.missedFailed;
 
     return false;
 }
@@ -191,6 +312,8 @@ bool StakeMgr::StakeBlock(const StakeCoin & stakeCoin, const CChainParams & chai
         LOCK(stakeCoin.wallet->cs_wallet);
         if (stakeCoin.wallet->IsLocked()) {
             LogPrintf("Missed stake because wallet (%s) is locked!\n", stakeCoin.wallet->GetDisplayName());
+            LOCK(statsMu);
+            ++stats.missedWalletLocked;
             return false;
         }
     }
@@ -240,12 +363,15 @@ bool StakeMgr::SuitableCoin(const COutput & coin, const int & tipHeight, const C
     return true;
 }
 
-std::vector<COutput> StakeMgr::StakeOutputs(CWallet *wallet, const CAmount & minStakeAmount) const {
+std::vector<COutput> StakeMgr::StakeOutputs(CWallet *wallet, const CAmount & minStakeAmount, int64_t *lockWaitMicros) const {
     std::vector<COutput> coins; // all confirmed coins
+    const auto lockStart = GetTimeMicros();
     auto locked_chain = wallet->chain().lock();
     LOCK2(cs_main, wallet->cs_wallet);
+    if (lockWaitMicros)
+        *lockWaitMicros += GetTimeMicros() - lockStart;
     if (wallet->IsLocked()) {
-        static int stakelog{-1};
+        static std::atomic<int> stakelog{-1};
         if (++stakelog % 10 == 0)
             LogPrintf("Wallet is locked not staking inputs: %s\n", wallet->GetDisplayName());
         return coins; // skip locked wallets
@@ -277,6 +403,7 @@ bool StakeMgr::GetStakesMeetingTarget(const std::shared_ptr<COutput> & coin, std
     arith_uint256 bnTargetPerCoinDay;
     bnTargetPerCoinDay.SetCompact(tip->nBits);
 
+    uint64_t hashes{0};
     if (IsProtocolV05(fromTime)) { // Protocol v5+
         if (blockTime - params.stakeMinAge <= hashBlockTime) // valid modifier time check
             return false;
@@ -285,6 +412,7 @@ bool StakeMgr::GetStakesMeetingTarget(const std::shared_ptr<COutput> & coin, std
         for (; i < toTime; ++i) {
             if (i - txTime < params.stakeMinAge)
                 continue; // skip coins that don't meet stake age
+            ++hashes;
             uint64_t stakeModifier{0};
             int stakeModifierHeight{0};
             int64_t stakeModifierTime{0};
@@ -330,6 +458,7 @@ bool StakeMgr::GetStakesMeetingTarget(const std::shared_ptr<COutput> & coin, std
         for (; i < toTime; ++i) {
             if (i - txTime < params.stakeMinAge) // skip coins that don't meet stake age
                 continue;
+            ++hashes;
             const auto hashProofOfStake = stakeHash(i, ss, coin->i, coin->tx->GetHash(), hashBlockTime);
             if (!stakeTargetHit(hashProofOfStake, coin->GetInputCoin().txout.nValue, bnTargetPerCoinDay))
                 continue;
@@ -339,15 +468,25 @@ bool StakeMgr::GetStakesMeetingTarget(const std::shared_ptr<COutput> & coin, std
         }
     }
 
+    kernelHashes += hashes;
     return true;
 }
 
+StakeMgr::StakeStats StakeMgr::GetStats() {
+    LOCK(statsMu);
+    return stats;
+}
+
 void StakeMgr::Reset() {
     {
         LOCK(mu);
         stakeTimes.clear();
         stakeModifiers.clear();
     }
+    {
+        LOCK(statsMu);
+        stats = StakeStats{};
+    }
     lastUpdateTime = 0;
     lastBlockHeight = 0;
 }
\ No newline at end of file
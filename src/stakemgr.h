@@ -15,6 +15,9 @@
 #include <boost/date_time/posix_time/posix_time.hpp>
 #include <boost/thread.hpp>
 
+//! Upper bound on the number of threads searching wallets for stakes, including the staker thread
+static const int MAX_STAKE_SEARCH_THREADS = 8;
+
 class StakeMgr {
 public:
     struct StakeCoin {
@@ -75,6 +78,23 @@ public:
             wallet = nullptr;
         }
     };
+    struct StakeStats {
+        // Last completed stake search
+        int eligibleInputs{0};       // inputs that met the staking criteria
+        CAmount stakeableAmount{0};  // total value of the eligible inputs
+        int lockedWallets{0};        // wallets skipped because they were locked
+        uint64_t kernelHashes{0};    // kernel hashes evaluated
+        int64_t selectMicros{0};     // time spent selecting inputs from the wallets
+        int64_t lockWaitMicros{0};   // part of selectMicros spent waiting on cs_main and cs_wallet
+        int64_t searchMicros{0};     // time spent in GetStakesMeetingTarget
+        double expectedStakeTime{0}; // expected seconds until a stake is found at the tip difficulty
+        // Since the staker started
+        uint64_t totalKernelHashes{0};
+        uint64_t stakesFound{0};
+        uint64_t missedStale{0};        // stakes that lost the race to a new chain tip
+        uint64_t missedWalletLocked{0}; // stakes that couldn't be signed because the wallet was locked
+        uint64_t missedFailed{0};       // stakes that met the target but couldn't be submitted
+    };
 
 public:
     bool Update(std::vector<std::shared_ptr<CWallet>> & wallets, const CBlockIndex *tip, const Consensus::Params & params, const bool & skipPeerRequirement=false);
@@ -85,10 +105,11 @@ public:
     int LastBlockHeight() const;
     const StakeCoin & GetStake();
     bool SuitableCoin(const COutput & coin, const int & tipHeight, const Consensus::Params & params) const;
-    std::vector<COutput> StakeOutputs(CWallet *wallet, const CAmount & minStakeAmount) const;
+    std::vector<COutput> StakeOutputs(CWallet *wallet, const CAmount & minStakeAmount, int64_t *lockWaitMicros = nullptr) const;
     bool GetStakesMeetingTarget(const std::shared_ptr<COutput> & coin, std::shared_ptr<CWallet> & wallet,
         const CBlockIndex *tip, const int64_t & adjustedTime, const int64_t & blockTime, const int64_t & fromTime,
         const int64_t & toTime, std::map<int64_t, std::vector<StakeCoin>> & stakes, const Consensus::Params & params);
+    StakeStats GetStats();
     void Reset();
 
 private:
@@ -111,9 +132,13 @@ private:
     std::map<uint256, uint64_t> stakeModifiers;
     std::atomic<int64_t> lastUpdateTime{0};
     std::atomic<int> lastBlockHeight{0};
+    std::atomic<uint64_t> kernelHashes{0};
+    Mutex statsMu;
+    StakeStats stats GUARDED_BY(statsMu);
 };
 
 extern void ThreadStakeMinter();
+extern void ThreadStakeSearch();
 extern std::unique_ptr<StakeMgr> g_staker;
 
 #endif // BITCOIN_STAKEMGR_H
@@ -9,6 +9,8 @@
 
 #include <stdio.h>
 
+#include <algorithm>
+#include <chrono>
 #include <map>
 #include <memory>
 #include <set>
@@ -24,6 +26,136 @@ void PrintLockContention(const char* pszName, const char* pszFile, int nLine)
 }
 #endif /* DEBUG_LOCKCONTENTION */
 
+std::atomic<bool> g_lock_profile{DEFAULT_LOCK_PROFILE};
+
+struct LockProfileSite {
+    std::atomic<uint64_t> key{0}; //!< hash of the mutex and call site, 0 if the slot is free
+    std::atomic<void*> cs{nullptr};
+    std::atomic<const char*> name{nullptr};
+    std::atomic<const char*> file{nullptr};
+    std::atomic<int> line{0};
+    std::atomic<uint64_t> acquisitions{0};
+    std::atomic<uint64_t> contentions{0};
+    std::atomic<int64_t> waitNanos{0};
+    std::atomic<int64_t> maxWaitNanos{0};
+    std::atomic<int64_t> holdNanos{0};
+};
+
+//! Number of call sites that can be profiled, must be a power of two
+static const size_t LOCK_PROFILE_SITES = 4096;
+//! Slots probed before a call site is left unprofiled
+static const size_t LOCK_PROFILE_MAX_PROBES = 64;
+static LockProfileSite g_lock_profile_sites[LOCK_PROFILE_SITES];
+
+LockProfileSite* GetLockProfileSite(const char* pszName, const char* pszFile, int nLine, void* cs)
+{
+    uint64_t key = reinterpret_cast<uintptr_t>(cs) * 0x9E3779B97F4A7C15ULL;
+    key ^= (reinterpret_cast<uintptr_t>(pszFile) + static_cast<uint64_t>(nLine)) * 0xC2B2AE3D27D4EB4FULL;
+    key ^= key >> 29;
+    if (key == 0)
+        key = 1;
+    for (size_t i = 0; i < LOCK_PROFILE_MAX_PROBES; ++i) {
+        LockProfileSite& site = g_lock_profile_sites[(key + i) & (LOCK_PROFILE_SITES - 1)];
+        uint64_t current = site.key.load(std::memory_order_acquire);
+        if (current == 0 && site.key.compare_exchange_strong(current, key)) {
+            site.cs = cs;
+            site.name = pszName;
+            site.line = nLine;
+            site.file.store(pszFile, std::memory_order_release); // published last, see GetLockContention
+            return &site;
+        }
+        if (current == key)
+            return &site;
+    }
+    return nullptr;
+}
+
+void LockProfileAcquired(LockProfileSite* site, int64_t waitNanos, bool contended)
+{
+    site->acquisitions.fetch_add(1, std::memory_order_relaxed);
+    if (!contended)
+        return;
+    site->contentions.fetch_add(1, std::memory_order_relaxed);
+    site->waitNanos.fetch_add(waitNanos, std::memory_order_relaxed);
+    int64_t maxWait = site->maxWaitNanos.load(std::memory_order_relaxed);
+    while (waitNanos > maxWait && !site->maxWaitNanos.compare_exchange_weak(maxWait, waitNanos, std::memory_order_relaxed)) {}
+}
+
+void LockProfileReleased(LockProfileSite* site, int64_t holdNanos)
+{
+    site->holdNanos.fetch_add(holdNanos, std::memory_order_relaxed);
+}
+
+int64_t LockProfileNanos()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+std::vector<LockContentionStats> GetLockContention(size_t maxSites)
+{
+    // Call sites in headers get a slot per translation unit, merge them by location
+    std::map<void*, std::map<std::string, LockContentionSite>> locks;
+    std::map<void*, std::string> names;
+    for (const LockProfileSite& site : g_lock_profile_sites) {
+        const char* file = site.file.load(std::memory_order_acquire);
+        if (!file)
+            continue;
+        void* cs = site.cs;
+        const std::string location = strprintf("%s:%d", file, site.line);
+        auto& s = locks[cs][location];
+        s.location = location;
+        s.acquisitions += site.acquisitions;
+        s.contentions += site.contentions;
+        s.waitNanos += site.waitNanos;
+        s.maxWaitNanos = std::max<int64_t>(s.maxWaitNanos, site.maxWaitNanos);
+        s.holdNanos += site.holdNanos;
+        if (!names.count(cs))
+            names[cs] = site.name;
+    }
+
+    std::vector<LockContentionStats> result;
+    for (auto& item : locks) {
+        LockContentionStats stats;
+        stats.name = names[item.first];
+        for (auto& s : item.second) {
+            stats.acquisitions += s.second.acquisitions;
+            stats.contentions += s.second.contentions;
+            stats.waitNanos += s.second.waitNanos;
+            stats.maxWaitNanos = std::max(stats.maxWaitNanos, s.second.maxWaitNanos);
+            stats.holdNanos += s.second.holdNanos;
+            stats.sites.push_back(s.second);
+        }
+        if (stats.acquisitions == 0)
+            continue;
+        std::sort(stats.sites.begin(), stats.sites.end(), [](const LockContentionSite& a, const LockContentionSite& b) {
+            return a.waitNanos != b.waitNanos ? a.waitNanos > b.waitNanos : a.holdNanos > b.holdNanos;
+        });
+        if (stats.sites.size() > maxSites)
+            stats.sites.resize(maxSites);
+        result.push_back(std::move(stats));
+    }
+    std::sort(result.begin(), result.end(), [](const LockContentionStats& a, const LockContentionStats& b) {
+        return a.waitNanos != b.waitNanos ? a.waitNanos > b.waitNanos : a.holdNanos > b.holdNanos;
+    });
+    return result;
+}
+
+void ResetLockContention()
+{
+    // Slots are released as well so that call sites of destroyed mutexes (e.g.
+    // those of disconnected peers) don't fill up the table. A lock held across
+    // the reset may still count its release against the old slot.
+    for (LockProfileSite& site : g_lock_profile_sites) {
+        site.file.store(nullptr, std::memory_order_release);
+        site.acquisitions = 0;
+        site.contentions = 0;
+        site.waitNanos = 0;
+        site.maxWaitNanos = 0;
+        site.holdNanos = 0;
+        site.key.store(0, std::memory_order_release);
+    }
+}
+
 #ifdef DEBUG_LOCKORDER
 //
 // Early deadlock detection.
@@ -8,9 +8,14 @@
 
 #include <threadsafety.h>
 
+#include <stdint.h>
+
+#include <atomic>
 #include <condition_variable>
+#include <string>
 #include <thread>
 #include <mutex>
+#include <vector>
 
 
 ////////////////////////////////////////////////
@@ -114,14 +119,75 @@ typedef AnnotatedMixin<std::mutex> Mutex;
 void PrintLockContention(const char* pszName, const char* pszFile, int nLine);
 #endif
 
+/**
+ * Lock contention profiling. When enabled (-lockprofile) every LOCK records
+ * how long it waited for the mutex and how long it held it, aggregated per
+ * call site. Counters live in a fixed table of atomics so recording doesn't
+ * take any lock of its own. When disabled the cost is one relaxed load.
+ */
+static const bool DEFAULT_LOCK_PROFILE = false;
+extern std::atomic<bool> g_lock_profile;
+
+struct LockProfileSite;
+LockProfileSite* GetLockProfileSite(const char* pszName, const char* pszFile, int nLine, void* cs);
+void LockProfileAcquired(LockProfileSite* site, int64_t waitNanos, bool contended);
+void LockProfileReleased(LockProfileSite* site, int64_t holdNanos);
+int64_t LockProfileNanos();
+
+struct LockContentionSite {
+    std::string location;
+    uint64_t acquisitions{0};
+    uint64_t contentions{0};
+    int64_t waitNanos{0};
+    int64_t maxWaitNanos{0};
+    int64_t holdNanos{0};
+};
+
+struct LockContentionStats {
+    std::string name;
+    uint64_t acquisitions{0};
+    uint64_t contentions{0};
+    int64_t waitNanos{0};
+    int64_t maxWaitNanos{0};
+    int64_t holdNanos{0};
+    std::vector<LockContentionSite> sites; //!< call sites ordered by wait time
+};
+
+/** Profiled mutexes ordered by total wait time, with up to maxSites call sites each. */
+std::vector<LockContentionStats> GetLockContention(size_t maxSites);
+void ResetLockContention();
+
 /** Wrapper around std::unique_lock style lock for Mutex. */
 template <typename Mutex, typename Base = typename Mutex::UniqueLock>
 class SCOPED_LOCKABLE UniqueLock : public Base
 {
 private:
+    LockProfileSite* m_profile_site{nullptr};
+    int64_t m_profile_locked{0};
+
+    void ProfiledEnter(const char* pszName, const char* pszFile, int nLine)
+    {
+        m_profile_site = GetLockProfileSite(pszName, pszFile, nLine, (void*)(Base::mutex()));
+        const int64_t start = LockProfileNanos();
+        const bool contended = !Base::try_lock();
+        if (contended) {
+#ifdef DEBUG_LOCKCONTENTION
+            PrintLockContention(pszName, pszFile, nLine);
+#endif
+            Base::lock();
+        }
+        m_profile_locked = LockProfileNanos();
+        if (m_profile_site)
+            LockProfileAcquired(m_profile_site, contended ? m_profile_locked - start : 0, contended);
+    }
+
     void Enter(const char* pszName, const char* pszFile, int nLine)
     {
         EnterCritical(pszName, pszFile, nLine, (void*)(Base::mutex()));
+        if (g_lock_profile.load(std::memory_order_relaxed)) {
+            ProfiledEnter(pszName, pszFile, nLine);
+            return;
+        }
 #ifdef DEBUG_LOCKCONTENTION
         if (!Base::try_lock()) {
             PrintLockContention(pszName, pszFile, nLine);
@@ -138,6 +204,12 @@ private:
         Base::try_lock();
         if (!Base::owns_lock())
             LeaveCritical();
+        else if (g_lock_profile.load(std::memory_order_relaxed)) {
+            m_profile_site = GetLockProfileSite(pszName, pszFile, nLine, (void*)(Base::mutex()));
+            m_profile_locked = LockProfileNanos();
+            if (m_profile_site)
+                LockProfileAcquired(m_profile_site, 0, false);
+        }
         return Base::owns_lock();
     }
 
@@ -163,8 +235,12 @@ public:
 
     ~UniqueLock() UNLOCK_FUNCTION()
     {
-        if (Base::owns_lock())
+        if (Base::owns_lock()) {
+            // Hold time includes any condition variable waits on this lock
+            if (m_profile_site)
+                LockProfileReleased(m_profile_site, LockProfileNanos() - m_profile_locked);
             LeaveCritical();
+        }
     }
 
     operator bool()
@@ -6,7 +6,9 @@
 #include <coins.h>
 #include <consensus/validation.h>
 #include <script/standard.h>
+#include <streams.h>
 #include <test/test_bitcoin.h>
+#include <txdb.h>
 #include <uint256.h>
 #include <undo.h>
 #include <util/strencodings.h>
@@ -858,4 +860,110 @@ BOOST_AUTO_TEST_CASE(ccoins_write)
                     CheckWriteCoins(parent_value, child_value, parent_value, parent_flags, child_flags, parent_flags);
 }
 
+BOOST_AUTO_TEST_CASE(utxo_snapshot_roundtrip)
+{
+    const uint256 base = InsecureRand256();
+    CCoinsViewDB source(1 << 20, true);
+    std::map<COutPoint, Coin> coins;
+    {
+        CCoinsViewCache cache(&source);
+        for (int i = 0; i < 200; ++i) {
+            COutPoint outpoint(InsecureRand256(), InsecureRandRange(4));
+            CTxOut txout;
+            txout.nValue = InsecureRandRange(1000000) + 1;
+            txout.scriptPubKey.assign(InsecureRandBits(6), 0);
+            Coin coin(std::move(txout), InsecureRandRange(100000), InsecureRandBool());
+            coins[outpoint] = coin;
+            cache.AddCoin(outpoint, std::move(coin), false);
+        }
+        cache.SetBestBlock(base);
+        BOOST_CHECK(cache.Flush());
+    }
+
+    const fs::path path = GetDataDir() / "snapshot.dat";
+    CUTXOSnapshotMetadata metadata(base, coins.size());
+    uint256 written_hash;
+    {
+        CAutoFile file(fsbridge::fopen(path, "wb"), SER_DISK, CLIENT_VERSION);
+        std::unique_ptr<CCoinsViewCursor> cursor(source.Cursor());
+        BOOST_CHECK(WriteUTXOSnapshot(file, *cursor, metadata, written_hash));
+    }
+
+    // The file holds the metadata followed by every coin, and the hash covers both
+    {
+        CAutoFile file(fsbridge::fopen(path, "rb"), SER_DISK, CLIENT_VERSION);
+        CUTXOSnapshotMetadata read;
+        file >> read;
+        BOOST_CHECK(read.base_blockhash == base);
+        BOOST_CHECK_EQUAL(read.coins_count, coins.size());
+        CHashWriter ss(SER_GETHASH, PROTOCOL_VERSION);
+        ss << read;
+        for (uint64_t i = 0; i < read.coins_count; ++i) {
+            COutPoint outpoint;
+            Coin coin;
+            file >> outpoint;
+            file >> coin;
+            BOOST_CHECK(coins.count(outpoint) && coins[outpoint] == coin);
+            ss << outpoint << coin;
+        }
+        BOOST_CHECK(ss.GetHash() == written_hash);
+        unsigned char trailing;
+        BOOST_CHECK_EQUAL(fread(&trailing, 1, 1, file.Get()), 0U);
+    }
+
+    fs::remove(path);
+}
+
+BOOST_AUTO_TEST_CASE(ccoins_map_arena)
+{
+    CCoinsMap map;
+    std::map<COutPoint, CAmount> expected;
+    std::vector<CCoinsCacheEntry*> entries;
+    for (int i = 0; i < 1000; ++i) {
+        COutPoint outpoint(InsecureRand256(), i);
+        CCoinsCacheEntry& entry = map[outpoint];
+        entry.coin.out.nValue = i;
+        entries.push_back(&entry);
+        expected[outpoint] = i;
+    }
+    BOOST_CHECK_EQUAL(map.size(), expected.size());
+
+    // Entries keep their address while the table grows
+    for (int i = 0; i < 1000; ++i)
+        BOOST_CHECK_EQUAL(entries[i]->coin.out.nValue, i);
+
+    // Erase odd values while iterating, then look up everything
+    for (CCoinsMap::iterator it = map.begin(); it != map.end();) {
+        if (it->second.coin.out.nValue % 2) {
+            expected.erase(it->first);
+            it = map.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    BOOST_CHECK_EQUAL(map.size(), expected.size());
+    size_t seen = 0;
+    for (const auto& item : map) {
+        BOOST_CHECK_EQUAL(expected.at(item.first), item.second.coin.out.nValue);
+        ++seen;
+    }
+    BOOST_CHECK_EQUAL(seen, expected.size());
+    for (int i = 0; i < 1000; ++i)
+        BOOST_CHECK(map.find(COutPoint(InsecureRand256(), i)) == map.end());
+
+    // Freed entries are reused and an existing key is not inserted twice
+    const size_t usage = memusage::DynamicUsage(map);
+    for (const auto& item : expected)
+        BOOST_CHECK(!map.emplace(item.first, CCoinsCacheEntry()).second);
+    for (int i = 0; i < 500; ++i)
+        BOOST_CHECK(map.emplace(COutPoint(InsecureRand256(), i), CCoinsCacheEntry()).second);
+    BOOST_CHECK_EQUAL(map.size(), expected.size() + 500);
+    BOOST_CHECK_EQUAL(memusage::DynamicUsage(map), usage);
+
+    map.clear();
+    BOOST_CHECK(map.empty());
+    BOOST_CHECK(map.begin() == map.end());
+    BOOST_CHECK(map.find(expected.begin()->first) == map.end());
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -1979,6 +1979,12 @@ BOOST_AUTO_TEST_CASE(governance_tests_superblockresults)
             BOOST_CHECK_MESSAGE(payees.size() == allProposalsB.size(), "Superblock payees should match expected proposals");
             BOOST_CHECK_MESSAGE(gov::Governance::instance().isValidSuperblock(&block, chainActive.Height(), consensus, superblockPayment), "Expected superblock payout to be valid");
             BOOST_CHECK_MESSAGE(gov::Governance::isSuperblock(chainActive.Height(), consensus), "Expected superblock to be accepted");
+            // Staking and validation share the payees derived for the current governance state
+            const auto commitment = gov::Governance::instance().getSuperblockCommitment(chainActive.Height(), consensus);
+            BOOST_CHECK_MESSAGE(commitment->hasResults, "Superblock commitment should have results");
+            BOOST_CHECK_MESSAGE(commitment->payees == payees, "Superblock commitment payees should match the vote results");
+            BOOST_CHECK_EQUAL(commitment->version, gov::Governance::instance().getVersion());
+            BOOST_CHECK_MESSAGE(commitment == gov::Governance::instance().getSuperblockCommitment(chainActive.Height(), consensus), "Expected the superblock commitment to be reused");
         }
 
         std::set<gov::Proposal> proposalsB;
@@ -3533,4 +3539,44 @@ BOOST_AUTO_TEST_CASE(governance_tests_rpc)
     pos_ptr.reset();
 }
 
+BOOST_FIXTURE_TEST_CASE(governance_tests_votepubkeyrecovery, BasicTestingSetup)
+{
+    CKey key; key.MakeNewKey(true);
+    const auto proposalHash = GetRandHash();
+
+    // Signed votes deserialized from the network recover their pubkey on demand
+    std::vector<gov::Vote> votes;
+    for (int i = 0; i < 100; ++i) {
+        const COutPoint utxo{GetRandHash(), static_cast<uint32_t>(i)};
+        gov::Vote vote(proposalHash, gov::YES, utxo, gov::makeVinHash(utxo), key.GetPubKey().GetID(), 25*COIN);
+        BOOST_CHECK(vote.sign(key));
+        CDataStream ss(SER_NETWORK, GOV_PROTOCOL_VERSION);
+        ss << vote;
+        gov::Vote v2;
+        ss >> v2;
+        BOOST_CHECK_MESSAGE(v2.getHash() == vote.getHash(), "Vote hash should match after deserialization");
+        BOOST_CHECK_MESSAGE(v2.sigHash() == vote.sigHash(), "Vote sighash should match after deserialization");
+        votes.push_back(v2);
+    }
+    BOOST_CHECK_MESSAGE(votes[0].getPubKey() == key.GetPubKey(), "Lazily recovered pubkey should match the signing key");
+
+    // Batch recovery
+    std::vector<const gov::Vote*> recover;
+    for (const auto & vote : votes)
+        recover.push_back(&vote);
+    gov::RecoverVotePubKeys(recover, 4);
+    for (const auto & vote : votes)
+        BOOST_CHECK_MESSAGE(vote.getPubKey() == key.GetPubKey(), "Batch recovered pubkey should match the signing key");
+
+    // Pubkey and hashes are persisted in the governance db model
+    gov::CDiskVote dvote(votes[1]);
+    CDataStream ssd(SER_DISK, CLIENT_VERSION);
+    ssd << dvote;
+    gov::CDiskVote dvote2;
+    ssd >> dvote2;
+    BOOST_CHECK_MESSAGE(dvote2.getPubKey() == key.GetPubKey(), "Persisted pubkey should match the signing key");
+    BOOST_CHECK_MESSAGE(dvote2.sigHash() == votes[1].sigHash(), "Persisted sighash should match");
+    BOOST_CHECK_MESSAGE(dvote2.getHash() == votes[1].getHash(), "Persisted hash should match");
+}
+
 BOOST_AUTO_TEST_SUITE_END()
\ No newline at end of file
@@ -76,4 +76,34 @@ BOOST_AUTO_TEST_CASE(test_combiner_all)
     Test.disconnect(&ReturnTrue);
     BOOST_CHECK(Test());
 }
+
+BOOST_AUTO_TEST_CASE(hashproofofstake_cache_test)
+{
+    PruneHashProofOfStake(std::numeric_limits<int>::max() / 2);
+    const int tip = 1000;
+    for (int i = 0; i < 10; ++i)
+        SetHashProofOfStake(InsecureRand256(), InsecureRand256(), tip - POS_HASH_CACHE_DEPTH - 10 + i);
+    const uint256 recent = InsecureRand256();
+    const uint256 kernel = InsecureRand256();
+    SetHashProofOfStake(recent, kernel, tip);
+    BOOST_CHECK_EQUAL(HashProofOfStakeCacheSize(), 11);
+    BOOST_CHECK(GetHashProofOfStake(recent) == kernel);
+
+    // Entries buried deeper than the cache depth are evicted
+    PruneHashProofOfStake(tip);
+    BOOST_CHECK_EQUAL(HashProofOfStakeCacheSize(), 1);
+    BOOST_CHECK(HasHashProofOfStake(recent));
+
+    // Entries are dropped once they're stored on the block index
+    RemoveHashProofOfStake(recent);
+    BOOST_CHECK(!HasHashProofOfStake(recent));
+    BOOST_CHECK(GetHashProofOfStake(recent).IsNull());
+
+    // The cache never grows past its maximum size, deepest entries go first
+    for (size_t i = 0; i < MAX_POS_HASH_CACHE_SIZE + 10; ++i)
+        SetHashProofOfStake(InsecureRand256(), InsecureRand256(), tip + static_cast<int>(i));
+    BOOST_CHECK_EQUAL(HashProofOfStakeCacheSize(), MAX_POS_HASH_CACHE_SIZE);
+    PruneHashProofOfStake(std::numeric_limits<int>::max() / 2);
+    BOOST_CHECK_EQUAL(HashProofOfStakeCacheSize(), 0);
+}
 BOOST_AUTO_TEST_SUITE_END()
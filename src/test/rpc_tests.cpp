@@ -19,6 +19,8 @@
 
 #include <univalue.h>
 
+#include <thread>
+
 #include <rpc/blockchain.h>
 
 UniValue CallRPC(std::string args)
@@ -420,4 +422,46 @@ BOOST_AUTO_TEST_CASE(rpc_getblockstats_calculate_percentiles_by_weight)
     }
 }
 
+BOOST_AUTO_TEST_CASE(rpc_batch_concurrent)
+{
+    BOOST_CHECK(tableRPC["getblockhash"]->concurrentBatch);
+    BOOST_CHECK(!tableRPC["uptime"]->concurrentBatch);
+
+    // Read-only calls around a barrier command, results must keep request order
+    UniValue batch(UniValue::VARR);
+    for (int i = 0; i < 8; ++i) {
+        UniValue req(UniValue::VOBJ);
+        UniValue params(UniValue::VARR);
+        if (i != 4)
+            params.push_back(i == 6 ? 1000000 : 0); // out of range height returns an error
+        req.pushKV("method", i == 4 ? "uptime" : "getblockhash");
+        req.pushKV("params", params);
+        req.pushKV("id", i);
+        batch.push_back(req);
+    }
+
+    std::vector<std::thread> threads;
+    RPCWorkDispatcher dispatch = [&threads](std::function<void()> func) {
+        threads.emplace_back(func);
+        return true;
+    };
+    JSONRPCRequest jreq;
+    UniValue concurrent;
+    BOOST_CHECK(concurrent.read(JSONRPCExecBatch(jreq, batch, dispatch)));
+    for (auto& t : threads)
+        t.join();
+    UniValue serial;
+    BOOST_CHECK(serial.read(JSONRPCExecBatch(jreq, batch)));
+
+    BOOST_CHECK(!threads.empty());
+    BOOST_CHECK_EQUAL(concurrent.size(), batch.size());
+    for (size_t i = 0; i < concurrent.size(); ++i) {
+        BOOST_CHECK_EQUAL(find_value(concurrent[i], "id").get_int(), (int)i);
+        if (i != 4)
+            BOOST_CHECK_EQUAL(concurrent[i].write(), serial[i].write());
+    }
+    BOOST_CHECK(find_value(concurrent[6], "result").isNull());
+    BOOST_CHECK(!find_value(concurrent[6], "error").isNull());
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -970,6 +970,43 @@ BOOST_AUTO_TEST_CASE(servicenode_tests_registration_pings)
         smgr.reset();
     }
 
+    // Check snode service index is updated on ping and removal
+    {
+        CKey key; key.MakeNewKey(true);
+        BOOST_CHECK_MESSAGE(smgr.registerSn(key, sn::ServiceNode::SPV, EncodeDestination(dest), g_connman.get(), {pos.wallet}), "Register SPV tier snode");
+        const auto bestBlock = chainActive.Height();
+        const auto bestBlockHash = chainActive[bestBlock]->GetBlockHash();
+        auto snode = smgr.getSn(key.GetPubKey());
+        sn::ServiceNodePing ping(key.GetPubKey(), bestBlock, bestBlockHash, static_cast<uint32_t>(GetTime()),
+                R"({"xbridgeversion":50,"xrouterversion":50,"xrouter":{"config":"[Main]\nwallets=\nplugins=CustomPlugin1,CustomPlugin2\nhost=127.0.0.1", "plugins":{"CustomPlugin1":"","CustomPlugin2":""}}})", snode);
+        ping.sign(key);
+        CDataStream ss(SER_NETWORK, PROTOCOL_VERSION); ss << ping;
+        sn::ServiceNodePing pping;
+        BOOST_CHECK_MESSAGE(smgr.processPing(ss, pping), "processPing should succeed");
+        BOOST_CHECK_EQUAL(smgr.listWithService(xrouter::pluginCommandKey("CustomPlugin1")).size(), 1U);
+        BOOST_CHECK_EQUAL(smgr.listWithServices({xrouter::xr, xrouter::pluginCommandKey("CustomPlugin2")}).size(), 1U);
+        BOOST_CHECK(smgr.listWithServices({xrouter::xr, xrouter::pluginCommandKey("CustomPlugin3")}).empty());
+        BOOST_CHECK(smgr.hasService(key.GetPubKey(), xrouter::pluginCommandKey("CustomPlugin2")));
+        const auto services = smgr.serviceCount();
+        // Newer ping drops a service
+        sn::ServiceNodePing ping2(key.GetPubKey(), bestBlock, bestBlockHash, ping.getPingTime() + 10,
+                R"({"xbridgeversion":50,"xrouterversion":50,"xrouter":{"config":"[Main]\nwallets=\nplugins=CustomPlugin1\nhost=127.0.0.1", "plugins":{"CustomPlugin1":""}}})", snode);
+        ping2.sign(key);
+        CDataStream ss2(SER_NETWORK, PROTOCOL_VERSION); ss2 << ping2;
+        sn::ServiceNodePing pping2;
+        BOOST_CHECK_MESSAGE(smgr.processPing(ss2, pping2), "processPing should succeed for a newer ping");
+        BOOST_CHECK_EQUAL(smgr.listWithService(xrouter::pluginCommandKey("CustomPlugin1")).size(), 1U);
+        BOOST_CHECK(smgr.listWithService(xrouter::pluginCommandKey("CustomPlugin2")).empty());
+        BOOST_CHECK(!smgr.hasService(key.GetPubKey(), xrouter::pluginCommandKey("CustomPlugin2")));
+        BOOST_CHECK_EQUAL(smgr.serviceCount(), services - 1); // dropped service is freed
+        // Removed snodes are no longer listed
+        BOOST_CHECK(smgr.removeSn(key.GetPubKey()));
+        BOOST_CHECK(smgr.listWithService(xrouter::pluginCommandKey("CustomPlugin1")).empty());
+        BOOST_CHECK_EQUAL(smgr.serviceCount(), 0U);
+        sn::ServiceNodeMgr::writeSnConfig(std::vector<sn::ServiceNodeConfigEntry>(), false); // reset
+        smgr.reset();
+    }
+
     // TODO Blocknet OPEN tier snodes, support non-SPV snode tiers (enable unit tests)
 //    // Snode ping should fail on open tier with xr:: namespace
 //    {
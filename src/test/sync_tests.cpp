@@ -7,6 +7,10 @@
 
 #include <boost/test/unit_test.hpp>
 
+#include <atomic>
+#include <chrono>
+#include <thread>
+
 namespace {
 template <typename MutexType>
 void TestPotentialDeadLockDetected(MutexType& mutex1, MutexType& mutex2)
@@ -49,4 +53,51 @@ BOOST_AUTO_TEST_CASE(potential_deadlock_detected)
     #endif
 }
 
+BOOST_AUTO_TEST_CASE(lock_contention_profile)
+{
+    const bool prev = g_lock_profile;
+    g_lock_profile = true;
+    ResetLockContention();
+
+    Mutex profiled;
+    std::atomic<bool> held{false};
+    std::thread holder;
+    {
+        LOCK(profiled);
+        holder = std::thread([&]() {
+            held = true;
+            LOCK(profiled); // waits for the outer lock
+        });
+        while (!held)
+            std::this_thread::yield();
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    }
+    holder.join();
+    {
+        TRY_LOCK(profiled, locked);
+        BOOST_CHECK(locked);
+    }
+
+    bool found{false};
+    for (const auto& stats : GetLockContention(5)) {
+        if (stats.name != "profiled")
+            continue;
+        found = true;
+        BOOST_CHECK_EQUAL(stats.acquisitions, 3U);
+        BOOST_CHECK_EQUAL(stats.contentions, 1U);
+        BOOST_CHECK(stats.waitNanos > 0);
+        BOOST_CHECK_EQUAL(stats.maxWaitNanos, stats.waitNanos);
+        BOOST_CHECK(stats.holdNanos >= stats.waitNanos);
+        BOOST_CHECK_EQUAL(stats.sites.size(), 3U);
+        BOOST_CHECK_EQUAL(stats.sites[0].contentions, 1U); // the waiting site comes first
+    }
+    BOOST_CHECK(found);
+
+    ResetLockContention();
+    for (const auto& stats : GetLockContention(5))
+        BOOST_CHECK(stats.name != "profiled");
+
+    g_lock_profile = prev;
+}
+
 BOOST_AUTO_TEST_SUITE_END()
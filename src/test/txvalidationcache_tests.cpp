@@ -91,6 +91,59 @@ BOOST_FIXTURE_TEST_CASE(tx_mempool_block_doublespend, TestChain100Setup)
     BOOST_CHECK_EQUAL(mempool.size(), 0U);
 }
 
+BOOST_FIXTURE_TEST_CASE(tx_mempool_parallel_script_checks, TestChain100Setup)
+{
+    // Transactions with many inputs are checked on the script check threads,
+    // an invalid signature must still be rejected with the same reason.
+    CScript scriptPubKey = CScript() <<  ToByteVector(coinbaseKey.GetPubKey()) << OP_CHECKSIG;
+    const unsigned int inputs = MEMPOOL_PARALLEL_SCRIPT_CHECK_INPUTS * 2;
+
+    auto sign = [&](CMutableTransaction & tx, const unsigned int n) {
+        std::vector<unsigned char> vchSig;
+        uint256 hash = SignatureHash(scriptPubKey, tx, n, SIGHASH_ALL, 0, SigVersion::BASE);
+        BOOST_CHECK(coinbaseKey.Sign(hash, vchSig));
+        vchSig.push_back((unsigned char)SIGHASH_ALL);
+        tx.vin[n].scriptSig = CScript() << vchSig;
+    };
+
+    CMutableTransaction split;
+    split.nVersion = 1;
+    split.vin.resize(1);
+    split.vin[0].prevout = COutPoint(m_coinbase_txns[0]->GetHash(), 0);
+    split.vout.resize(inputs);
+    for (auto & out : split.vout) {
+        out.nValue = CENT;
+        out.scriptPubKey = scriptPubKey;
+    }
+    sign(split, 0);
+    BOOST_CHECK(ToMemPool(split));
+
+    CMutableTransaction spend;
+    spend.nVersion = 1;
+    spend.vin.resize(inputs);
+    for (unsigned int i = 0; i < inputs; ++i)
+        spend.vin[i].prevout = COutPoint(split.GetHash(), i);
+    spend.vout.resize(1);
+    spend.vout[0].nValue = inputs * CENT / 2;
+    spend.vout[0].scriptPubKey = scriptPubKey;
+    for (unsigned int i = 0; i < inputs; ++i)
+        sign(spend, i);
+
+    // Invalid signature on the last input
+    CMutableTransaction bad(spend);
+    bad.vin[inputs - 1].scriptSig = bad.vin[0].scriptSig;
+    {
+        LOCK(cs_main);
+        CValidationState state;
+        BOOST_CHECK(!AcceptToMemoryPool(mempool, state, MakeTransactionRef(bad), nullptr, nullptr, true, 0));
+        BOOST_CHECK_EQUAL(state.GetRejectReason().find("mandatory-script-verify-flag-failed"), 0U);
+    }
+
+    BOOST_CHECK(ToMemPool(spend));
+    BOOST_CHECK_EQUAL(mempool.size(), 2U);
+    mempool.clear();
+}
+
 // Run CheckInputs (using pcoinsTip) on the given transaction, for all script
 // flags.  Test that CheckInputs passes for all flags that don't overlap with
 // the failing_flags argument, but otherwise fails.
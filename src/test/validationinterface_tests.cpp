@@ -0,0 +1,178 @@
+// Copyright (c) 2021 The Blocknet developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <validationinterface.h>
+
+#include <primitives/transaction.h>
+#include <scheduler.h>
+
+#include <test/test_bitcoin.h>
+
+#include <chrono>
+#include <future>
+#include <mutex>
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_FIXTURE_TEST_SUITE(validationinterface_tests, TestingSetup)
+
+/** Records the nLockTime of every TransactionAddedToMempool notification */
+class QueueTestSubscriber : public CValidationInterface {
+public:
+    explicit QueueTestSubscriber(size_t expectedIn) : expected(expectedIn) {}
+
+    void TransactionAddedToMempool(const CTransactionRef & tx) override {
+        if (gate.valid()) {
+            started.set_value();
+            gate.wait();
+            gate = std::shared_future<void>(); // only hold the first callback
+        }
+        std::lock_guard<std::mutex> lock(mu);
+        seen.push_back(tx->nLockTime);
+        if (seen.size() == expected)
+            done.set_value();
+    }
+
+    std::vector<uint32_t> Seen() {
+        std::lock_guard<std::mutex> lock(mu);
+        return seen;
+    }
+
+    const size_t expected;
+    std::shared_future<void> gate; // if set the first callback waits on it
+    std::promise<void> started;
+    std::promise<void> done;
+
+private:
+    std::mutex mu;
+    std::vector<uint32_t> seen;
+};
+
+static CTransactionRef MakeTx(uint32_t n) {
+    CMutableTransaction mtx;
+    mtx.nLockTime = n;
+    return MakeTransactionRef(mtx);
+}
+
+static std::vector<uint32_t> Sequence(uint32_t n) {
+    std::vector<uint32_t> r;
+    for (uint32_t i = 0; i < n; ++i)
+        r.push_back(i);
+    return r;
+}
+
+static bool FindStats(const std::string & name, ValidationInterfaceQueueStats & stats) {
+    for (const auto & s : GetMainSignals().GetQueueStats()) {
+        if (s.name == name) {
+            stats = s;
+            return true;
+        }
+    }
+    return false;
+}
+
+BOOST_AUTO_TEST_CASE(validationinterface_queue_order)
+{
+    const uint32_t n = 200;
+    QueueTestSubscriber sub(n);
+    RegisterValidationInterface(&sub, "queuetest");
+
+    for (uint32_t i = 0; i < n; ++i)
+        GetMainSignals().TransactionAddedToMempool(MakeTx(i));
+    SyncWithValidationInterfaceQueue();
+
+    BOOST_CHECK(sub.Seen() == Sequence(n));
+    ValidationInterfaceQueueStats stats;
+    BOOST_CHECK(FindStats("queuetest", stats));
+    BOOST_CHECK_EQUAL(stats.processed, n);
+    BOOST_CHECK_EQUAL(stats.pending, 0U);
+    BOOST_CHECK(stats.maxLatency >= 0);
+
+    UnregisterValidationInterface(&sub);
+    BOOST_CHECK(!FindStats("queuetest", stats));
+}
+
+BOOST_AUTO_TEST_CASE(validationinterface_queue_slow_subscriber)
+{
+    // A second scheduler thread lets the queues run concurrently
+    threadGroup.create_thread(std::bind(&CScheduler::serviceQueue, &scheduler));
+
+    const uint32_t n = 100;
+    std::promise<void> release;
+    QueueTestSubscriber slow(n);
+    slow.gate = release.get_future().share();
+    QueueTestSubscriber fast(n);
+    RegisterValidationInterface(&slow, "slow");
+    RegisterValidationInterface(&fast, "fast");
+
+    for (uint32_t i = 0; i < n; ++i)
+        GetMainSignals().TransactionAddedToMempool(MakeTx(i));
+
+    // The fast subscriber gets all notifications while the slow one is stuck
+    // in its first callback
+    BOOST_CHECK(fast.done.get_future().wait_for(std::chrono::seconds(30)) == std::future_status::ready);
+    BOOST_CHECK(fast.Seen() == Sequence(n));
+    BOOST_CHECK(slow.Seen().empty());
+    ValidationInterfaceQueueStats stats;
+    BOOST_CHECK(FindStats("slow", stats));
+    BOOST_CHECK(stats.pending > 0);
+
+    release.set_value();
+    SyncWithValidationInterfaceQueue();
+    BOOST_CHECK(slow.Seen() == Sequence(n));
+
+    UnregisterValidationInterface(&slow);
+    UnregisterValidationInterface(&fast);
+}
+
+BOOST_AUTO_TEST_CASE(validationinterface_queue_unregister_drops_pending)
+{
+    const uint32_t n = 50;
+    std::promise<void> release;
+    QueueTestSubscriber sub(n);
+    sub.gate = release.get_future().share();
+    RegisterValidationInterface(&sub, "droptest");
+
+    for (uint32_t i = 0; i < n; ++i)
+        GetMainSignals().TransactionAddedToMempool(MakeTx(i));
+    BOOST_CHECK(sub.started.get_future().wait_for(std::chrono::seconds(30)) == std::future_status::ready);
+
+    // Callbacks still queued when the subscriber unregisters are dropped
+    UnregisterValidationInterface(&sub);
+    release.set_value();
+    SyncWithValidationInterfaceQueue();
+    BOOST_CHECK(sub.Seen() == Sequence(1));
+}
+
+BOOST_AUTO_TEST_CASE(validationinterface_queue_pending_longest)
+{
+    // Both subscribers are held in their first callback, with a single
+    // scheduler thread only one of them gets to run
+    const uint32_t n = 20;
+    std::promise<void> release;
+    QueueTestSubscriber a(n), b(n);
+    a.gate = b.gate = release.get_future().share();
+    RegisterValidationInterface(&a, "pendinga");
+    RegisterValidationInterface(&b, "pendingb");
+    auto startedA = a.started.get_future(), startedB = b.started.get_future();
+
+    for (uint32_t i = 0; i < n; ++i)
+        GetMainSignals().TransactionAddedToMempool(MakeTx(i));
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(30);
+    while (startedA.wait_for(std::chrono::milliseconds(10)) != std::future_status::ready &&
+           startedB.wait_for(std::chrono::milliseconds(0)) != std::future_status::ready &&
+           std::chrono::steady_clock::now() < deadline);
+
+    // The longest queue counts, not the sum of all queues
+    BOOST_CHECK_EQUAL(GetMainSignals().CallbacksPending(), n);
+
+    release.set_value();
+    SyncWithValidationInterfaceQueue();
+    BOOST_CHECK(a.Seen() == Sequence(n));
+    BOOST_CHECK(b.Seen() == Sequence(n));
+    UnregisterValidationInterface(&a);
+    UnregisterValidationInterface(&b);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -3,7 +3,13 @@
 // Distributed under the MIT software license, see the accompanying
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 #include <test/test_bitcoin.h>
+#include <key.h>
+#include <xbridge/util/timerwheel.h>
 #include <xbridge/util/xutil.h>
+#include <xbridge/xbridgedb.h>
+#include <xbridge/xbridgefeeledger.h>
+#include <xbridge/xbridgepacket.h>
+#include <util/system.h>
 #include <boost/test/unit_test.hpp>
 
 BOOST_FIXTURE_TEST_SUITE(xbridge_tests, BasicTestingSetup)
@@ -130,4 +136,228 @@ BOOST_AUTO_TEST_CASE(xbridge_pricecheck) {
     }
 }
 
+BOOST_AUTO_TEST_CASE(xbridge_packetsignature) {
+    CKey key; key.MakeNewKey(true);
+    const auto pubkey = key.GetPubKey();
+    const std::vector<unsigned char> vpubkey{pubkey.begin(), pubkey.end()};
+    const std::vector<unsigned char> vprivkey{key.begin(), key.end()};
+    CKey other; other.MakeNewKey(true);
+    const auto otherPubkey = other.GetPubKey();
+    const std::vector<unsigned char> votherPubkey{otherPubkey.begin(), otherPubkey.end()};
+
+    XBridgePacket packet(xbcPendingTransaction);
+    packet.append(std::vector<unsigned char>(64, 0x01));
+    BOOST_CHECK_MESSAGE(packet.sign(vpubkey, vprivkey), "packet should sign");
+    BOOST_CHECK_MESSAGE(packet.verify(), "signed packet should verify");
+    BOOST_CHECK_MESSAGE(packet.verify(), "signed packet should verify again from the cache");
+    BOOST_CHECK_MESSAGE(packet.verify(vpubkey), "signed packet should verify with its pubkey");
+    BOOST_CHECK_MESSAGE(!packet.verify(votherPubkey), "signed packet should not verify with another pubkey");
+
+    { // tampered body should fail even though the original was cached
+        XBridgePacket tampered(packet);
+        tampered.data()[0] = 0x02;
+        BOOST_CHECK_MESSAGE(!tampered.verify(), "tampered packet should not verify");
+    }
+    { // tampered signature should fail
+        std::vector<unsigned char> raw = packet.body();
+        raw[53] ^= 0x01;
+        XBridgePacket tampered;
+        BOOST_CHECK(tampered.copyFrom(raw));
+        BOOST_CHECK_MESSAGE(!tampered.verify(), "packet with a bad signature should not verify");
+    }
+    { // replaced pubkey should fail
+        std::vector<unsigned char> raw = packet.body();
+        std::copy(votherPubkey.begin(), votherPubkey.end(), raw.begin() + 20);
+        XBridgePacket tampered;
+        BOOST_CHECK(tampered.copyFrom(raw));
+        BOOST_CHECK_MESSAGE(!tampered.verify(), "packet with a replaced pubkey should not verify");
+    }
+}
+
+BOOST_AUTO_TEST_CASE(xbridge_timerwheel) {
+    const int64_t start = 1600000000;
+    xbridge::TimerWheel<int> wheel(start);
+    std::vector<int> expired;
+
+    // deadlines on every level of the wheel, beyond it and in the past
+    const std::vector<int64_t> deadlines{start - 5, start + 1, start + 255, start + 256, start + 300,
+                                         start + 60 * 6, start + 3600, start + 65536, start + 60 * 60 * 24 * 7,
+                                         start + (int64_t{1} << 25)};
+    for (int i = 0; i < static_cast<int>(deadlines.size()); ++i)
+        wheel.schedule(deadlines[i], i);
+    BOOST_CHECK_EQUAL(wheel.size(), deadlines.size());
+
+    wheel.advance(start, expired);
+    BOOST_CHECK(expired == std::vector<int>{0});
+
+    // items expire exactly at their deadline, never before
+    for (int i = 1; i < static_cast<int>(deadlines.size()); ++i) {
+        expired.clear();
+        wheel.advance(deadlines[i] - 1, expired);
+        BOOST_CHECK_MESSAGE(expired.empty(), strprintf("item %d expired early", i));
+        wheel.advance(deadlines[i], expired);
+        BOOST_CHECK_MESSAGE(expired == std::vector<int>{i}, strprintf("item %d should expire at its deadline", i));
+    }
+    BOOST_CHECK(wheel.empty());
+
+    // an empty wheel skips ahead, scheduling in the past expires on the next advance
+    wheel.advance(start + (int64_t{1} << 30), expired);
+    BOOST_CHECK_EQUAL(wheel.now(), start + (int64_t{1} << 30));
+    expired.clear();
+    wheel.schedule(wheel.now() - 1, 7);
+    wheel.schedule(wheel.now() + 1000, 8);
+    wheel.advance(wheel.now(), expired);
+    BOOST_CHECK(expired == std::vector<int>{7});
+    expired.clear();
+    wheel.advance(wheel.now() + 5000, expired);
+    BOOST_CHECK(expired == std::vector<int>{8});
+}
+
+BOOST_AUTO_TEST_CASE(xbridge_feeledger) {
+    xbridge::FeeLedger ledger;
+    const uint256 v1 = InsecureRand256();
+    const uint256 v2 = InsecureRand256();
+    BOOST_CHECK(!ledger.current(uint256()));
+    BOOST_CHECK(!ledger.current(v1));
+
+    const COutPoint a(InsecureRand256(), 0), b(InsecureRand256(), 1), c(InsecureRand256(), 2);
+    ledger.reset({{a, 1 * COIN}, {b, 2 * COIN}, {c, 4 * COIN}}, v1);
+    BOOST_CHECK(ledger.current(v1));
+    BOOST_CHECK(!ledger.current(v2));
+    BOOST_CHECK_EQUAL(ledger.available(), 7 * COIN);
+    BOOST_CHECK(ledger.canAfford(7 * COIN));
+    BOOST_CHECK(!ledger.canAfford(7 * COIN + 1));
+
+    // reservations are all or nothing
+    BOOST_CHECK(ledger.reserve({a, b}));
+    BOOST_CHECK_EQUAL(ledger.available(), 4 * COIN);
+    BOOST_CHECK(!ledger.reserve({c, b}));
+    BOOST_CHECK(!ledger.held(c));
+    BOOST_CHECK_EQUAL(ledger.available(), 4 * COIN);
+
+    // order locks are counted, outputs are available after the last release
+    ledger.hold({c});
+    ledger.hold({c});
+    BOOST_CHECK_EQUAL(ledger.available(), 0);
+    BOOST_CHECK(!ledger.reserve({c}));
+    ledger.release({c});
+    BOOST_CHECK(ledger.held(c));
+    BOOST_CHECK_EQUAL(ledger.available(), 0);
+    ledger.release({c});
+    BOOST_CHECK(!ledger.held(c));
+    BOOST_CHECK_EQUAL(ledger.available(), 4 * COIN);
+
+    // holds survive a rebuild, spent outputs leave the pool
+    const COutPoint d(InsecureRand256(), 3);
+    ledger.reset({{b, 2 * COIN}, {c, 4 * COIN}, {d, 8 * COIN}}, v2);
+    BOOST_CHECK(ledger.current(v2));
+    BOOST_CHECK_EQUAL(ledger.size(), 3U);
+    BOOST_CHECK_EQUAL(ledger.available(), 12 * COIN);
+    ledger.release({a, b});
+    BOOST_CHECK_EQUAL(ledger.available(), 14 * COIN);
+    ledger.release({a}); // not held
+    BOOST_CHECK_EQUAL(ledger.available(), 14 * COIN);
+
+    // chain and mempool updates, holds still apply
+    const COutPoint e(InsecureRand256(), 4);
+    const auto changes = ledger.changes();
+    ledger.add(e, 16 * COIN);
+    ledger.add(e, 16 * COIN); // known
+    BOOST_CHECK_EQUAL(ledger.available(), 30 * COIN);
+    ledger.spend(d);
+    BOOST_CHECK_EQUAL(ledger.available(), 22 * COIN);
+    ledger.add(d, 8 * COIN); // spent in the mempool
+    BOOST_CHECK_EQUAL(ledger.available(), 22 * COIN);
+    ledger.unspend(d);
+    BOOST_CHECK_EQUAL(ledger.available(), 30 * COIN);
+    ledger.hold({e});
+    ledger.spend(e);
+    ledger.remove(e);
+    ledger.unspend(e); // spent in a block
+    BOOST_CHECK_EQUAL(ledger.available(), 14 * COIN);
+    ledger.release({e});
+    BOOST_CHECK_EQUAL(ledger.available(), 14 * COIN);
+    ledger.remove(b);
+    BOOST_CHECK_EQUAL(ledger.size(), 2U);
+    BOOST_CHECK_EQUAL(ledger.available(), 12 * COIN);
+    BOOST_CHECK(ledger.current(v2));
+    BOOST_CHECK(ledger.changes() > changes);
+
+    ledger.invalidate();
+    BOOST_CHECK(!ledger.current(v2));
+}
+
+BOOST_AUTO_TEST_CASE(xbridge_ordersjournal) {
+    SetDataDir("xbridgedb");
+    ClearDatadirCache();
+    const fs::path pathJournal = GetDataDir() / "orders.log";
+
+    auto newOrder = [](const uint32_t watchBlock) -> xbridge::TransactionDescrPtr {
+        auto order = std::make_shared<xbridge::TransactionDescr>();
+        order->id = GetRandHash();
+        order->fromCurrency = "BLOCK";
+        order->fromAmount = 1000 * watchBlock;
+        order->setWatchBlock(watchBlock);
+        return order;
+    };
+    std::vector<xbridge::TransactionDescrPtr> orders{newOrder(1), newOrder(2), newOrder(3)};
+
+    { // appended records are replayed on top of the snapshot
+        xbridge::XBridgeDB db;
+        BOOST_CHECK(db.Create());
+        BOOST_CHECK(db.Write({orders[0], orders[1]}));
+        orders[0]->setWatchBlock(10); // only the first watch block is kept
+        orders[0]->fromAmount = 5;
+        BOOST_CHECK(db.Write({orders[0]}));
+        BOOST_CHECK(db.Write({orders[2]}));
+        BOOST_CHECK(!db.ShouldCompact());
+
+        xbridge::XOrderSet orderSet;
+        BOOST_CHECK(xbridge::XBridgeDB().Read(orderSet));
+        BOOST_CHECK_EQUAL(orderSet.size(), 3U);
+        for (const auto & order : orders) {
+            BOOST_CHECK(orderSet.count(order->id));
+            BOOST_CHECK_EQUAL(orderSet[order->id].fromAmount, order->fromAmount);
+            BOOST_CHECK_EQUAL(orderSet[order->id].getWatchStartBlock(), order->getWatchStartBlock());
+        }
+    }
+
+    { // a torn final record is dropped, the records before it are replayed
+        const auto size = fs::file_size(pathJournal);
+        fs::resize_file(pathJournal, size - 10);
+        xbridge::XOrderSet orderSet;
+        xbridge::XBridgeDB db;
+        BOOST_CHECK(db.Read(orderSet));
+        BOOST_CHECK_EQUAL(orderSet.size(), 2U);
+        BOOST_CHECK(orderSet.count(orders[0]->id) && orderSet.count(orders[1]->id));
+        BOOST_CHECK(!orderSet.count(orders[2]->id));
+        BOOST_CHECK_EQUAL(orderSet[orders[0]->id].fromAmount, 5);
+        // The intact records are folded into the snapshot and the damaged tail is gone
+        BOOST_CHECK_EQUAL(fs::file_size(pathJournal), 0U);
+
+        // New records are readable after the repair
+        BOOST_CHECK(db.Write({orders[2]}));
+        orderSet.clear();
+        BOOST_CHECK(xbridge::XBridgeDB().Read(orderSet));
+        BOOST_CHECK_EQUAL(orderSet.size(), 3U);
+    }
+
+    { // compaction merges the journal into the snapshot
+        xbridge::XBridgeDB db;
+        xbridge::XOrderSet orderSet;
+        BOOST_CHECK(db.Read(orderSet));
+        orders[1]->fromAmount = 7;
+        BOOST_CHECK(db.Write({orders[1]}));
+        BOOST_CHECK(fs::file_size(pathJournal) > 0U);
+        BOOST_CHECK(db.Compact());
+        BOOST_CHECK_EQUAL(fs::file_size(pathJournal), 0U);
+
+        orderSet.clear();
+        BOOST_CHECK(xbridge::XBridgeDB().Read(orderSet));
+        BOOST_CHECK_EQUAL(orderSet.size(), 3U);
+        BOOST_CHECK_EQUAL(orderSet[orders[1]->id].fromAmount, 7);
+        BOOST_CHECK_EQUAL(orderSet[orders[0]->id].getWatchStartBlock(), 1U);
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
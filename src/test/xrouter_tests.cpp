@@ -3,6 +3,8 @@
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
 #include <test/xrouter_tests.h>
+#include <test/test_bitcoin.h>
+#include <xrouter/xrouterconfigcache.h>
 #include <boost/test/unit_test.hpp>
 
 XRouterTestClient::XRouterTestClient() {
@@ -27,6 +29,57 @@ BOOST_AUTO_TEST_SUITE(xrouter_tests)
 BOOST_AUTO_TEST_CASE(xrouter_tests_default) {
 }
 
+BOOST_FIXTURE_TEST_CASE(xrouter_tests_configcache, BasicTestingSetup) {
+    const auto path = SetDataDir("xrouter_configcache") / "xrouterconfigs.dat";
+    CKey key1; key1.MakeNewKey(true);
+    CKey key2; key2.MakeNewKey(true);
+    const auto snode1 = key1.GetPubKey();
+    const auto snode2 = key2.GetPubKey();
+    const auto v1 = uint256S("0x01");
+    const auto v2 = uint256S("0x02");
+    const std::string reply1{R"({"config":"[Main]\nfee=0","plugins":{}})"};
+    const std::string reply2{R"({"config":"[Main]\nfee=0.1","plugins":{}})"};
+    std::string reply;
+
+    xrouter::XRouterConfigCache cache(path);
+    BOOST_CHECK_MESSAGE(!cache.load(), "Missing cache file should not load");
+    cache.put(snode1, v1, reply1);
+    cache.put(snode2, v1, reply2);
+    BOOST_CHECK_EQUAL(cache.size(), 2);
+    BOOST_CHECK(cache.get(snode1, v1, reply));
+    BOOST_CHECK_EQUAL(reply, reply1);
+
+    // Persisted entries survive a restart
+    BOOST_CHECK(cache.save());
+    {
+        xrouter::XRouterConfigCache loaded(path);
+        BOOST_CHECK(loaded.load());
+        BOOST_CHECK_EQUAL(loaded.size(), 2);
+        BOOST_CHECK(loaded.get(snode2, v1, reply));
+        BOOST_CHECK_EQUAL(reply, reply2);
+    }
+
+    // Entries for an older config version are dropped
+    BOOST_CHECK_MESSAGE(!cache.get(snode1, v2, reply), "Stale config version should not be returned");
+    BOOST_CHECK_EQUAL(cache.size(), 1);
+    BOOST_CHECK(!cache.get(snode1, v1, reply));
+    cache.erase(snode2);
+    BOOST_CHECK_EQUAL(cache.size(), 0);
+
+    // Corrupt caches are discarded
+    BOOST_CHECK(cache.save());
+    {
+        FILE *file = fsbridge::fopen(path, "r+b");
+        BOOST_CHECK(file != nullptr);
+        fseek(file, 6, SEEK_SET);
+        fputc(0x7f, file);
+        fclose(file);
+    }
+    xrouter::XRouterConfigCache corrupt(path);
+    BOOST_CHECK_MESSAGE(!corrupt.load(), "Corrupt cache should not load");
+    BOOST_CHECK_EQUAL(corrupt.size(), 0);
+}
+
 #ifdef USE_XROUTERCLIENT
 
 BOOST_FIXTURE_TEST_CASE(xrouter_tests_waitforservice, XRouterTestClientTestnet) {
@@ -10,6 +10,7 @@
 #include <random.h>
 #include <pow.h>
 #include <shutdown.h>
+#include <streams.h>
 #include <uint256.h>
 #include <util/system.h>
 #include <ui_interface.h>
@@ -182,6 +183,31 @@ bool CBlockTreeDB::ReadLastBlockFile(int &nFile) {
     return Read(DB_LAST_BLOCK, nFile);
 }
 
+bool WriteUTXOSnapshot(CAutoFile& file, CCoinsViewCursor& cursor, const CUTXOSnapshotMetadata& metadata, uint256& hash)
+{
+    CHashWriter ss(SER_GETHASH, PROTOCOL_VERSION);
+    ss << metadata;
+    file << metadata;
+
+    uint64_t written = 0;
+    COutPoint outpoint;
+    Coin coin;
+    for (; cursor.Valid(); cursor.Next()) {
+        if (ShutdownRequested())
+            return error("%s: interrupted", __func__);
+        if (!cursor.GetKey(outpoint) || !cursor.GetValue(coin))
+            return error("%s: unable to read value", __func__);
+        ss << outpoint << coin;
+        file << outpoint << coin;
+        ++written;
+    }
+    if (written != metadata.coins_count)
+        return error("%s: wrote %u coins, expected %u", __func__, written, metadata.coins_count);
+
+    hash = ss.GetHash();
+    return true;
+}
+
 CCoinsViewCursor *CCoinsViewDB::Cursor() const
 {
     CCoinsViewDBCursor *i = new CCoinsViewDBCursor(const_cast<CDBWrapper&>(db).NewIterator(), GetBestBlock());
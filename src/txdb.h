@@ -17,6 +17,7 @@
 #include <utility>
 #include <vector>
 
+class CAutoFile;
 class CBlockIndex;
 class CCoinsViewDBCursor;
 class uint256;
@@ -42,6 +43,28 @@ static const int64_t nMaxCoinsDBCache = 32;
 //! Max memory allocated to governance cache (MiB)
 static const int64_t nMaxGovDBCache = 16;
 
+/** Header of a UTXO set snapshot file. */
+class CUTXOSnapshotMetadata
+{
+public:
+    //! Hash of the block whose UTXO set the snapshot holds.
+    uint256 base_blockhash;
+    //! Number of coins in the snapshot.
+    uint64_t coins_count = 0;
+
+    CUTXOSnapshotMetadata() {}
+    CUTXOSnapshotMetadata(const uint256& base_blockhash, uint64_t coins_count) :
+        base_blockhash(base_blockhash), coins_count(coins_count) {}
+
+    ADD_SERIALIZE_METHODS;
+
+    template <typename Stream, typename Operation>
+    inline void SerializationOp(Stream& s, Operation ser_action) {
+        READWRITE(base_blockhash);
+        READWRITE(coins_count);
+    }
+};
+
 /** CCoinsView backed by the coin database (chainstate/) */
 class CCoinsViewDB final : public CCoinsView
 {
@@ -62,6 +85,9 @@ public:
     size_t EstimateSize() const override;
 };
 
+/** Write the metadata and the coins visible to cursor to file, returning the snapshot hash. */
+bool WriteUTXOSnapshot(CAutoFile& file, CCoinsViewCursor& cursor, const CUTXOSnapshotMetadata& metadata, uint256& hash);
+
 /** Specialization of CCoinsViewCursor to iterate over a CCoinsViewDB */
 class CCoinsViewDBCursor: public CCoinsViewCursor
 {
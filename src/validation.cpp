@@ -48,7 +48,9 @@
 #include <warnings.h>
 
 #include <future>
+#include <list>
 #include <sstream>
+#include <unordered_map>
 
 #include <boost/algorithm/string/replace.hpp>
 #include <boost/thread.hpp>
@@ -247,6 +249,7 @@ size_t nCoinCacheUsage = 5000 * 300;
 uint64_t nPruneTarget = 0;
 int64_t nMaxTipAge = DEFAULT_MAX_TIP_AGE;
 bool fEnableReplacement = DEFAULT_ENABLE_REPLACEMENT;
+std::atomic<unsigned int> nRawBlockCacheSize{DEFAULT_RAW_BLOCK_CACHE_SIZE};
 std::atomic<double> meanBlockHeightConnectedNodes{-1};
 std::atomic<int> estimatedConnectedNodes{0};
 
@@ -325,6 +328,7 @@ static bool FlushStateToDisk(const CChainParams& chainParams, CValidationState &
 static void FindFilesToPruneManual(std::set<int>& setFilesToPrune, int nManualPruneHeight);
 static void FindFilesToPrune(std::set<int>& setFilesToPrune, uint64_t nPruneAfterHeight);
 bool CheckInputs(const CTransaction& tx, CValidationState &state, const CCoinsViewCache &inputs, bool fScriptChecks, unsigned int flags, bool cacheSigStore, bool cacheFullScriptStore, PrecomputedTransactionData& txdata, std::vector<CScriptCheck> *pvChecks = nullptr);
+static bool CheckInputsParallel(const CTransaction& tx, CValidationState &state, const CCoinsViewCache &inputs, unsigned int flags, bool cacheSigStore, PrecomputedTransactionData& txdata) EXCLUSIVE_LOCKS_REQUIRED(cs_main);
 static FILE* OpenUndoFile(const CDiskBlockPos &pos, bool fReadOnly = false);
 
 bool CheckFinalTx(const CTransaction &tx, int flags)
@@ -917,7 +921,7 @@ static bool AcceptToMemoryPoolWorker(const CChainParams& chainparams, CTxMemPool
         // Check against previous transactions
         // This is done last to help prevent CPU exhaustion denial-of-service attacks.
         PrecomputedTransactionData txdata(tx);
-        if (!CheckInputs(tx, state, view, true, scriptVerifyFlags, true, false, txdata)) {
+        if (!CheckInputsParallel(tx, state, view, scriptVerifyFlags, true, txdata)) {
             // SCRIPT_VERIFY_CLEANSTACK requires SCRIPT_VERIFY_WITNESS, so we
             // need to turn both off, and compare against just turning off CLEANSTACK
             // to see if the failure is specifically due to witness validation.
@@ -1178,6 +1182,105 @@ bool ReadRawBlockFromDisk(std::vector<uint8_t>& block, const CBlockIndex* pindex
     return ReadRawBlockFromDisk(block, block_pos, message_start);
 }
 
+namespace {
+/**
+ * Least recently used cache of raw blocks that were recently served to peers,
+ * REST/RPC clients or zmq subscribers. Many peers and indexers tend to request
+ * the same (usually recent) blocks, so keeping the disk bytes around avoids
+ * repeated file reads and block deserialization.
+ */
+class RawBlockCache
+{
+private:
+    typedef std::list<std::pair<uint256, CRawBlockRef>> EntryList;
+    Mutex m_mutex;
+    EntryList m_entries GUARDED_BY(m_mutex);
+    std::unordered_map<uint256, EntryList::iterator, BlockHasher> m_index GUARDED_BY(m_mutex);
+
+public:
+    CRawBlockRef Get(const uint256& hash)
+    {
+        LOCK(m_mutex);
+        auto it = m_index.find(hash);
+        if (it == m_index.end())
+            return nullptr;
+        m_entries.splice(m_entries.begin(), m_entries, it->second);
+        return it->second->second;
+    }
+
+    void Put(const uint256& hash, const CRawBlockRef& block, const unsigned int maxSize)
+    {
+        LOCK(m_mutex);
+        if (maxSize == 0 || m_index.count(hash))
+            return;
+        m_entries.emplace_front(hash, block);
+        m_index[hash] = m_entries.begin();
+        while (m_entries.size() > maxSize) {
+            m_index.erase(m_entries.back().first);
+            m_entries.pop_back();
+        }
+    }
+
+    void Clear()
+    {
+        LOCK(m_mutex);
+        m_index.clear();
+        m_entries.clear();
+    }
+};
+
+RawBlockCache g_raw_block_cache;
+} // anon namespace
+
+bool ReadRawBlockFromDiskCached(CRawBlockRef& block, const CBlockIndex* pindex, const CMessageHeader::MessageStartChars& message_start)
+{
+    const uint256 hash = pindex->GetBlockHash();
+    block = g_raw_block_cache.Get(hash);
+    if (block)
+        return true;
+
+    auto rawBlock = std::make_shared<CRawBlock>();
+    if (!ReadRawBlockFromDisk(rawBlock->data, pindex, message_start))
+        return false;
+
+    // Determine once whether the bytes can be relayed as-is to consumers
+    // that do not want witness data.
+    try {
+        CBlock blk;
+        VectorReader(SER_NETWORK, PROTOCOL_VERSION, rawBlock->data, 0) >> blk;
+        if (blk.GetHash() != hash)
+            return error("%s: GetHash() doesn't match index for %s", __func__, pindex->ToString());
+        rawBlock->fHasWitness = std::any_of(blk.vtx.begin(), blk.vtx.end(), [](const CTransactionRef & tx) {
+            return tx->HasWitness();
+        });
+    } catch (const std::exception& e) {
+        return error("%s: Deserialize error - %s for %s", __func__, e.what(), pindex->ToString());
+    }
+
+    block = rawBlock;
+    g_raw_block_cache.Put(hash, block, nRawBlockCacheSize);
+    return true;
+}
+
+bool ReadBlockFromDiskCached(CBlock& block, const CBlockIndex* pindex, const CMessageHeader::MessageStartChars& message_start)
+{
+    block.SetNull();
+    CRawBlockRef rawBlock;
+    if (!ReadRawBlockFromDiskCached(rawBlock, pindex, message_start))
+        return false;
+    try {
+        VectorReader(SER_NETWORK, PROTOCOL_VERSION, rawBlock->data, 0) >> block;
+    } catch (const std::exception& e) {
+        return error("%s: Deserialize error - %s for %s", __func__, e.what(), pindex->ToString());
+    }
+    return true;
+}
+
+void ClearRawBlockCache()
+{
+    g_raw_block_cache.Clear();
+}
+
 CAmount GetBlockSubsidy(int nHeight, const Consensus::Params& consensusParams)
 {
     return consensusParams.GetBlockSubsidy(nHeight, consensusParams);
@@ -1704,6 +1807,28 @@ void ThreadScriptCheck() {
     scriptcheckqueue.Thread();
 }
 
+/**
+ * CheckInputs for mempool acceptance. Transactions with many inputs (vote batches,
+ * snode input splits, xbridge transactions) have their scripts verified on the
+ * script check threads. The queue is only used under cs_main, same as in
+ * ConnectBlock. A failure is checked again serially so that state gets the
+ * reject reason the caller depends on.
+ */
+static bool CheckInputsParallel(const CTransaction& tx, CValidationState &state, const CCoinsViewCache &inputs, unsigned int flags, bool cacheSigStore, PrecomputedTransactionData& txdata) EXCLUSIVE_LOCKS_REQUIRED(cs_main)
+{
+    if (!nScriptCheckThreads || tx.vin.size() < MEMPOOL_PARALLEL_SCRIPT_CHECK_INPUTS)
+        return CheckInputs(tx, state, inputs, true, flags, cacheSigStore, false, txdata);
+
+    std::vector<CScriptCheck> vChecks;
+    if (!CheckInputs(tx, state, inputs, true, flags, cacheSigStore, false, txdata, &vChecks))
+        return false;
+    CCheckQueueControl<CScriptCheck> control(&scriptcheckqueue);
+    control.Add(vChecks);
+    if (control.Wait())
+        return true;
+    return CheckInputs(tx, state, inputs, true, flags, cacheSigStore, false, txdata);
+}
+
 VersionBitsCache versionbitscache GUARDED_BY(cs_main);
 
 int32_t ComputeBlockVersion(const CBlockIndex* pindexPrev, const Consensus::Params& params)
@@ -2953,16 +3078,17 @@ CBlockIndex* CChainState::AddToBlockIndex(const CBlockHeader& block)
         pindexNew->SetStakeEntropyBit(ebit);
         if (IsProofOfStake(pindexNew->nHeight)) {
             pindexNew->SetProofOfStake();
-            if (HasHashProofOfStake(hash))
+            if (HasHashProofOfStake(hash)) {
                 pindexNew->hashProofOfStake = GetHashProofOfStake(hash);
-            else {
+                RemoveHashProofOfStake(hash); // persisted with the block index from here on
+            } else {
                 uint256 hashProofOfStake;
                 if (!CheckProofOfStake(block, pindexNew->pprev, hashProofOfStake, Params().GetConsensus()))
                     LogPrint(BCLog::ALL, "AddToBlockIndex() : CheckProofOfStake failed\n");
                 pindexNew->hashProofOfStake = hashProofOfStake;
-                SetHashProofOfStake(block.GetHash(), hashProofOfStake);
             }
         }
+        PruneHashProofOfStake(chainActive.Height());
 
         // ppcoin: compute stake modifier
         uint64_t stakeModifier = 0;
@@ -3139,8 +3265,13 @@ static bool CheckBlockHeader(const CBlockHeader& block, CValidationState& state,
     uint256 blockHash = block.GetHash();
     uint256 hashProofOfStake;
     bool valid = CheckPoS(block, state, hashProofOfStake, consensusParams);
-    if (valid && !HasHashProofOfStake(blockHash))
-        SetHashProofOfStake(blockHash, hashProofOfStake);
+    if (valid && !HasHashProofOfStake(blockHash)) {
+        LOCK(cs_main);
+        if (!LookupBlockIndex(blockHash)) { // otherwise already stored on the block index
+            const CBlockIndex *pindexPrev = LookupBlockIndex(block.hashPrevBlock);
+            SetHashProofOfStake(blockHash, hashProofOfStake, pindexPrev ? pindexPrev->nHeight + 1 : chainActive.Height());
+        }
+    }
     return valid;
 }
 
@@ -4524,6 +4655,7 @@ void UnloadBlockIndex()
     for (int b = 0; b < VERSIONBITS_NUM_BITS; b++) {
         warningcache[b].clear();
     }
+    ClearRawBlockCache();
 
     for (const BlockMap::value_type& entry : mapBlockIndex) {
         delete entry.second;
@@ -5177,19 +5309,65 @@ int GetChainTipHeight() {
     return chainActive.Height();
 }
 
+/**
+ * Kernel hashes of blocks that passed CheckBlockHeader, kept until the block is
+ * added to the block index (which persists the hash in its disk record). Blocks
+ * that never make it into the index are evicted once they are buried deeper
+ * than POS_HASH_CACHE_DEPTH below the tip, or when the cache is full.
+ */
+struct ProofOfStakeEntry {
+    uint256 hashProofOfStake;
+    int nHeight;
+};
 Mutex muMapProofOfStake;
-std::map<uint256, uint256> mapProofOfStake;
+std::unordered_map<uint256, ProofOfStakeEntry, BlockHasher> mapProofOfStake GUARDED_BY(muMapProofOfStake);
+std::multimap<int, uint256> mapProofOfStakeByHeight GUARDED_BY(muMapProofOfStake);
+
+static void EraseHashProofOfStake(std::unordered_map<uint256, ProofOfStakeEntry, BlockHasher>::iterator it) EXCLUSIVE_LOCKS_REQUIRED(muMapProofOfStake) {
+    auto range = mapProofOfStakeByHeight.equal_range(it->second.nHeight);
+    for (auto hit = range.first; hit != range.second; ++hit) {
+        if (hit->second == it->first) {
+            mapProofOfStakeByHeight.erase(hit);
+            break;
+        }
+    }
+    mapProofOfStake.erase(it);
+}
+
 uint256 GetHashProofOfStake(const uint256 & blockHash) {
     LOCK(muMapProofOfStake);
-    if (mapProofOfStake.count(blockHash))
-        return mapProofOfStake[blockHash];
+    auto it = mapProofOfStake.find(blockHash);
+    if (it != mapProofOfStake.end())
+        return it->second.hashProofOfStake;
     return {};
 }
 bool HasHashProofOfStake(const uint256 & blockHash) {
     LOCK(muMapProofOfStake);
     return mapProofOfStake.count(blockHash) > 0;
 }
-void SetHashProofOfStake(const uint256 & blockHash, const uint256 & hashProofOfStake) {
+void SetHashProofOfStake(const uint256 & blockHash, const uint256 & hashProofOfStake, const int nHeight) {
+    LOCK(muMapProofOfStake);
+    auto it = mapProofOfStake.find(blockHash);
+    if (it != mapProofOfStake.end())
+        EraseHashProofOfStake(it);
+    // Make room by evicting the deepest entries first
+    while (mapProofOfStake.size() >= MAX_POS_HASH_CACHE_SIZE && !mapProofOfStakeByHeight.empty())
+        EraseHashProofOfStake(mapProofOfStake.find(mapProofOfStakeByHeight.begin()->second));
+    mapProofOfStake[blockHash] = {hashProofOfStake, nHeight};
+    mapProofOfStakeByHeight.emplace(nHeight, blockHash);
+}
+void RemoveHashProofOfStake(const uint256 & blockHash) {
+    LOCK(muMapProofOfStake);
+    auto it = mapProofOfStake.find(blockHash);
+    if (it != mapProofOfStake.end())
+        EraseHashProofOfStake(it);
+}
+void PruneHashProofOfStake(const int nTipHeight) {
+    LOCK(muMapProofOfStake);
+    while (!mapProofOfStakeByHeight.empty() && mapProofOfStakeByHeight.begin()->first < nTipHeight - POS_HASH_CACHE_DEPTH)
+        EraseHashProofOfStake(mapProofOfStake.find(mapProofOfStakeByHeight.begin()->second));
+}
+size_t HashProofOfStakeCacheSize() {
     LOCK(muMapProofOfStake);
-    mapProofOfStake[blockHash] = hashProofOfStake;
+    return mapProofOfStake.size();
 }
\ No newline at end of file
@@ -86,6 +86,8 @@ static const unsigned int UNDOFILE_CHUNK_SIZE = 0x100000; // 1 MiB
 static const int MAX_SCRIPTCHECK_THREADS = 16;
 /** -par default (number of script-checking threads, 0 = auto) */
 static const int DEFAULT_SCRIPTCHECK_THREADS = 0;
+/** Scripts of mempool transactions with at least this many inputs are checked on the script-checking threads */
+static const unsigned int MEMPOOL_PARALLEL_SCRIPT_CHECK_INPUTS = 8;
 /** Number of blocks that can be requested at any given time from a single peer. */
 static const int MAX_BLOCKS_IN_TRANSIT_PER_PEER = 64;
 /** Timeout in seconds during which a peer must stall block download progress before being disconnected. */
@@ -140,6 +142,8 @@ static const bool DEFAULT_PEERBLOOMFILTERS = true;
 
 /** Default for -stopatheight */
 static const int DEFAULT_STOPATHEIGHT = 0;
+/** Default for -rawblockcache, the number of recently served raw blocks kept in memory */
+static const unsigned int DEFAULT_RAW_BLOCK_CACHE_SIZE = 32;
 
 struct BlockHasher
 {
@@ -176,6 +180,8 @@ extern CAmount maxTxFee;
 /** If the tip is older than this (in seconds), the node is considered to be in initial block download. */
 extern int64_t nMaxTipAge;
 extern bool fEnableReplacement;
+/** Maximum number of raw blocks held by the recently served block cache. */
+extern std::atomic<unsigned int> nRawBlockCacheSize;
 
 /** Block hash whose ancestors we will assume to have valid scripts without checking them. */
 extern uint256 hashAssumeValid;
@@ -406,6 +412,27 @@ bool ReadBlockFromDisk(CBlock& block, const CBlockIndex* pindex, const Consensus
 bool ReadRawBlockFromDisk(std::vector<uint8_t>& block, const CDiskBlockPos& pos, const CMessageHeader::MessageStartChars& message_start);
 bool ReadRawBlockFromDisk(std::vector<uint8_t>& block, const CBlockIndex* pindex, const CMessageHeader::MessageStartChars& message_start);
 
+/** Serialized block exactly as stored on disk (network format, witness data included). */
+struct CRawBlock {
+    std::vector<uint8_t> data;
+    /** True if any transaction carries witness data, i.e. the bytes differ from the no-witness serialization */
+    bool fHasWitness{false};
+};
+typedef std::shared_ptr<const CRawBlock> CRawBlockRef;
+
+/**
+ * Read a raw block through the cache of recently served blocks (see -rawblockcache).
+ * Consumers that only relay bytes (getdata, REST, getblock verbosity 0, zmq) should
+ * prefer this over ReadBlockFromDisk to avoid a deserialize/serialize round trip and
+ * the proof-of-stake re-check. The block data is assumed valid since it was accepted
+ * into the block index.
+ */
+bool ReadRawBlockFromDiskCached(CRawBlockRef& block, const CBlockIndex* pindex, const CMessageHeader::MessageStartChars& message_start);
+/** Deserialize a block from the raw block cache, checking only that its hash matches the index. */
+bool ReadBlockFromDiskCached(CBlock& block, const CBlockIndex* pindex, const CMessageHeader::MessageStartChars& message_start);
+/** Drop all entries from the raw block cache. */
+void ClearRawBlockCache();
+
 /** Functions for validating blocks and updating the block tree */
 
 /** Context-independent validity checks */
@@ -553,9 +580,19 @@ bool IsServiceNodeBlockValidFunc(const uint64_t & blockNumber, const uint256 & b
  */
 extern int GetChainTipHeight();
 
-/** hashProofOfStake management */
+/**
+ * hashProofOfStake management. Kernel hashes computed during header checks are
+ * cached until the block is added to the block index, which stores the hash
+ * in the block index record on disk.
+ */
+static const int POS_HASH_CACHE_DEPTH = 100; // evict cached kernel hashes buried deeper than this below the tip
+static const size_t MAX_POS_HASH_CACHE_SIZE = 5000;
 uint256 GetHashProofOfStake(const uint256 & blockHash);
 bool HasHashProofOfStake(const uint256 & blockHash);
-void SetHashProofOfStake(const uint256 & blockHash, const uint256 & hashProofOfStake);
+void SetHashProofOfStake(const uint256 & blockHash, const uint256 & hashProofOfStake, int nHeight);
+void RemoveHashProofOfStake(const uint256 & blockHash);
+/** Evicts the kernel hashes of blocks buried deeper than POS_HASH_CACHE_DEPTH */
+void PruneHashProofOfStake(int nTipHeight);
+size_t HashProofOfStakeCacheSize();
 
 #endif // BITCOIN_VALIDATION_H
@@ -9,49 +9,134 @@
 #include <scheduler.h>
 #include <txmempool.h>
 #include <util/system.h>
+#include <util/time.h>
 #include <validation.h>
 
+#include <algorithm>
 #include <list>
 #include <atomic>
 #include <future>
+#include <unordered_map>
 #include <utility>
 
 #include <boost/signals2/signal.hpp>
 
 struct ValidationInterfaceConnections {
-    boost::signals2::scoped_connection UpdatedBlockTip;
-    boost::signals2::scoped_connection TransactionAddedToMempool;
-    boost::signals2::scoped_connection BlockConnected;
-    boost::signals2::scoped_connection BlockDisconnected;
-    boost::signals2::scoped_connection TransactionRemovedFromMempool;
-    boost::signals2::scoped_connection ChainStateFlushed;
     boost::signals2::scoped_connection Broadcast;
     boost::signals2::scoped_connection BlockChecked;
     boost::signals2::scoped_connection NewPoWValidBlock;
 };
 
+/**
+ * Ordered callback queue of a single validation interface subscriber.
+ * Callbacks of one subscriber run in order, callbacks of different
+ * subscribers are serviced concurrently by the scheduler threads.
+ */
+struct ValidationInterfaceQueue {
+    CValidationInterface* iface; // requires m_queues_mutex to change
+    std::string name;
+    SingleThreadedSchedulerClient client;
+    std::atomic<bool> registered{true};
+    // Callbacks queued for an earlier registration are dropped
+    std::atomic<uint64_t> generation{0};
+
+    std::atomic<uint64_t> processed{0};
+    std::atomic<int64_t> totalLatency{0}; // microseconds from enqueue to completion
+    std::atomic<int64_t> maxLatency{0};
+    std::atomic<int64_t> totalRunTime{0}; // microseconds spent in callbacks
+
+    explicit ValidationInterfaceQueue(CValidationInterface* ifaceIn, CScheduler* pscheduler) : iface(ifaceIn), client(pscheduler) {}
+
+    /** Queue a callback on the subscriber, recording its latency */
+    void Add(std::function<void (CValidationInterface*)> func) {
+        const uint64_t gen = generation;
+        const int64_t queued = GetTimeMicros();
+        client.AddToProcessQueue([this, gen, queued, func] {
+            if (generation != gen)
+                return;
+            const int64_t started = GetTimeMicros();
+            func(iface);
+            const int64_t done = GetTimeMicros();
+            const int64_t latency = done - queued;
+            ++processed;
+            totalLatency += latency;
+            totalRunTime += done - started;
+            int64_t prev = maxLatency;
+            while (latency > prev && !maxLatency.compare_exchange_weak(prev, latency));
+        });
+    }
+};
+
 struct MainSignalsInstance {
-    boost::signals2::signal<void (const CBlockIndex *, const CBlockIndex *, bool fInitialDownload)> UpdatedBlockTip;
-    boost::signals2::signal<void (const CTransactionRef &)> TransactionAddedToMempool;
-    boost::signals2::signal<void (const std::shared_ptr<const CBlock> &, const CBlockIndex *pindex, const std::vector<CTransactionRef>&)> BlockConnected;
-    boost::signals2::signal<void (const std::shared_ptr<const CBlock> &)> BlockDisconnected;
-    boost::signals2::signal<void (const CTransactionRef &)> TransactionRemovedFromMempool;
-    boost::signals2::signal<void (const CBlockLocator &)> ChainStateFlushed;
     boost::signals2::signal<void (int64_t nBestBlockTime, CConnman* connman)> Broadcast;
     boost::signals2::signal<void (const CBlock&, const CValidationState&)> BlockChecked;
     boost::signals2::signal<void (const CBlockIndex *, const std::shared_ptr<const CBlock>&)> NewPoWValidBlock;
 
+    CScheduler *m_pscheduler;
     // We are not allowed to assume the scheduler only runs in one thread,
     // but must ensure all callbacks happen in-order, so we end up creating
     // our own queue here :(
     SingleThreadedSchedulerClient m_schedulerClient;
     std::unordered_map<CValidationInterface*, ValidationInterfaceConnections> m_connMainSignals;
 
-    explicit MainSignalsInstance(CScheduler *pscheduler) : m_schedulerClient(pscheduler) {}
+    Mutex m_queues_mutex;
+    std::unordered_map<CValidationInterface*, std::unique_ptr<ValidationInterfaceQueue>> m_queues GUARDED_BY(m_queues_mutex);
+    // Drained queues of unregistered subscribers, reused by the next
+    // registration. They are only freed in UnregisterBackgroundSignalScheduler
+    // because the scheduler may still hold references to them.
+    std::vector<std::unique_ptr<ValidationInterfaceQueue>> m_idle_queues GUARDED_BY(m_queues_mutex);
+
+    explicit MainSignalsInstance(CScheduler *pscheduler) : m_pscheduler(pscheduler), m_schedulerClient(pscheduler) {}
+
+    /** Returns the queues of all currently registered subscribers */
+    std::vector<ValidationInterfaceQueue*> Subscribers() {
+        std::vector<ValidationInterfaceQueue*> r;
+        LOCK(m_queues_mutex);
+        r.reserve(m_queues.size());
+        for (auto & item : m_queues) {
+            if (item.second->registered)
+                r.push_back(item.second.get());
+        }
+        return r;
+    }
+
+    /** Returns all queues, including the ones of unregistered subscribers */
+    std::vector<SingleThreadedSchedulerClient*> Clients() {
+        std::vector<SingleThreadedSchedulerClient*> r{&m_schedulerClient};
+        LOCK(m_queues_mutex);
+        for (auto & item : m_queues)
+            r.push_back(&item.second->client);
+        return r;
+    }
+
+    /** Queue the callback on every registered subscriber */
+    void AddToProcessQueues(const std::function<void (CValidationInterface*)> & func) {
+        for (auto q : Subscribers())
+            q->Add(func);
+    }
 };
 
 static CMainSignals g_signals;
 
+static void UnregisterQueue(MainSignalsInstance & internals, ValidationInterfaceQueue & q) EXCLUSIVE_LOCKS_REQUIRED(internals.m_queues_mutex) {
+    q.registered = false;
+    const uint64_t gen = ++q.generation; // drop callbacks that are still pending
+    // Once the dropped callbacks have drained, move the queue out of m_queues
+    // unless the subscriber registered again in the meantime.
+    MainSignalsInstance* pinternals = &internals;
+    ValidationInterfaceQueue* pq = &q;
+    q.client.AddToProcessQueue([pinternals, pq, gen] {
+        LOCK(pinternals->m_queues_mutex);
+        if (pq->generation != gen)
+            return;
+        auto it = pinternals->m_queues.find(pq->iface);
+        if (it == pinternals->m_queues.end() || it->second.get() != pq)
+            return;
+        pinternals->m_idle_queues.push_back(std::move(it->second));
+        pinternals->m_queues.erase(it);
+    });
+}
+
 // This map has to a separate global instead of a member of MainSignalsInstance,
 // because RegisterWithMempoolSignals is currently called before RegisterBackgroundSignalScheduler,
 // so MainSignalsInstance hasn't been created yet.
@@ -63,18 +148,49 @@ void CMainSignals::RegisterBackgroundSignalScheduler(CScheduler& scheduler) {
 }
 
 void CMainSignals::UnregisterBackgroundSignalScheduler() {
+    if (m_internals) {
+        // Drop the callbacks that are still queued and free the subscriber
+        // queues. The scheduler threads have to be stopped at this point.
+        LOCK(m_internals->m_queues_mutex);
+        for (auto & item : m_internals->m_queues) {
+            item.second->registered = false;
+            ++item.second->generation;
+        }
+        m_internals->m_queues.clear();
+        m_internals->m_idle_queues.clear();
+    }
     m_internals.reset(nullptr);
 }
 
 void CMainSignals::FlushBackgroundCallbacks() {
     if (m_internals) {
-        m_internals->m_schedulerClient.EmptyQueue();
+        for (auto client : m_internals->Clients())
+            client->EmptyQueue();
     }
 }
 
 size_t CMainSignals::CallbacksPending() {
     if (!m_internals) return 0;
-    return m_internals->m_schedulerClient.CallbacksPending();
+    size_t pending{0};
+    for (auto client : m_internals->Clients())
+        pending = std::max(pending, client->CallbacksPending());
+    return pending;
+}
+
+std::vector<ValidationInterfaceQueueStats> CMainSignals::GetQueueStats() {
+    std::vector<ValidationInterfaceQueueStats> r;
+    if (!m_internals) return r;
+    for (auto q : m_internals->Subscribers()) {
+        ValidationInterfaceQueueStats stats;
+        stats.name = q->name;
+        stats.pending = q->client.CallbacksPending();
+        stats.processed = q->processed;
+        stats.totalLatency = q->totalLatency;
+        stats.maxLatency = q->maxLatency;
+        stats.totalRunTime = q->totalRunTime;
+        r.push_back(stats);
+    }
+    return r;
 }
 
 void CMainSignals::RegisterWithMempoolSignals(CTxMemPool& pool) {
@@ -93,22 +209,40 @@ CMainSignals& GetMainSignals()
     return g_signals;
 }
 
-void RegisterValidationInterface(CValidationInterface* pwalletIn) {
+void RegisterValidationInterface(CValidationInterface* pwalletIn, const std::string& name) {
     ValidationInterfaceConnections& conns = g_signals.m_internals->m_connMainSignals[pwalletIn];
-    conns.UpdatedBlockTip = g_signals.m_internals->UpdatedBlockTip.connect(std::bind(&CValidationInterface::UpdatedBlockTip, pwalletIn, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3));
-    conns.TransactionAddedToMempool = g_signals.m_internals->TransactionAddedToMempool.connect(std::bind(&CValidationInterface::TransactionAddedToMempool, pwalletIn, std::placeholders::_1));
-    conns.BlockConnected = g_signals.m_internals->BlockConnected.connect(std::bind(&CValidationInterface::BlockConnected, pwalletIn, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3));
-    conns.BlockDisconnected = g_signals.m_internals->BlockDisconnected.connect(std::bind(&CValidationInterface::BlockDisconnected, pwalletIn, std::placeholders::_1));
-    conns.TransactionRemovedFromMempool = g_signals.m_internals->TransactionRemovedFromMempool.connect(std::bind(&CValidationInterface::TransactionRemovedFromMempool, pwalletIn, std::placeholders::_1));
-    conns.ChainStateFlushed = g_signals.m_internals->ChainStateFlushed.connect(std::bind(&CValidationInterface::ChainStateFlushed, pwalletIn, std::placeholders::_1));
     conns.Broadcast = g_signals.m_internals->Broadcast.connect(std::bind(&CValidationInterface::ResendWalletTransactions, pwalletIn, std::placeholders::_1, std::placeholders::_2));
     conns.BlockChecked = g_signals.m_internals->BlockChecked.connect(std::bind(&CValidationInterface::BlockChecked, pwalletIn, std::placeholders::_1, std::placeholders::_2));
     conns.NewPoWValidBlock = g_signals.m_internals->NewPoWValidBlock.connect(std::bind(&CValidationInterface::NewPoWValidBlock, pwalletIn, std::placeholders::_1, std::placeholders::_2));
+
+    LOCK(g_signals.m_internals->m_queues_mutex);
+    auto & q = g_signals.m_internals->m_queues[pwalletIn];
+    if (!q) {
+        auto & idle = g_signals.m_internals->m_idle_queues;
+        if (!idle.empty()) {
+            q = std::move(idle.back());
+            idle.pop_back();
+            q->iface = pwalletIn;
+            q->processed = 0;
+            q->totalLatency = 0;
+            q->maxLatency = 0;
+            q->totalRunTime = 0;
+        } else {
+            q.reset(new ValidationInterfaceQueue(pwalletIn, g_signals.m_internals->m_pscheduler));
+        }
+    }
+    q->name = name.empty() ? "unnamed" : name;
+    ++q->generation;
+    q->registered = true;
 }
 
 void UnregisterValidationInterface(CValidationInterface* pwalletIn) {
     if (g_signals.m_internals) {
         g_signals.m_internals->m_connMainSignals.erase(pwalletIn);
+        LOCK(g_signals.m_internals->m_queues_mutex);
+        auto it = g_signals.m_internals->m_queues.find(pwalletIn);
+        if (it != g_signals.m_internals->m_queues.end() && it->second->registered)
+            UnregisterQueue(*g_signals.m_internals, *it->second);
     }
 }
 
@@ -117,10 +251,25 @@ void UnregisterAllValidationInterfaces() {
         return;
     }
     g_signals.m_internals->m_connMainSignals.clear();
+    LOCK(g_signals.m_internals->m_queues_mutex);
+    for (auto & item : g_signals.m_internals->m_queues) {
+        if (item.second->registered)
+            UnregisterQueue(*g_signals.m_internals, *item.second);
+    }
 }
 
 void CallFunctionInValidationInterfaceQueue(std::function<void ()> func) {
-    g_signals.m_internals->m_schedulerClient.AddToProcessQueue(std::move(func));
+    // Every subscriber queue has to reach this point before func runs, it is
+    // called on the thread of the queue that gets there last.
+    auto clients = g_signals.m_internals->Clients();
+    auto remaining = std::make_shared<std::atomic<size_t>>(clients.size());
+    auto pfunc = std::make_shared<std::function<void ()>>(std::move(func));
+    for (auto client : clients) {
+        client->AddToProcessQueue([remaining, pfunc] {
+            if (--*remaining == 0)
+                (*pfunc)();
+        });
+    }
 }
 
 void SyncWithValidationInterfaceQueue() {
@@ -135,8 +284,8 @@ void SyncWithValidationInterfaceQueue() {
 
 void CMainSignals::MempoolEntryRemoved(CTransactionRef ptx, MemPoolRemovalReason reason) {
     if (reason != MemPoolRemovalReason::BLOCK && reason != MemPoolRemovalReason::CONFLICT) {
-        m_internals->m_schedulerClient.AddToProcessQueue([ptx, this] {
-            m_internals->TransactionRemovedFromMempool(ptx);
+        m_internals->AddToProcessQueues([ptx](CValidationInterface* iface) {
+            iface->TransactionRemovedFromMempool(ptx);
         });
     }
 }
@@ -146,32 +295,32 @@ void CMainSignals::UpdatedBlockTip(const CBlockIndex *pindexNew, const CBlockInd
     // the chain actually updates. One way to ensure this is for the caller to invoke this signal
     // in the same critical section where the chain is updated
 
-    m_internals->m_schedulerClient.AddToProcessQueue([pindexNew, pindexFork, fInitialDownload, this] {
-        m_internals->UpdatedBlockTip(pindexNew, pindexFork, fInitialDownload);
+    m_internals->AddToProcessQueues([pindexNew, pindexFork, fInitialDownload](CValidationInterface* iface) {
+        iface->UpdatedBlockTip(pindexNew, pindexFork, fInitialDownload);
     });
 }
 
 void CMainSignals::TransactionAddedToMempool(const CTransactionRef &ptx) {
-    m_internals->m_schedulerClient.AddToProcessQueue([ptx, this] {
-        m_internals->TransactionAddedToMempool(ptx);
+    m_internals->AddToProcessQueues([ptx](CValidationInterface* iface) {
+        iface->TransactionAddedToMempool(ptx);
     });
 }
 
 void CMainSignals::BlockConnected(const std::shared_ptr<const CBlock> &pblock, const CBlockIndex *pindex, const std::shared_ptr<const std::vector<CTransactionRef>>& pvtxConflicted) {
-    m_internals->m_schedulerClient.AddToProcessQueue([pblock, pindex, pvtxConflicted, this] {
-        m_internals->BlockConnected(pblock, pindex, *pvtxConflicted);
+    m_internals->AddToProcessQueues([pblock, pindex, pvtxConflicted](CValidationInterface* iface) {
+        iface->BlockConnected(pblock, pindex, *pvtxConflicted);
     });
 }
 
 void CMainSignals::BlockDisconnected(const std::shared_ptr<const CBlock> &pblock) {
-    m_internals->m_schedulerClient.AddToProcessQueue([pblock, this] {
-        m_internals->BlockDisconnected(pblock);
+    m_internals->AddToProcessQueues([pblock](CValidationInterface* iface) {
+        iface->BlockDisconnected(pblock);
     });
 }
 
 void CMainSignals::ChainStateFlushed(const CBlockLocator &locator) {
-    m_internals->m_schedulerClient.AddToProcessQueue([locator, this] {
-        m_internals->ChainStateFlushed(locator);
+    m_internals->AddToProcessQueues([locator](CValidationInterface* iface) {
+        iface->ChainStateFlushed(locator);
     });
 }
 
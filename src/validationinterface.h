@@ -11,6 +11,8 @@
 
 #include <functional>
 #include <memory>
+#include <string>
+#include <vector>
 
 extern CCriticalSection cs_main;
 class CBlock;
@@ -26,10 +28,18 @@ class CScheduler;
 class CTxMemPool;
 enum class MemPoolRemovalReason;
 
+/** Default number of threads servicing the validation interface callbacks */
+static const int DEFAULT_VALIDATION_CALLBACK_THREADS = 4;
+/** Maximum number of threads servicing the validation interface callbacks */
+static const int MAX_VALIDATION_CALLBACK_THREADS = 16;
+
 // These functions dispatch to one or all registered wallets
 
-/** Register a wallet to receive updates from core */
-void RegisterValidationInterface(CValidationInterface* pwalletIn);
+/**
+ * Register a wallet to receive updates from core. The name identifies the
+ * subscriber's callback queue in getvalidationqueueinfo.
+ */
+void RegisterValidationInterface(CValidationInterface* pwalletIn, const std::string& name = "");
 /** Unregister a wallet from core */
 void UnregisterValidationInterface(CValidationInterface* pwalletIn);
 /** Unregister all wallets from core */
@@ -68,7 +78,9 @@ void SyncWithValidationInterfaceQueue() LOCKS_EXCLUDED(cs_main);
  * UpdatedBlockTip() callback may depend on an operation performed in
  * the BlockConnected() callback without worrying about explicit
  * synchronization. No ordering should be assumed across
- * ValidationInterface() subscribers.
+ * ValidationInterface() subscribers: each subscriber has its own callback
+ * queue and queues are serviced concurrently, so a slow subscriber does not
+ * delay notifications to the others.
  */
 class CValidationInterface {
 protected:
@@ -147,9 +159,20 @@ protected:
      * Notifies listeners that a block which builds directly on our current tip
      * has been received and connected to the headers tree, though not validated yet */
     virtual void NewPoWValidBlock(const CBlockIndex *pindex, const std::shared_ptr<const CBlock>& block) {};
-    friend void ::RegisterValidationInterface(CValidationInterface*);
+    friend void ::RegisterValidationInterface(CValidationInterface*, const std::string&);
     friend void ::UnregisterValidationInterface(CValidationInterface*);
     friend void ::UnregisterAllValidationInterfaces();
+    friend class CMainSignals;
+};
+
+/** Callback queue statistics of a validation interface subscriber */
+struct ValidationInterfaceQueueStats {
+    std::string name;
+    size_t pending{0};
+    uint64_t processed{0};
+    int64_t totalLatency{0}; // microseconds
+    int64_t maxLatency{0}; // microseconds
+    int64_t totalRunTime{0}; // microseconds
 };
 
 struct MainSignalsInstance;
@@ -157,7 +180,7 @@ class CMainSignals {
 private:
     std::unique_ptr<MainSignalsInstance> m_internals;
 
-    friend void ::RegisterValidationInterface(CValidationInterface*);
+    friend void ::RegisterValidationInterface(CValidationInterface*, const std::string&);
     friend void ::UnregisterValidationInterface(CValidationInterface*);
     friend void ::UnregisterAllValidationInterfaces();
     friend void ::CallFunctionInValidationInterfaceQueue(std::function<void ()> func);
@@ -167,12 +190,18 @@ private:
 public:
     /** Register a CScheduler to give callbacks which should run in the background (may only be called once) */
     void RegisterBackgroundSignalScheduler(CScheduler& scheduler);
-    /** Unregister a CScheduler to give callbacks which should run in the background - these callbacks will now be dropped! */
+    /**
+     * Unregister a CScheduler to give callbacks which should run in the background - these callbacks will now be dropped!
+     * Frees the subscriber callback queues, the scheduler threads must have been stopped.
+     */
     void UnregisterBackgroundSignalScheduler();
     /** Call any remaining callbacks on the calling thread */
     void FlushBackgroundCallbacks();
 
+    /** Returns the number of callbacks pending in the longest subscriber queue */
     size_t CallbacksPending();
+    /** Returns the callback queue statistics of all registered subscribers */
+    std::vector<ValidationInterfaceQueueStats> GetQueueStats();
 
     /** Register with mempool to call TransactionRemovedFromMempool callbacks */
     void RegisterWithMempoolSignals(CTxMemPool& pool);
@@ -7,9 +7,11 @@
 #include <chain.h>
 #include <consensus/validation.h>
 #include <core_io.h>
+#include <governance/governance.h>
 #include <httpserver.h>
 #include <init.h>
 #include <interfaces/chain.h>
+#include <kernel.h>
 #include <validation.h>
 #include <key_io.h>
 #include <net.h>
@@ -34,6 +36,7 @@
 #include <wallet/feebumper.h>
 #include <wallet/psbtwallet.h>
 #include <wallet/rpcwallet.h>
+#include <wallet/stakesplit.h>
 #include <wallet/wallet.h>
 #include <wallet/walletdb.h>
 #include <wallet/walletutil.h>
@@ -4384,6 +4387,192 @@ static UniValue splitbalance(const JSONRPCRequest& request)
     return result;
 }
 
+static UniValue planstakesplit(const JSONRPCRequest& request)
+{
+    if (request.fHelp || request.params.empty() || request.params.size() > 3)
+        throw std::runtime_error(
+            RPCHelpMan{"planstakesplit",
+                "\nPlans how the utxos in the specified address should be split for staking and returns the "
+                "consolidation and split transactions that get there. Inputs are sized so that the share of the "
+                "balance waiting on coinstake maturity after a stake stays under max_idle_percent, without going "
+                "below -minstakeamount. Utxos in active governance votes are left alone and a vote input of "
+                "-voteinputamount is kept. Transactions that spend the previous one are only created when submitting.\n",
+                {
+                    {"address", RPCArg::Type::STR, RPCArg::Optional::NO, "Plan the split of this address."},
+                    {"submit", RPCArg::Type::BOOL, RPCArg::Optional::OMITTED, "false", "Submit the planned transactions to the network."},
+                    {"max_idle_percent", RPCArg::Type::NUM, RPCArg::Optional::OMITTED, "1", "Acceptable percentage of the balance sitting out after stakes."},
+                },
+                RPCResult{
+            "{\n"
+            "  \"target_amount\": 208.00000000,       (planned stake input amount)\n"
+            "  \"target_inputs\": 48,                 (planned number of stake inputs)\n"
+            "  \"vote_input_amount\": 1.00000000,     (amount reserved for vote transactions)\n"
+            "  \"inputs_kept\": 0,                    (utxos left as they are)\n"
+            "  \"expected_stake_time\": 3600,         (expected seconds until the address stakes)\n"
+            "  \"idle_percent_before\": 71.42,        (expected percentage of the balance sitting out now)\n"
+            "  \"idle_percent_after\": 4.95,          (expected percentage of the balance sitting out after the plan)\n"
+            "  \"txs\": [\n"
+            "    {\n"
+            "      \"inputs\": 1,                     (number of inputs consumed)\n"
+            "      \"inputs_amount\": 10000.00000000, (amount of inputs consumed)\n"
+            "      \"outputs\": 49,                   (number of outputs created)\n"
+            "      \"spends_previous\": false,        (whether the last output of the previous transaction is spent)\n"
+            "      \"fees\": 0.00057330,              (network fees, taken out of the last output)\n"
+            "      \"txid\": \"xxxx\",                (transaction id)\n"
+            "      \"hex\": \"xxxx\"                  (raw transaction hex if submit is false)\n"
+            "    }\n"
+            "  ]\n"
+            "}\n"
+                },
+                RPCExamples{
+                  HelpExampleCli("planstakesplit", "BeDQzBfouG1WxE9ArLc43uibF8Gk4HYv3j")
+                + HelpExampleRpc("planstakesplit", "\"BeDQzBfouG1WxE9ArLc43uibF8Gk4HYv3j\"")
+                + HelpExampleCli("planstakesplit", "BeDQzBfouG1WxE9ArLc43uibF8Gk4HYv3j true 0.5")
+                + HelpExampleRpc("planstakesplit", "\"BeDQzBfouG1WxE9ArLc43uibF8Gk4HYv3j\", true, 0.5")
+                },
+            }.ToString());
+
+    const auto saddr = request.params[0].get_str();
+    const auto submit = request.params[1].isNull() ? false : request.params[1].get_bool();
+    const auto maxIdlePercent = request.params[2].isNull() ? 1.0 : request.params[2].get_real();
+    if (maxIdlePercent <= 0 || maxIdlePercent >= 100)
+        throw JSONRPCError(RPC_INVALID_PARAMETER, "max_idle_percent must be between 0 and 100");
+
+    if (!IsValidDestinationString(saddr))
+        throw JSONRPCError(RPC_INVALID_PARAMETER, strprintf("Bad address [%s]", saddr));
+    const auto sdest = DecodeDestination(saddr);
+    if (boost::get<CNoDestination>(&sdest))
+        throw JSONRPCError(RPC_INVALID_PARAMETER, strprintf("Bad address decode [%s]", saddr));
+    const auto sscript = GetScriptForDestination(sdest);
+
+    const auto & consensus = Params().GetConsensus();
+    const auto argStakeAmount = static_cast<CAmount>(gArgs.GetArg("-minstakeamount", 0));
+
+    StakeSplitParams params;
+    params.minStakeAmount = argStakeAmount == 0 ? 1 : argStakeAmount * COIN;
+    params.voteInputAmount = static_cast<CAmount>(gArgs.GetArg("-voteinputamount", gov::VOTING_UTXO_INPUT_AMOUNT));
+    // A staked input is out until the coinstake matures and meets the stake age
+    params.idleTime = std::max<int64_t>(consensus.coinMaturity * consensus.nPowTargetSpacing, consensus.stakeMinAge);
+    params.maxIdleFraction = maxIdlePercent / 100;
+
+    auto wallets = GetWallets();
+    for (const auto & pwallet : wallets) {
+        pwallet->BlockUntilSyncedToCurrentChain();
+        auto locked_chain = pwallet->chain().lock();
+        LOCK(pwallet->cs_wallet);
+
+        int tipHeight{0};
+        unsigned int tipBits{0};
+        {
+            LOCK(cs_main);
+            tipHeight = chainActive.Height();
+            tipBits = chainActive.Tip()->nBits;
+        }
+
+        std::vector<COutput> cs;
+        pwallet->AvailableCoins(*locked_chain, cs);
+
+        std::vector<StakeSplitCoin> coins;
+        CAmount total{0};
+        for (const auto & c : cs) {
+            const auto & coin = c.GetInputCoin();
+            if (coin.txout.scriptPubKey != sscript)
+                continue;
+            StakeSplitCoin sc;
+            sc.outpoint = coin.outpoint;
+            sc.amount = coin.txout.nValue;
+            // Immature coinstakes can't be spent and spending a voting utxo invalidates its votes
+            sc.locked = (c.tx->IsCoinStake() && c.nDepth < consensus.coinMaturity)
+                     || gov::Governance::instance().utxoInVote(coin.outpoint, tipHeight, consensus);
+            coins.push_back(sc);
+            total += sc.amount;
+        }
+        if (coins.empty())
+            continue; // no coins, try the next wallet
+
+        params.expectedStakeTime = expectedStakeTime(total, tipBits, GetAdjustedTime(), consensus);
+
+        StakeSplitPlan plan;
+        std::string strError;
+        if (!PlanStakeSplit(coins, params, plan, strError))
+            throw JSONRPCError(RPC_MISC_ERROR, strprintf("Failed to plan stake split: %s", strError));
+
+        if (!plan.txs.empty())
+            EnsureWalletIsUnlocked(pwallet.get());
+        if (submit && !plan.txs.empty() && pwallet->GetBroadcastTransactions() && !g_connman)
+            throw JSONRPCError(RPC_MISC_ERROR, "Failed to split balance: Peer-to-peer functionality missing or disabled");
+
+        UniValue txs(UniValue::VARR);
+        COutPoint carried; // last output of the previous transaction
+        CAmount carriedFees{0}; // fees taken out of the carried output so far
+        for (const auto & ptx : plan.txs) {
+            UniValue t(UniValue::VOBJ);
+            t.pushKV("inputs", static_cast<int>(ptx.inputs.size()) + (ptx.spendsPrevious ? 1 : 0));
+            t.pushKV("inputs_amount", ValueFromAmount(ptx.inputAmount));
+            t.pushKV("outputs", static_cast<int>(ptx.outputs.size()));
+            t.pushKV("spends_previous", ptx.spendsPrevious);
+            if (ptx.spendsPrevious && carried.IsNull()) { // previous transaction wasn't submitted
+                txs.push_back(t);
+                continue;
+            }
+
+            CCoinControl cc;
+            cc.fAllowOtherInputs = false;
+            cc.destChange = sdest;
+            for (const auto & input : ptx.inputs)
+                cc.Select(input);
+            std::vector<CRecipient> vouts;
+            for (const auto & amount : ptx.outputs)
+                vouts.push_back({sscript, amount, false});
+            if (ptx.spendsPrevious) {
+                cc.Select(carried);
+                vouts.back().nAmount -= carriedFees;
+            } else {
+                carriedFees = 0;
+            }
+            vouts.back().fSubtractFeeFromAmount = true; // network fee comes out of the last output
+
+            CReserveKey reservekey(pwallet.get());
+            CAmount nFeeRequired;
+            int nChangePosRet = -1;
+            CTransactionRef tx;
+            if (!pwallet->CreateTransaction(*locked_chain, vouts, tx, reservekey, nFeeRequired, nChangePosRet, strError, cc))
+                throw JSONRPCError(RPC_MISC_ERROR, strprintf("Failed to create stake split transaction: %s", strError));
+
+            carried.SetNull();
+            if (submit) {
+                CValidationState state;
+                if (!pwallet->CommitTransaction(tx, {}, {}, reservekey, g_connman.get(), state))
+                    throw JSONRPCError(RPC_MISC_ERROR, strprintf("Failed to submit stake split transaction, it was rejected: %s", FormatStateMessage(state)));
+                // The next transaction may spend the last output, which moves
+                // past the change output if there is one
+                const int last = static_cast<int>(vouts.size()) - 1;
+                carried = COutPoint(tx->GetHash(), nChangePosRet >= 0 && nChangePosRet <= last ? last + 1 : last);
+                carriedFees += nFeeRequired;
+            }
+
+            t.pushKV("fees", ValueFromAmount(nFeeRequired));
+            t.pushKV("txid", tx->GetHash().GetHex());
+            if (!submit)
+                t.pushKV("hex", EncodeHexTx(*tx, RPCSerializationFlags()));
+            txs.push_back(t);
+        }
+
+        UniValue result(UniValue::VOBJ);
+        result.pushKV("target_amount", ValueFromAmount(plan.targetAmount));
+        result.pushKV("target_inputs", plan.targetInputs);
+        result.pushKV("vote_input_amount", ValueFromAmount(plan.voteInputAmount));
+        result.pushKV("inputs_kept", static_cast<int>(plan.kept.size()));
+        result.pushKV("expected_stake_time", static_cast<int64_t>(params.expectedStakeTime));
+        result.pushKV("idle_percent_before", std::round(plan.idleBefore * 10000) / 100);
+        result.pushKV("idle_percent_after", std::round(plan.idleAfter * 10000) / 100);
+        result.pushKV("txs", txs);
+        return result; // return here, do not process same address from other wallets to avoid duplicate txs
+    }
+
+    throw JSONRPCError(RPC_INVALID_PARAMETER, strprintf("No wallet inputs found for address [%s]", saddr));
+}
+
 UniValue abortrescan(const JSONRPCRequest& request); // in rpcdump.cpp
 UniValue dumpprivkey(const JSONRPCRequest& request); // in rpcdump.cpp
 UniValue importprivkey(const JSONRPCRequest& request);
@@ -4456,6 +4645,7 @@ static const CRPCCommand commands[] =
     { "wallet",             "walletpassphrasechange",           &walletpassphrasechange,        {"oldpassphrase","newpassphrase"} },
     { "wallet",             "walletprocesspsbt",                &walletprocesspsbt,             {"psbt","sign","sighashtype","bip32derivs"} },
     { "wallet",             "splitbalance",                     &splitbalance,                  {"amount","address","hex_only"} },
+    { "wallet",             "planstakesplit",                   &planstakesplit,                {"address","submit","max_idle_percent"} },
 };
 // clang-format on
 
@@ -0,0 +1,210 @@
+// Copyright (c) 2021 The Blocknet developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <wallet/stakesplit.h>
+
+#include <tinyformat.h>
+#include <util/moneystr.h>
+
+#include <algorithm>
+#include <cmath>
+
+//! Coins within this range of the planned size (in percent) are left alone
+static const int KEEP_MIN_PERCENT = 75;
+static const int KEEP_MAX_PERCENT = 150;
+
+double StakeSplitIdleFraction(const std::vector<CAmount> & amounts, const int64_t & idleTime, const double & expectedStakeTime) {
+    CAmount total{0};
+    for (const auto & amount : amounts)
+        total += amount;
+    if (total <= 0 || idleTime <= 0 || expectedStakeTime <= 0)
+        return 0;
+    // An input stakes every expectedStakeTime * total / amount seconds on
+    // average and then idles for idleTime, so it's idle x / (1 + x) of the time.
+    double idle{0};
+    for (const auto & amount : amounts) {
+        const double x = static_cast<double>(idleTime) * amount / (expectedStakeTime * total);
+        idle += amount * x / (1.0 + x);
+    }
+    return idle / total;
+}
+
+bool PlanStakeSplit(const std::vector<StakeSplitCoin> & coins, const StakeSplitParams & params,
+                    StakeSplitPlan & plan, std::string & error)
+{
+    plan = StakeSplitPlan{};
+    if (params.minStakeAmount <= 0 || params.maxStakeInputs < 1 || params.maxInputs < 2 || params.maxOutputs < 2) {
+        error = "Bad stake split parameters";
+        return false;
+    }
+
+    std::vector<StakeSplitCoin> kept;
+    std::vector<StakeSplitCoin> spendable;
+    std::vector<CAmount> amountsBefore;
+    CAmount total{0};
+    for (const auto & coin : coins) {
+        amountsBefore.push_back(coin.amount);
+        if (coin.locked) {
+            kept.push_back(coin);
+            continue;
+        }
+        spendable.push_back(coin);
+        total += coin.amount;
+    }
+
+    // Keep the coin closest to the vote input amount for vote transactions,
+    // otherwise reserve an output for it.
+    bool reserveVoteOutput{false};
+    if (params.voteInputAmount > 0) {
+        auto best = spendable.end();
+        for (auto it = spendable.begin(); it != spendable.end(); ++it) {
+            if (it->amount < params.voteInputAmount / 2 || it->amount > params.voteInputAmount * 2)
+                continue;
+            if (best == spendable.end() || std::abs(it->amount - params.voteInputAmount) < std::abs(best->amount - params.voteInputAmount))
+                best = it;
+        }
+        if (best != spendable.end()) {
+            plan.voteInputAmount = best->amount;
+            total -= best->amount;
+            kept.push_back(*best);
+            spendable.erase(best);
+        } else {
+            plan.voteInputAmount = params.voteInputAmount;
+            reserveVoteOutput = true;
+        }
+    }
+
+    const CAmount stakeable = total - (reserveVoteOutput ? params.voteInputAmount : 0);
+    if (stakeable < params.minStakeAmount) {
+        error = strprintf("Balance of %s is below the minimum stake amount of %s", FormatMoney(std::max<CAmount>(stakeable, 0)),
+                          FormatMoney(params.minStakeAmount));
+        return false;
+    }
+
+    // Enough inputs to keep the idle share under the limit. When the stake rate
+    // isn't known use as many inputs as allowed.
+    const int64_t maxByAmount = stakeable / params.minStakeAmount;
+    int64_t inputs = params.maxStakeInputs;
+    if (params.expectedStakeTime > 0 && params.maxIdleFraction > 0 && params.maxIdleFraction < 1) {
+        const double needed = params.idleTime * (1 - params.maxIdleFraction) / (params.expectedStakeTime * params.maxIdleFraction);
+        inputs = static_cast<int64_t>(std::min(std::ceil(needed), static_cast<double>(params.maxStakeInputs)));
+    }
+    inputs = std::max<int64_t>(1, std::min<int64_t>(inputs, std::min<int64_t>(maxByAmount, params.maxStakeInputs)));
+    plan.targetInputs = static_cast<int>(inputs);
+    plan.targetAmount = stakeable / inputs;
+    if (plan.targetAmount >= COIN) // prefer whole coin amounts
+        plan.targetAmount = plan.targetAmount / COIN * COIN;
+
+    // Coins close to the target stay as they are
+    std::vector<StakeSplitCoin> pool;
+    for (const auto & coin : spendable) {
+        if (coin.amount * 100 >= plan.targetAmount * KEEP_MIN_PERCENT && coin.amount * 100 <= plan.targetAmount * KEEP_MAX_PERCENT)
+            kept.push_back(coin);
+        else
+            pool.push_back(coin);
+    }
+
+    // Folds kept coins into the pool while the pool can't fund the vote output
+    // and a stake input of at least the minimum amount, smallest coins first.
+    CAmount poolAmount{0};
+    for (const auto & coin : pool)
+        poolAmount += coin.amount;
+    auto poolStakeAmount = [&]() -> CAmount {
+        return poolAmount - (reserveVoteOutput ? params.voteInputAmount : 0);
+    };
+    while ((!pool.empty() || reserveVoteOutput) && poolStakeAmount() < params.minStakeAmount) {
+        auto smallest = kept.end();
+        for (auto it = kept.begin(); it != kept.end(); ++it) {
+            if (!it->locked && (smallest == kept.end() || it->amount < smallest->amount))
+                smallest = it;
+        }
+        if (smallest == kept.end())
+            break;
+        pool.push_back(*smallest);
+        poolAmount += smallest->amount;
+        kept.erase(smallest);
+    }
+
+    // Largest first so that the first transaction can fund the vote output
+    std::sort(pool.begin(), pool.end(), [](const StakeSplitCoin & a, const StakeSplitCoin & b) {
+        return a.amount > b.amount;
+    });
+
+    // The pool is split into outputs of the target amount and the last one takes
+    // the remainder, so none of them is below the target. A transaction that
+    // can't hold all of its share passes the rest on to the next transaction in
+    // its last output.
+    int64_t outputsLeft = std::max<int64_t>(1, poolStakeAmount() / plan.targetAmount);
+
+    auto finish = [&](StakeSplitTx & tx, const bool & last) {
+        while (true) {
+            CAmount amount = tx.inputAmount;
+            if (reserveVoteOutput && amount > params.voteInputAmount) {
+                tx.outputs.push_back(params.voteInputAmount);
+                amount -= params.voteInputAmount;
+                reserveVoteOutput = false;
+            }
+            const int64_t room = params.maxOutputs - static_cast<int64_t>(tx.outputs.size());
+            if (last && outputsLeft <= room) {
+                for (int64_t i = 0; i < outputsLeft - 1; ++i)
+                    tx.outputs.push_back(plan.targetAmount);
+                tx.outputs.push_back(amount - (outputsLeft - 1) * plan.targetAmount); // remainder goes in the last output
+                outputsLeft = 0;
+                if (tx.inputs.size() == 1 && !tx.spendsPrevious && tx.outputs.size() == 1) { // nothing would change
+                    StakeSplitCoin coin;
+                    coin.outpoint = tx.inputs[0];
+                    coin.amount = tx.inputAmount;
+                    kept.push_back(coin);
+                    return;
+                }
+                plan.txs.push_back(tx);
+                return;
+            }
+            // Leave room for the carried output and hold back the last pool output
+            const int64_t outs = std::min<int64_t>(std::min<int64_t>(amount / plan.targetAmount, outputsLeft - 1), room - 1);
+            for (int64_t i = 0; i < outs; ++i)
+                tx.outputs.push_back(plan.targetAmount);
+            amount -= outs * plan.targetAmount;
+            outputsLeft -= outs;
+            if (amount > 0)
+                tx.outputs.push_back(amount);
+            plan.txs.push_back(tx);
+            tx = StakeSplitTx{};
+            if (amount > 0) {
+                tx.spendsPrevious = true;
+                tx.inputAmount = amount;
+            }
+            if (!last)
+                return;
+        }
+    };
+
+    StakeSplitTx tx;
+    for (const auto & coin : pool) {
+        if (!tx.inputs.empty()) {
+            const int inputs = static_cast<int>(tx.inputs.size()) + (tx.spendsPrevious ? 1 : 0);
+            const int64_t outs = (tx.inputAmount + coin.amount) / plan.targetAmount + (reserveVoteOutput ? 1 : 0);
+            if (inputs >= params.maxInputs || outs >= params.maxOutputs)
+                finish(tx, false);
+        }
+        tx.inputs.push_back(coin.outpoint);
+        tx.inputAmount += coin.amount;
+    }
+    if (!tx.inputs.empty() || tx.spendsPrevious)
+        finish(tx, true);
+
+    std::vector<CAmount> amountsAfter;
+    for (const auto & coin : kept) {
+        plan.kept.push_back(coin.outpoint);
+        amountsAfter.push_back(coin.amount);
+    }
+    for (size_t i = 0; i < plan.txs.size(); ++i) {
+        const auto & outputs = plan.txs[i].outputs;
+        const bool carried = i + 1 < plan.txs.size() && plan.txs[i + 1].spendsPrevious;
+        amountsAfter.insert(amountsAfter.end(), outputs.begin(), carried ? outputs.end() - 1 : outputs.end());
+    }
+    plan.idleBefore = StakeSplitIdleFraction(amountsBefore, params.idleTime, params.expectedStakeTime);
+    plan.idleAfter = StakeSplitIdleFraction(amountsAfter, params.idleTime, params.expectedStakeTime);
+    return true;
+}
@@ -0,0 +1,77 @@
+// Copyright (c) 2021 The Blocknet developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_WALLET_STAKESPLIT_H
+#define BITCOIN_WALLET_STAKESPLIT_H
+
+#include <amount.h>
+#include <primitives/transaction.h>
+
+#include <string>
+#include <vector>
+
+/** A coin of the balance being planned. */
+struct StakeSplitCoin {
+    COutPoint outpoint;
+    CAmount amount{0};
+    bool locked{false}; //!< coin must not be spent (e.g. it's an active governance vote)
+};
+
+struct StakeSplitParams {
+    CAmount minStakeAmount{COIN};  //!< smallest input the staker uses (-minstakeamount)
+    CAmount voteInputAmount{0};    //!< size of the input reserved for vote transactions, 0 for none
+    int64_t idleTime{0};           //!< seconds a staked input sits out before it can stake again
+    double expectedStakeTime{0};   //!< expected seconds for the whole balance to stake, 0 if unknown
+    double maxIdleFraction{0.01};  //!< acceptable share of the balance sitting out after stakes
+    int maxStakeInputs{1000};      //!< upper bound on the number of stake inputs
+    int maxInputs{250};            //!< per transaction
+    int maxOutputs{250};           //!< per transaction
+};
+
+struct StakeSplitTx {
+    std::vector<COutPoint> inputs;
+    CAmount inputAmount{0};          //!< including the output spent from the previous transaction
+    std::vector<CAmount> outputs;
+    bool spendsPrevious{false};      //!< also spends the last output of the previous transaction
+};
+
+struct StakeSplitPlan {
+    CAmount targetAmount{0};          //!< planned stake input size
+    int targetInputs{0};              //!< planned number of stake inputs
+    CAmount voteInputAmount{0};       //!< amount reserved for vote transactions
+    std::vector<COutPoint> kept;      //!< coins already at the planned size or locked
+    std::vector<StakeSplitTx> txs;    //!< consolidation and split transactions, in order
+    double idleBefore{0};             //!< expected idle share of the current distribution
+    double idleAfter{0};              //!< expected idle share of the planned distribution
+};
+
+/**
+ * Expected share of the balance sitting out after stakes. Each input stakes in
+ * proportion to its amount and then idles for idleTime seconds.
+ */
+double StakeSplitIdleFraction(const std::vector<CAmount> & amounts, const int64_t & idleTime, const double & expectedStakeTime);
+
+/**
+ * Plans the distribution of the coins into stake inputs.
+ *
+ * Stake weight is linear in the input amount, so splitting a balance doesn't
+ * change how often it stakes. What splitting changes is how much of the balance
+ * sits out after a stake: the staked input can't stake again until the coinstake
+ * matures and meets the stake age. The planner picks the input size that keeps
+ * that idle share under a limit, without going below the staker's minimum input
+ * amount or creating more inputs than the staker should hash every second.
+ *
+ * Coins close to the planned size are kept, all others are consolidated and
+ * split into as few transactions as the per transaction limits allow. Planned
+ * stake inputs are at least the planned size, or at least the minimum stake
+ * amount if less than that is left to split. When the coins don't fit in one
+ * transaction, the amount a transaction can't split yet is carried in its last
+ * output to the next transaction (see StakeSplitTx::spendsPrevious). Transaction
+ * fees are not accounted for, callers should take them out of the last output.
+ * @return false with error set if the coins can't be planned
+ */
+bool PlanStakeSplit(const std::vector<StakeSplitCoin> & coins, const StakeSplitParams & params,
+                    StakeSplitPlan & plan, std::string & error);
+
+#endif // BITCOIN_WALLET_STAKESPLIT_H
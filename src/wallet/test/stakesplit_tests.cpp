@@ -0,0 +1,162 @@
+// Copyright (c) 2021 The Blocknet developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <wallet/stakesplit.h>
+
+#include <test/test_bitcoin.h>
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_FIXTURE_TEST_SUITE(stakesplit_tests, BasicTestingSetup)
+
+static StakeSplitCoin MakeCoin(const CAmount & amount, const bool & locked = false)
+{
+    static uint32_t n{0};
+    StakeSplitCoin coin;
+    coin.outpoint = COutPoint(InsecureRand256(), n++);
+    coin.amount = amount;
+    coin.locked = locked;
+    return coin;
+}
+
+/** Outputs the plan leaves behind, without the ones spent by the next transaction */
+static std::vector<CAmount> PlannedOutputs(const StakeSplitPlan & plan)
+{
+    std::vector<CAmount> outputs;
+    for (size_t i = 0; i < plan.txs.size(); ++i) {
+        const auto & tx = plan.txs[i];
+        CAmount out{0};
+        for (const auto & amount : tx.outputs)
+            out += amount;
+        BOOST_CHECK_EQUAL(out, tx.inputAmount); // fees are left to the caller
+        BOOST_CHECK(i > 0 || !tx.spendsPrevious);
+        const bool carried = i + 1 < plan.txs.size() && plan.txs[i + 1].spendsPrevious;
+        outputs.insert(outputs.end(), tx.outputs.begin(), carried ? tx.outputs.end() - 1 : tx.outputs.end());
+    }
+    return outputs;
+}
+
+static CAmount PlannedTotal(const StakeSplitPlan & plan)
+{
+    CAmount total{0};
+    for (const auto & amount : PlannedOutputs(plan))
+        total += amount;
+    return total;
+}
+
+BOOST_AUTO_TEST_CASE(stakesplit_idle_fraction)
+{
+    // One input idles far more than the same balance spread over many inputs
+    const std::vector<CAmount> one{10000 * COIN};
+    const std::vector<CAmount> many(100, 100 * COIN);
+    const auto idleOne = StakeSplitIdleFraction(one, 9000, 3600);
+    const auto idleMany = StakeSplitIdleFraction(many, 9000, 3600);
+    BOOST_CHECK_CLOSE(idleOne, 2.5 / 3.5, 0.0001);
+    BOOST_CHECK(idleMany < idleOne / 25);
+    BOOST_CHECK_EQUAL(StakeSplitIdleFraction(one, 9000, 0), 0);
+}
+
+BOOST_AUTO_TEST_CASE(stakesplit_plan_split)
+{
+    StakeSplitParams params;
+    params.minStakeAmount = COIN;
+    params.voteInputAmount = COIN;
+    params.idleTime = 9000;
+    params.expectedStakeTime = 3600;
+    params.maxIdleFraction = 0.05;
+
+    // A single large coin is split and a vote input is reserved
+    const std::vector<StakeSplitCoin> coins{MakeCoin(10000 * COIN)};
+    StakeSplitPlan plan;
+    std::string error;
+    BOOST_CHECK(PlanStakeSplit(coins, params, plan, error));
+    BOOST_CHECK_EQUAL(plan.targetInputs, 48); // ceil(9000 * 0.95 / (3600 * 0.05))
+    BOOST_CHECK_EQUAL(plan.targetAmount, 208 * COIN);
+    BOOST_CHECK_EQUAL(plan.voteInputAmount, COIN);
+    BOOST_CHECK(plan.kept.empty());
+    BOOST_CHECK_EQUAL(plan.txs.size(), 1U);
+    BOOST_CHECK_EQUAL(plan.txs[0].outputs.size(), 49U);
+    BOOST_CHECK_EQUAL(plan.txs[0].outputs[0], COIN);
+    BOOST_CHECK_EQUAL(PlannedTotal(plan), 10000 * COIN);
+    BOOST_CHECK(plan.idleAfter <= params.maxIdleFraction);
+    BOOST_CHECK(plan.idleAfter < plan.idleBefore);
+
+    // Applying the plan again changes nothing
+    std::vector<StakeSplitCoin> split;
+    for (const auto & amount : plan.txs[0].outputs)
+        split.push_back(MakeCoin(amount));
+    StakeSplitPlan replan;
+    BOOST_CHECK(PlanStakeSplit(split, params, replan, error));
+    BOOST_CHECK(replan.txs.empty());
+    BOOST_CHECK_EQUAL(replan.kept.size(), split.size());
+}
+
+BOOST_AUTO_TEST_CASE(stakesplit_plan_consolidate)
+{
+    StakeSplitParams params;
+    params.minStakeAmount = 100 * COIN;
+    params.idleTime = 9000;
+    params.expectedStakeTime = 3600;
+    params.maxIdleFraction = 0.01;
+    params.maxInputs = 10;
+
+    // Dust below the minimum stake amount is consolidated, locked coins are left alone
+    std::vector<StakeSplitCoin> coins;
+    for (int i = 0; i < 25; ++i)
+        coins.push_back(MakeCoin(10 * COIN));
+    coins.push_back(MakeCoin(5000 * COIN, true));
+    StakeSplitPlan plan;
+    std::string error;
+    BOOST_CHECK(PlanStakeSplit(coins, params, plan, error));
+    BOOST_CHECK_EQUAL(plan.targetInputs, 2); // limited by the minimum stake amount
+    BOOST_CHECK_EQUAL(plan.targetAmount, 125 * COIN);
+    BOOST_CHECK_EQUAL(plan.kept.size(), 1U);
+    BOOST_CHECK(plan.kept[0] == coins.back().outpoint);
+    BOOST_CHECK_EQUAL(PlannedTotal(plan), 250 * COIN);
+
+    // At most 10 inputs per transaction, so the amount not split yet is passed
+    // on to the next transaction instead of ending up in outputs below the
+    // minimum stake amount
+    BOOST_CHECK_EQUAL(plan.txs.size(), 3U);
+    for (const auto & tx : plan.txs)
+        BOOST_CHECK(tx.inputs.size() + (tx.spendsPrevious ? 1 : 0) <= 10);
+    BOOST_CHECK(plan.txs[0].outputs == std::vector<CAmount>({100 * COIN}));
+    BOOST_CHECK(plan.txs[1].spendsPrevious);
+    BOOST_CHECK_EQUAL(plan.txs[1].inputs.size(), 9U);
+    BOOST_CHECK(plan.txs[1].outputs == std::vector<CAmount>({125 * COIN, 65 * COIN}));
+    BOOST_CHECK(plan.txs[2].spendsPrevious);
+    BOOST_CHECK_EQUAL(plan.txs[2].inputs.size(), 6U);
+    BOOST_CHECK(plan.txs[2].outputs == std::vector<CAmount>({125 * COIN}));
+    BOOST_CHECK(PlannedOutputs(plan) == std::vector<CAmount>({125 * COIN, 125 * COIN}));
+
+    // An uneven amount goes in the last output
+    coins.push_back(MakeCoin(7 * COIN));
+    BOOST_CHECK(PlanStakeSplit(coins, params, plan, error));
+    BOOST_CHECK_EQUAL(plan.targetAmount, 128 * COIN);
+    BOOST_CHECK(PlannedOutputs(plan) == std::vector<CAmount>({128 * COIN, 129 * COIN}));
+    coins.pop_back();
+
+    // Not enough to stake
+    coins.resize(5);
+    BOOST_CHECK(!PlanStakeSplit(coins, params, plan, error));
+    BOOST_CHECK(!error.empty());
+
+    // Splits that don't fit in one transaction are continued in the next one
+    params.maxInputs = 250;
+    params.maxOutputs = 10;
+    params.minStakeAmount = COIN;
+    params.maxIdleFraction = 0.001;
+    StakeSplitPlan split;
+    BOOST_CHECK(PlanStakeSplit({MakeCoin(10000 * COIN)}, params, split, error));
+    BOOST_CHECK_EQUAL(split.targetInputs, 1000);
+    BOOST_CHECK(split.txs.size() > 1);
+    const auto outputs = PlannedOutputs(split);
+    BOOST_CHECK_EQUAL(outputs.size(), 1000U);
+    for (const auto & amount : outputs)
+        BOOST_CHECK_EQUAL(amount, 10 * COIN);
+    for (const auto & tx : split.txs)
+        BOOST_CHECK(tx.outputs.size() <= 10);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -391,6 +391,47 @@ BOOST_AUTO_TEST_CASE(staking_tests_protocolupgrade_v07)
     pos_ptr.reset();
 }
 
+/// Check that the expected stake time follows the stake weight of each protocol
+BOOST_AUTO_TEST_CASE(staking_tests_expectedstaketime)
+{
+    Consensus::Params consensus = Params().GetConsensus();
+    consensus.stakingV06UpgradeTime = 1000;
+    consensus.stakingV07UpgradeTime = 2000;
+    const int64_t preV07 = 1500;
+    const int64_t postV07 = 2500;
+    const CAmount amount = 1000 * COIN;
+
+    // Small chance per second: v06 weight is 1/200 of the amount
+    const unsigned int nBits = arith_uint256(~arith_uint256() >> 48).GetCompact();
+    BOOST_CHECK_EQUAL(expectedStakeTime(0, nBits, preV07, consensus), 0);
+    BOOST_CHECK_EQUAL(expectedStakeTime(0, nBits, postV07, consensus), 0);
+    arith_uint256 target;
+    target.SetCompact(nBits);
+    const double targetChance = static_cast<double>(amount) * target.getdouble() / pow(2.0, 256);
+    const double timeV06 = expectedStakeTime(amount, nBits, preV07, consensus);
+    BOOST_CHECK_CLOSE(timeV06, 200 / targetChance, 0.0001);
+
+    // v07 weight is 1/100 of the amount scaled by the multiplier, which averages
+    // well below 1x when blocks arrive at the target spacing
+    double multipliers{0};
+    for (int t = 1; t <= consensus.nPowTargetSpacing; ++t)
+        multipliers += floor(stakeWeightMultiplierV07(t, 0, consensus.nPowTargetSpacing) * 100) / 100;
+    BOOST_CHECK(multipliers > 0 && multipliers < consensus.nPowTargetSpacing / 4.0);
+    const double timeV07 = expectedStakeTime(amount, nBits, postV07, consensus);
+    BOOST_CHECK_CLOSE(timeV07, consensus.nPowTargetSpacing * 100 / (targetChance * multipliers), 1);
+    BOOST_CHECK(timeV07 > timeV06 * 2);
+    BOOST_CHECK_CLOSE(expectedStakeTime(amount * 2, nBits, postV07, consensus), timeV07 / 2, 1);
+
+    // Certain hit: v06 stakes on the first hash, v07 waits for the multiplier to
+    // become non-zero after the previous block
+    const unsigned int nBitsEasy = arith_uint256(~arith_uint256() >> 8).GetCompact();
+    BOOST_CHECK_EQUAL(expectedStakeTime(amount, nBitsEasy, preV07, consensus), 1);
+    const double easyV07 = expectedStakeTime(amount, nBitsEasy, postV07, consensus);
+    BOOST_CHECK(easyV07 > 1 && easyV07 < consensus.nPowTargetSpacing);
+    BOOST_CHECK(stakeWeightMultiplierV07(static_cast<int64_t>(easyV07) - 1, 0, consensus.nPowTargetSpacing) < 0.01);
+    BOOST_CHECK(stakeWeightMultiplierV07(static_cast<int64_t>(easyV07), 0, consensus.nPowTargetSpacing) >= 0.01);
+}
+
 /// Ensure that bad stakes are not accepted by the protocol.
 BOOST_FIXTURE_TEST_CASE(staking_tests_stakes, TestChainPoS)
 {
@@ -3477,19 +3477,19 @@ UniValue dxGetUtxos(const JSONRPCRequest& request)
 static const CRPCCommand commands[] =
 { //  category             name                          actor (function)              argNames
   //  -------------------- ----------------------------- ----------------------------- ----------
-    { "xbridge",           "dxGetOrderFills",            &dxGetOrderFills,             {} },
-    { "xbridge",           "dxGetOrders",                &dxGetOrders,                 {} },
-    { "xbridge",           "dxGetOrder",                 &dxGetOrder,                  {} },
-    { "xbridge",           "dxGetLocalTokens",           &dxGetLocalTokens,            {} },
+    { "xbridge",           "dxGetOrderFills",            &dxGetOrderFills,             {}, true },
+    { "xbridge",           "dxGetOrders",                &dxGetOrders,                 {}, true },
+    { "xbridge",           "dxGetOrder",                 &dxGetOrder,                  {}, true },
+    { "xbridge",           "dxGetLocalTokens",           &dxGetLocalTokens,            {}, true },
     { "xbridge",           "dxLoadXBridgeConf",          &dxLoadXBridgeConf,           {} },
     { "xbridge",           "dxGetNewTokenAddress",       &dxGetNewTokenAddress,        {} },
-    { "xbridge",           "dxGetNetworkTokens",         &dxGetNetworkTokens,          {} },
+    { "xbridge",           "dxGetNetworkTokens",         &dxGetNetworkTokens,          {}, true },
     { "xbridge",           "dxMakeOrder",                &dxMakeOrder,                 {} },
     { "xbridge",           "dxMakePartialOrder",         &dxMakePartialOrder,          {} },
     { "xbridge",           "dxTakeOrder",                &dxTakeOrder,                 {} },
     { "xbridge",           "dxCancelOrder",              &dxCancelOrder,               {} },
-    { "xbridge",           "dxGetOrderHistory",          &dxGetOrderHistory,           {} },
-    { "xbridge",           "dxGetOrderBook",             &dxGetOrderBook,              {} },
+    { "xbridge",           "dxGetOrderHistory",          &dxGetOrderHistory,           {}, true },
+    { "xbridge",           "dxGetOrderBook",             &dxGetOrderBook,              {}, true },
     { "xbridge",           "dxGetTokenBalances",         &dxGetTokenBalances,          {} },
     { "xbridge",           "dxGetMyOrders",              &dxGetMyOrders,               {} },
     { "xbridge",           "dxGetMyPartialOrderChain",   &dxGetMyPartialOrderChain,    {"order_id"} },
@@ -3497,7 +3497,7 @@ static const CRPCCommand commands[] =
     { "xbridge",           "dxGetLockedUtxos",           &dxGetLockedUtxos,            {} },
     { "xbridge",           "dxFlushCancelledOrders",     &dxFlushCancelledOrders,      {} },
     { "xbridge",           "gettradingdata",             &gettradingdata,              {} },
-    { "xbridge",           "dxGetTradingData",           &dxGetTradingData,            {} },
+    { "xbridge",           "dxGetTradingData",           &dxGetTradingData,            {}, true },
     { "xbridge",           "dxSplitAddress",             &dxSplitAddress,              {"token", "splitamount", "address", "include_fees", "show_rawtx", "submit"} },
     { "xbridge",           "dxSplitInputs",              &dxSplitInputs,               {"token", "splitamount", "address", "include_fees", "show_rawtx", "submit", "utxos"} },
     { "xbridge",           "dxGetUtxos",                 &dxGetUtxos,                  {"token", "include_used"} },
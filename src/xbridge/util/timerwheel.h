@@ -0,0 +1,162 @@
+// Copyright (c) 2021 The Blocknet developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BLOCKNET_XBRIDGE_UTIL_TIMERWHEEL_H
+#define BLOCKNET_XBRIDGE_UTIL_TIMERWHEEL_H
+
+#include <algorithm>
+#include <stdint.h>
+#include <utility>
+#include <vector>
+
+//******************************************************************************
+//******************************************************************************
+namespace xbridge
+{
+
+/**
+ * Hierarchical timer wheel with a resolution of one tick (second). Three levels
+ * of 256 slots cover deadlines up to 2^24 ticks (~194 days) ahead, later ones
+ * are parked and rescheduled when the top level wraps. Scheduling is O(1) and
+ * advancing costs O(expired) plus one cascade per 256 ticks. Items can't be
+ * cancelled, owners should ignore expired items they no longer track.
+ * Not thread safe.
+ */
+template <typename T>
+class TimerWheel
+{
+public:
+    /**
+     * @param now current tick, deadlines are scheduled relative to it
+     */
+    explicit TimerWheel(const int64_t now) : m_now(now) {}
+
+    /**
+     * @brief schedule - schedule the item to expire at the deadline. Deadlines
+     * that already passed expire on the next advance.
+     */
+    void schedule(const int64_t deadline, const T & item)
+    {
+        ++m_size;
+        place(Entry{deadline, item});
+    }
+
+    /**
+     * @brief advance - move the wheel to now and append the items whose deadline
+     * is at or before now to expired.
+     */
+    void advance(const int64_t now, std::vector<T> & expired)
+    {
+        for (auto & e : m_due)
+            expired.push_back(std::move(e.second));
+        m_size -= m_due.size();
+        m_due.clear();
+
+        if (m_size == 0 && now > m_now)
+        {
+            m_now = now; // nothing to cascade, skip ahead
+            return;
+        }
+
+        while (m_now < now)
+        {
+            ++m_now;
+            // cascade the higher levels when the lower ones wrap
+            if ((m_now & MASK) == 0)
+            {
+                int level = 1;
+                while (level < LEVELS && ((m_now >> (SLOT_BITS * level)) & MASK) == 0)
+                    ++level;
+                if (level == LEVELS)
+                    cascade(m_overflow);
+                for (int l = std::min(level, LEVELS - 1); l >= 1; --l)
+                    cascade(m_slots[l][(m_now >> (SLOT_BITS * l)) & MASK]);
+                for (auto & e : m_due) // deadlines at this tick
+                    expired.push_back(std::move(e.second));
+                m_size -= m_due.size();
+                m_due.clear();
+            }
+
+            auto & slot = m_slots[0][m_now & MASK];
+            if (slot.empty())
+                continue;
+            std::vector<Entry> entries;
+            entries.swap(slot);
+            for (auto & e : entries)
+            {
+                if (e.first <= m_now)
+                {
+                    expired.push_back(std::move(e.second));
+                    --m_size;
+                }
+                else
+                {
+                    place(std::move(e));
+                }
+            }
+            if (m_size == 0 && now > m_now)
+                m_now = now;
+        }
+    }
+
+    size_t size() const { return m_size; }
+    bool empty() const { return m_size == 0; }
+    int64_t now() const { return m_now; }
+
+    void clear()
+    {
+        for (auto & level : m_slots)
+            for (auto & slot : level)
+                slot.clear();
+        m_overflow.clear();
+        m_due.clear();
+        m_size = 0;
+    }
+
+private:
+    typedef std::pair<int64_t, T> Entry;
+
+    static const int LEVELS = 3;
+    static const int SLOT_BITS = 8;
+    static const int SLOTS = 1 << SLOT_BITS;
+    static const int64_t MASK = SLOTS - 1;
+
+    void place(Entry && e)
+    {
+        if (e.first <= m_now)
+        {
+            m_due.push_back(std::move(e));
+            return;
+        }
+        // lowest level where the deadline shares all higher digits with now
+        for (int level = 0; level < LEVELS; ++level)
+        {
+            const int shift = SLOT_BITS * (level + 1);
+            if ((e.first >> shift) == (m_now >> shift))
+            {
+                m_slots[level][(e.first >> (SLOT_BITS * level)) & MASK].push_back(std::move(e));
+                return;
+            }
+        }
+        m_overflow.push_back(std::move(e));
+    }
+
+    void cascade(std::vector<Entry> & slot)
+    {
+        std::vector<Entry> entries;
+        entries.swap(slot);
+        for (auto & e : entries)
+            place(std::move(e));
+    }
+
+    std::vector<Entry> m_slots[LEVELS][SLOTS];
+    std::vector<Entry> m_overflow;
+    std::vector<Entry> m_due;
+    int64_t m_now;
+    size_t m_size{0};
+};
+
+} // namespace xbridge
+
+#endif // BLOCKNET_XBRIDGE_UTIL_TIMERWHEEL_H
@@ -29,13 +29,17 @@
 #include <xbridge/xuiconnector.h>
 #include <xrouter/xrouterapp.h>
 
+#include <hash.h>
 #include <net.h>
 #include <netmessagemaker.h>
 #include <rpc/server.h>
 #include <servicenode/servicenodemgr.h>
 #include <shutdown.h>
 #include <sync.h>
+#include <txmempool.h>
 #include <ui_interface.h>
+#include <validation.h>
+#include <validationinterface.h>
 #include <version.h>
 
 #include <algorithm>
@@ -71,6 +75,126 @@ bool CanAffordFeePayment(const CAmount & fee) {
     return App::instance().canAffordFeePayment(fee);
 }
 
+static std::vector<COutPoint> toOutPoints(const std::set<wallet::UtxoEntry> & utxos) {
+    std::vector<COutPoint> outs;
+    outs.reserve(utxos.size());
+    for (const auto & utxo : utxos)
+        outs.emplace_back(uint256S(utxo.txId), utxo.vout);
+    return outs;
+}
+
+/**
+ * Changes when wallets are (un)loaded. Chain and mempool updates are applied
+ * to the fee ledger by FeeLedgerNotifier.
+ */
+static uint256 feeLedgerVersion() {
+    CHashWriter ss(SER_GETHASH, 0);
+#ifdef ENABLE_WALLET
+    for (const auto & wallet : GetWallets())
+        ss << wallet->GetName();
+#endif // ENABLE_WALLET
+    return ss.GetHash();
+}
+
+/**
+ * Fee transactions only spend p2pkh.
+ */
+static bool isFeeScript(const CScript & script) {
+    return script.size() == 25 && script[0] == OP_DUP && script[1] == OP_HASH160 && script[2] == 0x14 &&
+           script[23] == OP_EQUALVERIFY && script[24] == OP_CHECKSIG;
+}
+
+/**
+ * Keeps the fee ledger in step with the chain and the mempool, so that it is
+ * only rebuilt from the wallets when they change or a block is disconnected.
+ */
+class FeeLedgerNotifier : public CValidationInterface
+{
+protected:
+    void TransactionAddedToMempool(const CTransactionRef & tx) override {
+        App & xapp = App::instance();
+        LOCK(xapp.m_utxosLock);
+        for (const auto & in : tx->vin)
+            xapp.m_feeLedger.spend(in.prevout);
+    }
+
+    void TransactionRemovedFromMempool(const CTransactionRef & tx) override {
+        App & xapp = App::instance();
+        LOCK(xapp.m_utxosLock);
+        for (const auto & in : tx->vin)
+            xapp.m_feeLedger.unspend(in.prevout);
+    }
+
+    void BlockConnected(const std::shared_ptr<const CBlock> & block, const CBlockIndex *pindex,
+                        const std::vector<CTransactionRef> & txnConflicted) override
+    {
+#ifdef ENABLE_WALLET
+        App & xapp = App::instance();
+        {
+            LOCK(xapp.m_utxosLock);
+            if (!xapp.m_feeLedger.current(feeLedgerVersion())) {
+                xapp.m_feeLedger.invalidate(); // a rebuild in progress may have missed the block
+                return;
+            }
+        }
+
+        // Coinbase and coinstake outputs become spendable once they mature
+        CBlock matured;
+        const auto & consensus = Params().GetConsensus();
+        const CBlockIndex *pmatured = pindex->GetAncestor(pindex->nHeight - consensus.coinMaturity);
+        if (pmatured && pmatured != pindex && !ReadBlockFromDisk(matured, pmatured, consensus)) {
+            LOCK(xapp.m_utxosLock);
+            xapp.m_feeLedger.invalidate();
+            return;
+        }
+
+        const auto wallets = GetWallets();
+        FeeLedger::Coins added;
+        auto addMine = [&](const ::CTransaction & tx) {
+            for (uint32_t n = 0; n < tx.vout.size(); ++n) {
+                const auto & out = tx.vout[n];
+                if (!isFeeScript(out.scriptPubKey))
+                    continue;
+                for (const auto & wallet : wallets) {
+                    if (wallet->IsMine(out) & ISMINE_SPENDABLE) {
+                        added.emplace_back(COutPoint(tx.GetHash(), n), out.nValue);
+                        break;
+                    }
+                }
+            }
+        };
+        for (const auto & tx : block->vtx) {
+            if (!tx->IsCoinBase() && !tx->IsCoinStake())
+                addMine(*tx);
+        }
+        for (const auto & tx : matured.vtx) {
+            if (tx->IsCoinBase() || tx->IsCoinStake())
+                addMine(*tx);
+        }
+
+        LOCK(xapp.m_utxosLock);
+        for (const auto & tx : txnConflicted) {
+            for (const auto & in : tx->vin)
+                xapp.m_feeLedger.unspend(in.prevout);
+        }
+        for (const auto & tx : block->vtx) {
+            for (const auto & in : tx->vin)
+                xapp.m_feeLedger.remove(in.prevout);
+        }
+        for (const auto & coin : added)
+            xapp.m_feeLedger.add(coin.first, coin.second);
+#endif // ENABLE_WALLET
+    }
+
+    void BlockDisconnected(const std::shared_ptr<const CBlock> & block) override {
+        App & xapp = App::instance();
+        LOCK(xapp.m_utxosLock);
+        xapp.m_feeLedger.invalidate();
+    }
+};
+
+static FeeLedgerNotifier feeLedgerNotifier;
+
 //*****************************************************************************
 //*****************************************************************************
 void badaboom()
@@ -268,7 +392,7 @@ protected:
 App::Impl::Impl()
     : m_timerIoWork(new boost::asio::io_service::work(m_timerIo))
     , m_timerThread(boost::bind(&boost::asio::io_service::run, &m_timerIo))
-    , m_timer(m_timerIo, boost::posix_time::seconds(TIMER_INTERVAL))
+    , m_timer(m_timerIo, boost::posix_time::seconds(static_cast<long>(TIMER_INTERVAL)))
 {
 
 }
@@ -390,6 +514,8 @@ bool App::start()
     // Restore local orders
     loadOrders();
 
+    RegisterValidationInterface(&feeLedgerNotifier, "xbridge");
+
     return s;
 }
 
@@ -459,6 +585,8 @@ bool App::stop()
         return true;
     m_stopped = true;
 
+    UnregisterValidationInterface(&feeLedgerNotifier);
+
     // Save db state
     saveOrders(true);
 
@@ -1368,11 +1496,13 @@ void App::appendTransaction(const TransactionDescrPtr & ptr)
     {
         // new transaction, copy data
         m_p->m_transactions[ptr->id] = ptr;
+        markOrderDirty(ptr->id);
     }
     else
     {
         // existing, update timestamp
         m_p->m_transactions[ptr->id]->updateTimestamp(*ptr);
+        ordersChanged();
     }
 }
 
@@ -1405,6 +1535,7 @@ void App::moveTransactionToHistory(const uint256 & id)
             }
             xtx->moveToHistory();
             m_p->m_historicTransactions[id] = xtx;
+            markOrderDirty(id);
         }
     }
 
@@ -1663,9 +1794,10 @@ xbridge::Error App::sendXBridgeTransaction(const std::string & from,
     }
 
     // sign used coins
+    connFrom->signUtxos(outputsForUse);
     for (auto & entry : outputsForUse) {
         std::string signature;
-        if (!connFrom->signMessage(entry.address, entry.toString(), signature)) {
+        if (!connFrom->signUtxo(entry, signature)) {
             WARN() << "funds not signed <" << fromCurrency << "> " << __FUNCTION__;
             return xbridge::Error::FUNDS_NOT_SIGNED;
         }
@@ -1856,9 +1988,10 @@ xbridge::Error App::sendXBridgeTransaction(const std::string & from,
                 }
 
                 // sign used coins
+                connFrom->signUtxos(ptr->usedCoins);
                 for (auto & entry : ptr->usedCoins) {
                     std::string signature;
-                    if (!connFrom->signMessage(entry.address, entry.toString(), signature)) {
+                    if (!connFrom->signUtxo(entry, signature)) {
                         unlockCoins(ptr->fromCurrency, ptr->usedCoins);
                         UniValue log_obj(UniValue::VOBJ);
                         log_obj.pushKV("orderid", "unknown");
@@ -1916,6 +2049,7 @@ xbridge::Error App::sendXBridgeTransaction(const std::string & from,
                     LOCK(m_lock);
                     m_partialOrders.push_back(ptr);
                 }
+                markOrderDirty(ptr->id);
             }
         }
     }
@@ -1966,6 +2100,7 @@ xbridge::Error App::sendXBridgeTransaction(const std::string & from,
         LOCK(m_p->m_txLocker);
         m_p->m_transactions[id] = ptr;
     }
+    markOrderDirty(id);
 
     return xbridge::Error::SUCCESS;
 }
@@ -2058,11 +2193,13 @@ Error App::acceptXBridgeTransaction(const uint256 & id, const std::string & from
     }
     const auto priorState = ptr->state;
     ptr->state = TransactionDescr::trAccepting;
+    markOrderDirty(ptr->id);
     ptr->fromAmount = fromSize;
     ptr->toAmount = toSize;
 
-    auto revertOrder = [priorState](TransactionDescrPtr & ptr){
+    auto revertOrder = [this, priorState](TransactionDescrPtr & ptr){
         ptr->state = priorState;
+        markOrderDirty(ptr->id);
         ptr->fromAmount = ptr->origFromAmount;
         ptr->toAmount = ptr->origToAmount;
     };
@@ -2197,7 +2334,13 @@ Error App::acceptXBridgeTransaction(const uint256 & id, const std::string & from
         }
 
         // Lock the fee utxos
-        lockFeeUtxos(ptr->feeUtxos);
+        if (!lockFeeUtxos(ptr->feeUtxos)) {
+            revertOrder(ptr);
+            xbridge::LogOrderMsg(id.GetHex(), "order not accepted, service node fee inputs are already in use", __FUNCTION__);
+            ptr->feeUtxos.clear();
+            ptr->rawFeeTx.clear();
+            return xbridge::Error::INSIFFICIENT_FUNDS;
+        }
 
         // Exclude the used uxtos
         excludedUtxos = getAllLockedUtxos(connFrom->currency);
@@ -2238,11 +2381,12 @@ Error App::acceptXBridgeTransaction(const uint256 & id, const std::string & from
         }
 
         // sign used coins
+        connFrom->signUtxos(outputsForUse);
         for (wallet::UtxoEntry & entry : outputsForUse)
         {
             xbridge::Error err = xbridge::Error::SUCCESS;
             std::string signature;
-            if (!connFrom->signMessage(entry.address, entry.toString(), signature))
+            if (!connFrom->signUtxo(entry, signature))
             {
                 xbridge::LogOrderMsg(id.GetHex(), "not accepting order, funds not signed <" + ptr->fromCurrency + ">", __FUNCTION__);
                 err = xbridge::Error::FUNDS_NOT_SIGNED;
@@ -2525,6 +2669,7 @@ bool App::watchForSpentDeposit(TransactionDescrPtr tr) {
     LOCK(m_p->m_watchDepositsLocker);
     tr->setWatchingForSpentDeposit(true);
     m_p->m_watchDeposits[tr->id] = tr;
+    markOrderDirty(tr->id);
     return true;
 }
 
@@ -2540,6 +2685,7 @@ void App::unwatchSpentDeposit(TransactionDescrPtr tr) {
     LOCK(m_p->m_watchDepositsLocker);
     m_p->m_watchDeposits.erase(tr->id);
     tr->setWatchingForSpentDeposit(false);
+    markOrderDirty(tr->id);
 }
 
 //******************************************************************************
@@ -2734,17 +2880,25 @@ const std::set<xbridge::wallet::UtxoEntry> App::getFeeUtxos() {
 
 //******************************************************************************
 //******************************************************************************
-void App::lockFeeUtxos(std::set<xbridge::wallet::UtxoEntry> & feeUtxos) {
+bool App::lockFeeUtxos(std::set<xbridge::wallet::UtxoEntry> & feeUtxos) {
     LOCK(m_utxosLock);
+    // Concurrent fee payments (xrouter calls, orders) must never share inputs
+    if (!m_feeLedger.reserve(toOutPoints(feeUtxos)))
+        return false;
     m_feeUtxos.insert(feeUtxos.begin(), feeUtxos.end());
+    return true;
 }
 
 //******************************************************************************
 //******************************************************************************
 void App::unlockFeeUtxos(std::set<xbridge::wallet::UtxoEntry> & feeUtxos) {
     LOCK(m_utxosLock);
-    for (const auto & utxo : feeUtxos)
-        m_feeUtxos.erase(utxo);
+    std::set<wallet::UtxoEntry> released;
+    for (const auto & utxo : feeUtxos) {
+        if (m_feeUtxos.erase(utxo))
+            released.insert(utxo);
+    }
+    m_feeLedger.release(toOutPoints(released));
 }
 
 //******************************************************************************
@@ -2775,6 +2929,8 @@ bool App::lockCoins(const std::string & token, const std::vector<wallet::UtxoEnt
     if (!m_utxosDict.count(token)) {
         std::set<wallet::UtxoEntry> o(utxos.begin(), utxos.end());
         m_utxosDict[token] = o;
+        if (token == "BLOCK")
+            m_feeLedger.hold(toOutPoints(o));
         return true;
     }
 
@@ -2786,7 +2942,10 @@ bool App::lockCoins(const std::string & token, const std::vector<wallet::UtxoEnt
     }
 
     // Add new utxos
-    o.insert(utxos.begin(), utxos.end());
+    const std::set<wallet::UtxoEntry> added(utxos.begin(), utxos.end());
+    o.insert(added.begin(), added.end());
+    if (token == "BLOCK")
+        m_feeLedger.hold(toOutPoints(added));
 
     return true;
 }
@@ -2802,31 +2961,42 @@ void App::unlockCoins(const std::string & token, const std::vector<wallet::UtxoE
 
     // Remove utxos if they exist
     auto & o = m_utxosDict[token];
+    std::set<wallet::UtxoEntry> removed;
     for (const wallet::UtxoEntry & u : utxos)
-        if (o.count(u))
-            o.erase(u);
+        if (o.erase(u))
+            removed.insert(u);
+    if (token == "BLOCK")
+        m_feeLedger.release(toOutPoints(removed));
 }
 
 //******************************************************************************
 //******************************************************************************
 bool App::canAffordFeePayment(const CAmount & fee) {
 #ifdef ENABLE_WALLET
-    const auto & lockedUtxos = getAllLockedUtxos("BLOCK");
-    auto coins = availableCoins(true, 1); // at least 1-conf
+    const auto version = feeLedgerVersion();
+    uint64_t changes{0};
+    {
+        LOCK(m_utxosLock);
+        if (m_feeLedger.current(version))
+            return m_feeLedger.canAfford(fee);
+        changes = m_feeLedger.changes();
+    }
 
-    CAmount running{0};
-    for (const auto & out : coins) {
-        wallet::UtxoEntry entry;
-        entry.txId = out.first.hash.ToString();
-        entry.vout = out.first.n;
-        if (!lockedUtxos.count(entry)) {
-            running += out.second.nValue;
-            if (running >= fee)
-                return true;
-        }
+    // Rebuild the ledger without holding the utxo lock, the wallets take cs_main
+    FeeLedger::Coins coins;
+    for (const auto & out : availableCoins(true, 1)) { // at least 1-conf
+        if (isFeeScript(out.second.scriptPubKey))
+            coins.emplace_back(out.first, out.second.nValue);
     }
-#endif
+
+    LOCK(m_utxosLock);
+    // Updates applied while the wallets were read would be lost, rebuild
+    // again on the next check
+    m_feeLedger.reset(coins, m_feeLedger.changes() == changes ? version : uint256());
+    return m_feeLedger.canAfford(fee);
+#else
     return false;
+#endif // ENABLE_WALLET
 }
 
 //******************************************************************************
@@ -2837,7 +3007,9 @@ std::vector<CPubKey> App::Impl::findShuffledNodesWithService(
     const std::set<CPubKey> & notIn) const
 {
     std::vector<CPubKey> list;
-    const auto & snodes = sn::ServiceNodeMgr::instance().list();
+    if (requested_services.empty())
+        return list;
+    const auto & snodes = sn::ServiceNodeMgr::instance().listWithServices(requested_services);
     for (const auto& x : snodes)
     {
         if (x.getXBridgeVersion() != version || notIn.count(x.getSnodePubKey()) || !x.running())
@@ -2853,15 +3025,7 @@ std::vector<CPubKey> App::Impl::findShuffledNodesWithService(
                 continue;
         }
 
-        const auto& wallet_services = std::set<std::string>{x.serviceList().begin(), x.serviceList().end()};
-        auto searchCounter = requested_services.size();
-        for (const std::string & serv : requested_services)
-        {
-            if (not wallet_services.count(serv))
-                break;
-            if (--searchCounter == 0)
-                list.push_back(x.getSnodePubKey());
-        }
+        list.push_back(x.getSnodePubKey());
     }
     static std::default_random_engine rng{0};
     std::shuffle(list.begin(), list.end(), rng);
@@ -2879,10 +3043,13 @@ std::vector<CPubKey> App::Impl::findShuffledNodesWithService(
 //******************************************************************************
 bool App::Impl::hasNodeService(const CPubKey & nodePubKey, const std::string & service, bool checkRunning)
 {
-    const auto & snode = sn::ServiceNodeMgr::instance().getSn(nodePubKey);
-    if (snode.isNull() || (checkRunning && !snode.running()))
+    auto & smgr = sn::ServiceNodeMgr::instance();
+    if (!smgr.hasService(nodePubKey, service))
         return false;
-    return snode.hasService(service);
+    if (!checkRunning)
+        return true;
+    const auto & snode = smgr.getSn(nodePubKey);
+    return !snode.isNull() && snode.running();
 }
 
 //******************************************************************************
@@ -3194,6 +3361,7 @@ void App::Impl::checkAndRelayPendingOrders() {
             }
 
             order->updateTimestamp();
+            App::instance().markOrderDirty(order->id);
             // Only broadcast the order if the utxos are still valid
             if (orderUtxosAreStillValid(order))
                 sendPendingTransaction(order);
@@ -3202,6 +3370,7 @@ void App::Impl::checkAndRelayPendingOrders() {
         }
         else if (pendingOrderShouldRebroadcast && order->state == xbridge::TransactionDescr::trPending) {
             order->updateTimestamp();
+            App::instance().markOrderDirty(order->id);
 
             // Check that snode order is assigned to is still valid
             CPubKey oldsnode;
@@ -3308,6 +3477,7 @@ void App::Impl::checkWatchesOnDepositSpends()
                     }
                     txids.insert(txids.end(), txs.begin(), txs.end());
                     xtx->setWatchBlock(++blocks); // mark that we've processed current block
+                    App::instance().markOrderDirty(xtx->id);
                 }
 
                 // If any failure, skip
@@ -3324,6 +3494,7 @@ void App::Impl::checkWatchesOnDepositSpends()
                     // Found valid spent pay tx, now assign
                     xtx->setOtherPayTxId(txid);
                     xtx->doneWatching(); // report that we're done looking
+                    App::instance().markOrderDirty(xtx->id);
                     break;
                 }
             }
@@ -3339,6 +3510,7 @@ void App::Impl::checkWatchesOnDepositSpends()
             int32_t errCode = 0;
             if (session->redeemOrderDeposit(xtx, errCode)) {
                 xtx->state = TransactionDescr::trRollback;
+                App::instance().markOrderDirty(xtx->id);
                 done = true;
             }
         }
@@ -3349,6 +3521,7 @@ void App::Impl::checkWatchesOnDepositSpends()
             int32_t errCode = 0;
             if (session->redeemOrderCounterpartyDeposit(xtx, errCode)) {
                 xtx->state = TransactionDescr::trFinished;
+                App::instance().markOrderDirty(xtx->id);
                 done = true;
             }
         }
@@ -3357,7 +3530,7 @@ void App::Impl::checkWatchesOnDepositSpends()
             xtx->doneWatching();
             xbridge::App & xapp = xbridge::App::instance();
             xapp.unwatchSpentDeposit(xtx);
-            xapp.saveOrders(true);
+            xapp.saveOrders();
         }
 
         xtx->setWatching(false);
@@ -3534,6 +3707,7 @@ void App::Impl::checkAndEraseExpiredTransactions()
         }
         if (stateChanged)
         {
+            App::instance().markOrderDirty(tx->id);
             xuiConnector.NotifyXBridgeTransactionChanged(tx->id);
         }
     }
@@ -3545,6 +3719,8 @@ void App::Impl::checkAndEraseExpiredTransactions()
             m_transactions.erase(id);
         }
     }
+    if (!forErase.empty())
+        App::instance().ordersChanged();
     // ...and notify
 //    for (const uint256 & id : forErase)
 //    {
@@ -3638,15 +3814,12 @@ void App::Impl::onTimer()
                 io->post(boost::bind(&xbridge::App::processPendingPartialOrders, app));
         }
 
-        // Save orders states every so often
-        {
-            static uint32_t counter{0};
-            if (++counter % 4 == 0)
-                app->saveOrders();
-        }
+        // Save order state changes, this only appends changed orders
+        // to the orders journal
+        app->saveOrders();
     }
 
-    m_timer.expires_at(m_timer.expires_at() + boost::posix_time::seconds(TIMER_INTERVAL));
+    m_timer.expires_at(m_timer.expires_at() + boost::posix_time::seconds(static_cast<long>(TIMER_INTERVAL)));
     m_timer.async_wait(boost::bind(&Impl::onTimer, this));
 }
 
@@ -3691,6 +3864,7 @@ void App::removePendingPartialOrder(TransactionDescrPtr ptr) {
         if (ptr->id == it->get()->id) {
             ptr->setPartialOrderPending(false);
             m_partialOrders.erase(it);
+            markOrderDirty(ptr->id);
             break;
         }
         ++it;
@@ -3718,6 +3892,7 @@ void App::clearNonLocalOrders() {
         LOCK(m_p->m_connectorsLock);
         if (!m_p->m_connectorCurrencyMap.count(ptr->fromCurrency) || !m_p->m_connectorCurrencyMap.count(ptr->toCurrency)) {
             m_p->m_transactions.erase(it++);
+            ordersChanged();
         } else {
             ++it;
         }
@@ -3762,39 +3937,78 @@ void App::loadOrders() {
         if (tr->isPartialOrderPending())
             m_partialOrders.push_back(tr);
     }
+    ordersChanged();
 }
 
-void App::saveOrders(bool force) {
+void App::saveOrders(bool compact) {
     LOCK(m_lock);
 
+    // Only orders queued by their state mutators are appended to the
+    // orders journal. A compacting save writes every live order so that
+    // changes not queued by a mutator are not lost.
+    std::set<uint256> dirty;
     {
-        LOCK(m_p->m_txLocker);
-        if (m_p->m_transactions.empty() && m_p->m_historicTransactions.empty() && m_partialOrders.empty())
-            return;
+        LOCK(m_dirtyOrdersLock);
+        dirty.swap(m_dirtyOrders);
     }
 
-    XOrderSet orders;
-    if (!xdb.Read(orders)) {
-        UniValue erro(UniValue::VOBJ);
-        LogOrderMsg(erro, "Failed to load existing orders database", __FUNCTION__);
-    }
-
-    {
+    std::vector<TransactionDescrPtr> orders;
+    if (compact) {
         LOCK(m_p->m_txLocker);
-        for (auto & order : m_p->m_transactions) {
-            if (order.second->isLocal())
-                orders[order.first] = *order.second;
-        }
-        for (auto & order : m_p->m_historicTransactions) {
-            if (order.second->isLocal())
-                orders[order.first] = *order.second;
+        for (const auto & item : m_p->m_transactions)
+            if (item.second->isLocal())
+                orders.push_back(item.second);
+        for (const auto & item : m_p->m_historicTransactions)
+            if (item.second->isLocal())
+                orders.push_back(item.second);
+        for (const auto & order : m_partialOrders)
+            if (!m_p->m_transactions.count(order->id) && !m_p->m_historicTransactions.count(order->id))
+                orders.push_back(order);
+    } else if (!dirty.empty()) {
+        LOCK(m_p->m_txLocker);
+        orders.reserve(dirty.size());
+        for (const auto & id : dirty) {
+            auto it = m_p->m_transactions.find(id);
+            if (it != m_p->m_transactions.end()) {
+                if (it->second->isLocal())
+                    orders.push_back(it->second);
+                continue;
+            }
+            it = m_p->m_historicTransactions.find(id);
+            if (it != m_p->m_historicTransactions.end()) {
+                if (it->second->isLocal())
+                    orders.push_back(it->second);
+                continue;
+            }
+            for (auto & order : m_partialOrders) {
+                if (order->id == id) {
+                    orders.push_back(order);
+                    break;
+                }
+            }
         }
-        for (auto & order : m_partialOrders) {
-            orders[order->id] = *order;
+    }
+
+    if (!orders.empty() && !xdb.Write(orders)) {
+        {
+            // Retry on the next save
+            LOCK(m_dirtyOrdersLock);
+            m_dirtyOrders.insert(dirty.begin(), dirty.end());
         }
+        UniValue erro(UniValue::VOBJ);
+        LogOrderMsg(erro, "Failed to write orders database journal", __FUNCTION__);
+        return;
     }
+    if (compact && !xdb.Compact()) {
+        UniValue erro(UniValue::VOBJ);
+        LogOrderMsg(erro, "Failed to compact orders database", __FUNCTION__);
+    }
+}
 
-    xdb.Write(orders, force);
+void App::markOrderDirty(const uint256 & id) {
+    ordersChanged();
+    LOCK(m_dirtyOrdersLock);
+    m_dirtyOrders.insert(id);
 }
 
 uint256 App::orderWithUtxo(const wallet::UtxoEntry & utxo) {
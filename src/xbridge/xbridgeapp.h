@@ -12,6 +12,7 @@
 #include <xbridge/util/xutil.h>
 #include <xbridge/xbridgedb.h>
 #include <xbridge/xbridgedef.h>
+#include <xbridge/xbridgefeeledger.h>
 #include <xbridge/xbridgepacket.h>
 #include <xbridge/xbridgetransactiondescr.h>
 #include <xbridge/xbridgewalletconnector.h>
@@ -57,6 +58,8 @@ extern WalletConnectorPtr ConnectorByCurrency(const std::string & currency);
 //*****************************************************************************
 class App
 {
+    friend class FeeLedgerNotifier;
+
     class Impl;
 
 private:
@@ -596,9 +599,11 @@ public:
 
     /**
      * @brief Lock the specified fee utxos. This prevents fee utxos from being used in orders.
+     * Returns false without locking anything if one of the utxos is already locked.
      * @param feeUtxos
+     * @return
      */
-    void lockFeeUtxos(std::set<xbridge::wallet::UtxoEntry> & feeUtxos);
+    bool lockFeeUtxos(std::set<xbridge::wallet::UtxoEntry> & feeUtxos);
 
     /**
      * @brief Unlocks the fee utxos, allowing them to be used in orders.
@@ -633,7 +638,9 @@ public:
 
     /**
      * @brief Returns true if xbridge can afford to pay the specified BLOCK fee. i.e. there's
-     * sufficient utxos available to cover the fee.
+     * sufficient unlocked confirmed p2pkh utxos available to cover the fee. The fee ledger
+     * follows chain and mempool notifications and is only rebuilt from the wallets when
+     * they change or a block is disconnected.
      * @param fee
      * @return true if can afford to pay fee, otherwise false
      */
@@ -708,9 +715,34 @@ public:
     void loadOrders();
 
     /**
-     * Save the orders to the persistent storage.
+     * Save the order state changes to the persistent storage.
+     * @param compact Write every live order and merge the orders journal into
+     * the orders snapshot.
+     */
+    void saveOrders(bool compact = false);
+
+    /**
+     * Queue the order for the next orders journal write. Called by the order
+     * state mutators, saveOrders only writes queued orders.
+     * @param id
      */
-    void saveOrders(bool force = false);
+    void markOrderDirty(const uint256 & id);
+
+    /**
+     * Returns the version of the order book, which changes whenever orders
+     * are added, removed, refreshed or change state.
+     * @return
+     */
+    uint64_t ordersVersion() const {
+        return m_ordersVersion;
+    }
+
+    /**
+     * Bump the order book version.
+     */
+    void ordersChanged() {
+        ++m_ordersVersion;
+    }
 
     /**
      * Returns the order that contains the specified utxo. If no order
@@ -742,10 +774,14 @@ private:
     std::vector<TransactionDescrPtr> m_partialOrders;
     std::set<xbridge::wallet::UtxoEntry> m_feeUtxos;
     std::map<std::string, std::set<xbridge::wallet::UtxoEntry> > m_utxosDict;
+    FeeLedger m_feeLedger; // BLOCK fee inputs, requires m_utxosLock
     CCriticalSection m_utxosLock;
     CCriticalSection m_utxosOrderLock;
 
     XBridgeDB xdb;
+    std::set<uint256> m_dirtyOrders; // orders changed since the last save, requires m_dirtyOrdersLock
+    CCriticalSection m_dirtyOrdersLock;
+    std::atomic<uint64_t> m_ordersVersion{0};
     std::vector<std::string> utxwallets; // unit tests only
 };
 
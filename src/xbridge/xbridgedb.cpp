@@ -104,23 +104,107 @@ bool DeserializeFileDB(const fs::path& path, Data& data)
 }
 
 
-XBridgeDB::XBridgeDB() : pathDB(GetDataDir() / "orders.dat") { }
+XBridgeDB::XBridgeDB() : pathDB(GetDataDir() / "orders.dat"), pathJournal(GetDataDir() / "orders.log") { }
 
-bool XBridgeDB::Write(const XOrderSet & orderSet, bool force) {
-    if (orderSet.empty() && lastOrdersEmpty) // prevent writing empty set
-        return false;
-    if (!force && !ShouldSave()) // prevent saving too soon
-        return false;
-    auto saved = SerializeFileDB("orders", pathDB, orderSet);
-    if (saved) {
-        lastOrdersEmpty = orderSet.empty();
-        lastsave = boost::posix_time::microsec_clock::universal_time();
+bool XBridgeDB::Write(const std::vector<TransactionDescrPtr> & orders) {
+    if (orders.empty())
+        return true;
+
+    CDataStream ss(SER_DISK, CLIENT_VERSION);
+    for (const auto & order : orders) {
+        CDataStream record(SER_DISK, CLIENT_VERSION);
+        record << order->id << *order;
+        // Journal record: magic, payload, checksum
+        ss << Params().MessageStart() << std::vector<unsigned char>(record.begin(), record.end())
+           << Hash(record.begin(), record.end());
     }
-    return saved;
+
+    FILE *file = fsbridge::fopen(pathJournal, "ab");
+    CAutoFile fileout(file, SER_DISK, CLIENT_VERSION);
+    if (fileout.IsNull())
+        return error("%s: Failed to open file %s", __func__, pathJournal.string());
+    try {
+        fileout.write(ss.data(), ss.size());
+    } catch (const std::exception& e) {
+        return error("%s: Serialize or I/O error - %s", __func__, e.what());
+    }
+    if (!FileCommit(fileout.Get()))
+        return error("%s: Failed to flush file %s", __func__, pathJournal.string());
+    fileout.fclose();
+
+    for (const auto & order : orders)
+        persisted.insert(order->id);
+    journalRecords += static_cast<uint32_t>(orders.size());
+
+    if (ShouldCompact())
+        return Compact();
+    return true;
+}
+
+bool XBridgeDB::ReadJournal(XOrderSet & orderSet, bool & corrupt) {
+    corrupt = false;
+    journalRecords = 0;
+    if (!fs::exists(pathJournal))
+        return true;
+
+    FILE *file = fsbridge::fopen(pathJournal, "rb");
+    CAutoFile filein(file, SER_DISK, CLIENT_VERSION);
+    if (filein.IsNull())
+        return error("%s: Failed to open file %s", __func__, pathJournal.string());
+
+    // Replay records until the end of the journal. A partially written record
+    // (e.g. on crash) ends the replay, the records before it are intact.
+    const auto size = fs::file_size(pathJournal);
+    while (static_cast<uintmax_t>(ftell(filein.Get())) < size) {
+        try {
+            unsigned char pchMsgTmp[4];
+            filein >> pchMsgTmp;
+            if (memcmp(pchMsgTmp, Params().MessageStart(), sizeof(pchMsgTmp))) {
+                corrupt = true;
+                break;
+            }
+            std::vector<unsigned char> payload;
+            uint256 hash;
+            filein >> payload >> hash;
+            if (Hash(payload.begin(), payload.end()) != hash) {
+                corrupt = true;
+                break;
+            }
+            CDataStream record(payload, SER_DISK, CLIENT_VERSION);
+            uint256 id;
+            TransactionDescr order;
+            record >> id >> order;
+            orderSet[id] = order;
+            persisted.insert(id);
+            ++journalRecords;
+        } catch (const std::exception& e) {
+            corrupt = true;
+            break;
+        }
+    }
+
+    if (corrupt)
+        LogPrintf("%s: Ignoring incomplete record in %s after %u records\n", __func__, pathJournal.string(), journalRecords);
+    return true;
 }
 
 bool XBridgeDB::Read(XOrderSet & orderSet) {
-    return DeserializeFileDB(pathDB, orderSet);
+    if (!DeserializeFileDB(pathDB, orderSet))
+        return false;
+    persisted.clear();
+    for (const auto & item : orderSet)
+        persisted.insert(item.first);
+    bool corrupt{false};
+    if (!ReadJournal(orderSet, corrupt))
+        return false;
+    // Fold the intact records into the snapshot to get rid of the damaged
+    // journal tail, otherwise new records would be appended after it.
+    if (corrupt) {
+        if (!SerializeFileDB("orders", pathDB, orderSet))
+            return false;
+        return TruncateJournal();
+    }
+    return true;
 }
 
 bool XBridgeDB::Exists() {
@@ -128,13 +212,45 @@ bool XBridgeDB::Exists() {
 }
 
 bool XBridgeDB::Create() {
-    return Write(XOrderSet{});
+    if (!SerializeFileDB("orders", pathDB, XOrderSet{}))
+        return false;
+    // Discard any stale journal without a snapshot
+    if (fs::exists(pathJournal))
+        fs::remove(pathJournal);
+    persisted.clear();
+    journalRecords = 0;
+    return true;
+}
+
+bool XBridgeDB::Compact() {
+    if (journalRecords == 0)
+        return true;
+    XOrderSet orderSet;
+    if (!Read(orderSet))
+        return false;
+    if (!SerializeFileDB("orders", pathDB, orderSet))
+        return false;
+    // The snapshot now contains all journal records. Replaying the journal
+    // again would be harmless in case truncation fails (records hold full
+    // order states).
+    return TruncateJournal();
+}
+
+bool XBridgeDB::TruncateJournal() {
+    FILE *file = fsbridge::fopen(pathJournal, "wb");
+    if (!file)
+        return error("%s: Failed to truncate file %s", __func__, pathJournal.string());
+    if (!FileCommit(file)) {
+        fclose(file);
+        return error("%s: Failed to flush file %s", __func__, pathJournal.string());
+    }
+    fclose(file);
+    journalRecords = 0;
+    return true;
 }
 
-bool XBridgeDB::ShouldSave() {
-    const auto currentTime = boost::posix_time::microsec_clock::universal_time();
-    const auto duration = currentTime - lastsave;
-    return duration.total_seconds() >= 30;
+bool XBridgeDB::ShouldCompact() {
+    return journalRecords >= std::max<uint32_t>(XBRIDGEDB_COMPACT_MIN_RECORDS, static_cast<uint32_t>(persisted.size()));
 }
 
 }
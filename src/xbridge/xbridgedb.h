@@ -11,27 +11,44 @@
 
 #include <fs.h>
 #include <serialize.h>
+#include <set>
 #include <string>
 #include <uint256.h>
+#include <vector>
 
 namespace xbridge {
 
 typedef std::map<uint256, TransactionDescr> XOrderSet;
 
-/** XBridge order db (orders.dat) */
+/** Minimum number of journal records before the journal is compacted into the snapshot */
+static const uint32_t XBRIDGEDB_COMPACT_MIN_RECORDS = 1000;
+
+/**
+ * XBridge order db. Orders are persisted as a snapshot (orders.dat) plus an
+ * append-only journal of order states (orders.log). Each write appends the
+ * orders passed to it, callers only pass orders whose state changed. The
+ * journal is periodically compacted into the snapshot.
+ */
 class XBridgeDB
 {
 public:
     explicit XBridgeDB();
-    bool Write(const XOrderSet & orderSet, bool force = false);
+    /** Appends the orders to the journal. */
+    bool Write(const std::vector<TransactionDescrPtr> & orders);
+    /** Reads the snapshot and replays the journal on top of it. */
     bool Read(XOrderSet & orderSet);
     bool Exists();
     bool Create();
-    bool ShouldSave();
+    /** Merges the journal into the snapshot and truncates the journal. */
+    bool Compact();
+    bool ShouldCompact();
 private:
+    bool ReadJournal(XOrderSet & orderSet, bool & corrupt);
+    bool TruncateJournal();
     const fs::path pathDB;
-    boost::posix_time::ptime lastsave;
-    bool lastOrdersEmpty{false};
+    const fs::path pathJournal;
+    std::set<uint256> persisted; // ids of the persisted orders
+    uint32_t journalRecords{0};
 };
 
 }
@@ -9,7 +9,9 @@
 
 #include <xbridge/bitcoinrpcconnector.h>
 #include <xbridge/util/logger.h>
+#include <xbridge/util/posixtimeconversion.h>
 #include <xbridge/util/settings.h>
+#include <xbridge/util/timerwheel.h>
 #include <xbridge/util/xutil.h>
 #include <xbridge/xbridgewalletconnector.h>
 
@@ -19,6 +21,7 @@
 #include <pubkey.h>
 #include <servicenode/servicenodemgr.h>
 #include <sync.h>
+#include <validation.h>
 
 #include <algorithm>
 
@@ -34,6 +37,12 @@ bool ExchangeUtxos(const uint256 & txid, std::vector<wallet::UtxoEntry> & items)
     return Exchange::instance().getUtxoItems(txid, items);
 }
 
+// current time in the resolution of the expiry wheel
+static int64_t expiryNow()
+{
+    return boost::posix_time::to_time_t(boost::posix_time::microsec_clock::universal_time());
+}
+
 //******************************************************************************
 //******************************************************************************
 class Exchange::Impl
@@ -45,6 +54,8 @@ protected:
 
     std::list<TransactionPtr> transactions(bool onlyFinished) const;
 
+    void scheduleExpiry(const TransactionPtr & tr, const bool byTime, const bool byHeight);
+
 protected:
     // connected wallets
     typedef std::map<std::string, WalletParam> WalletList;
@@ -54,6 +65,10 @@ protected:
     mutable CCriticalSection                           m_pendingTransactionsLock;
     std::map<uint256, uint256>                         m_hashToIdMap;
     std::map<uint256, TransactionPtr>                  m_pendingTransactions;
+    // pending transactions by ttl deadline and expiry block height, entries
+    // are checked again when due and can refer to already removed transactions
+    TimerWheel<std::weak_ptr<Transaction> >            m_pendingExpiry{expiryNow()};
+    std::multimap<int, std::weak_ptr<Transaction> >    m_pendingExpiryByHeight;
 
     mutable CCriticalSection                           m_transactionsLock;
     std::map<uint256, TransactionPtr>                  m_transactions;
@@ -67,6 +82,27 @@ protected:
     std::vector<unsigned char>                         m_privkey;
 };
 
+//*****************************************************************************
+// requires m_pendingTransactionsLock
+//*****************************************************************************
+void Exchange::Impl::scheduleExpiry(const TransactionPtr & tr, const bool byTime, const bool byHeight)
+{
+    if (byTime)
+    {
+        m_pendingExpiry.schedule(tr->expiryTime(), tr);
+    }
+    if (byHeight)
+    {
+        int height = tr->expiryBlockHeight();
+        if (height < 0)
+        {
+            // unknown block, check again on the next pass
+            height = GetChainTipHeight();
+        }
+        m_pendingExpiryByHeight.emplace(height, tr);
+    }
+}
+
 //*****************************************************************************
 //*****************************************************************************
 Exchange::Exchange()
@@ -375,32 +411,33 @@ bool Exchange::createTransaction(const uint256                        & txid,
     {
         LOCK(m_p->m_pendingTransactionsLock);
 
-        if (!m_p->m_pendingTransactions.count(txid))
+        auto it = m_p->m_pendingTransactions.find(txid);
+        if (it == m_p->m_pendingTransactions.end())
         {
             // new transaction
             isCreated = true;
             m_p->m_pendingTransactions[txid] = tr;
+            m_p->scheduleExpiry(tr, true, true);
         }
         else
         {
-            m_p->m_pendingTransactions[txid]->m_lock.lock();
+            TransactionPtr & existing = it->second;
+            existing->m_lock.lock();
 
             // found, check if expired
-            if (!m_p->m_pendingTransactions[txid]->isExpired())
+            if (!existing->isExpired())
             {
-                m_p->m_pendingTransactions[txid]->updateTimestamp();
+                existing->updateTimestamp();
 
-                m_p->m_pendingTransactions[txid]->m_lock.unlock();
+                existing->m_lock.unlock();
             }
             else
             {
-                m_p->m_pendingTransactions[txid]->m_lock.unlock();
+                existing->m_lock.unlock();
 
-                // if expired - delete old transaction
-                m_p->m_pendingTransactions.erase(txid);
-
-                // create new
-                m_p->m_pendingTransactions[txid] = tr;
+                // if expired - replace old transaction with the new one
+                existing = tr;
+                m_p->scheduleExpiry(tr, true, true);
             }
         }
     }
@@ -720,27 +757,59 @@ size_t Exchange::eraseExpiredTransactions()
 
     LOCK(m_p->m_pendingTransactionsLock);
 
-    // Use non-hoisted iterator to prevent invalidation during erase
-    for (auto it = m_p->m_pendingTransactions.cbegin(); it != m_p->m_pendingTransactions.cend(); )
+    // Only orders whose ttl deadline or expiry height came up are checked
+    std::vector<std::weak_ptr<Transaction> > dueByTime;
+    m_p->m_pendingExpiry.advance(expiryNow(), dueByTime);
+
+    std::vector<std::weak_ptr<Transaction> > dueByHeight;
+    const int height = GetChainTipHeight();
+    auto & byHeight = m_p->m_pendingExpiryByHeight;
+    for (auto it = byHeight.begin(); it != byHeight.end() && it->first <= height; it = byHeight.erase(it))
     {
-        TransactionPtr ptr = it->second;
+        dueByHeight.push_back(it->second);
+    }
+
+    auto check = [this,&result](const std::weak_ptr<Transaction> & entry, const bool byTime)
+    {
+        TransactionPtr ptr = entry.lock();
+        if (!ptr)
+        {
+            return;
+        }
+        auto it = m_p->m_pendingTransactions.find(ptr->id());
+        if (it == m_p->m_pendingTransactions.end() || it->second != ptr)
+        {
+            return; // no longer pending or replaced
+        }
 
         if (ptr->isExpiredByBlockNumber())
         {
             xbridge::LogOrderMsg(ptr->id().GetHex(), "order expired by block number", __FUNCTION__);
-             m_p->m_pendingTransactions.erase(it++);
-             unlockUtxos(ptr->id());
-             ++result;
-         }
-        else if(ptr->isExpired())
+            m_p->m_pendingTransactions.erase(it);
+            unlockUtxos(ptr->id());
+            ++result;
+        }
+        else if (ptr->isExpired())
         {
             xbridge::LogOrderMsg(ptr->id().GetHex(), "order expired by ttl", __FUNCTION__);
-            m_p->m_pendingTransactions.erase(it++);
+            m_p->m_pendingTransactions.erase(it);
             unlockUtxos(ptr->id());
             ++result;
-        } else {
-            ++it;
         }
+        else
+        {
+            // refreshed since it was scheduled
+            m_p->scheduleExpiry(ptr, byTime, !byTime);
+        }
+    };
+
+    for (const auto & entry : dueByTime)
+    {
+        check(entry, true);
+    }
+    for (const auto & entry : dueByHeight)
+    {
+        check(entry, false);
     }
 
     return result;
@@ -803,27 +872,35 @@ bool Exchange::updateTimestampOrRemoveExpired(const TransactionPtr & tx)
 {
     LOCK(m_p->m_pendingTransactionsLock);
 
-    auto txid = tx->id();
-    m_p->m_pendingTransactions[txid]->m_lock.lock();
+    auto it = m_p->m_pendingTransactions.find(tx->id());
+    if (it == m_p->m_pendingTransactions.end())
+    {
+        return false;
+    }
+
+    // the expiry wheel is not touched, the scheduled deadline
+    // is checked again when it comes up
+    TransactionPtr & ptr = it->second;
+    ptr->m_lock.lock();
 
     // found, check if expired
-    if (!m_p->m_pendingTransactions[txid]->isExpired())
+    if (!ptr->isExpired())
     {
         // return false if update is too soon
-        if (m_p->m_pendingTransactions[txid]->updateTooSoon()) {
-            m_p->m_pendingTransactions[txid]->m_lock.unlock();
+        if (ptr->updateTooSoon()) {
+            ptr->m_lock.unlock();
             return false;
         }
-        m_p->m_pendingTransactions[txid]->updateTimestamp();
-        m_p->m_pendingTransactions[txid]->m_lock.unlock();
+        ptr->updateTimestamp();
+        ptr->m_lock.unlock();
         return true;
     }
     else
     {
-        m_p->m_pendingTransactions[txid]->m_lock.unlock();
+        ptr->m_lock.unlock();
 
         // if expired - delete old transaction
-        m_p->m_pendingTransactions.erase(txid);
+        m_p->m_pendingTransactions.erase(it);
         return false;
     }
 }
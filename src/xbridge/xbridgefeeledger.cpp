@@ -0,0 +1,95 @@
+// Copyright (c) 2021 The Blocknet developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <xbridge/xbridgefeeledger.h>
+
+namespace xbridge {
+
+void FeeLedger::reset(const Coins & coins, const uint256 & version)
+{
+    m_coins.clear();
+    m_spent.clear();
+    m_available = 0;
+    for (const auto & coin : coins) {
+        if (!m_coins.emplace(coin.first, coin.second).second)
+            continue; // duplicate
+        if (!m_held.count(coin.first))
+            m_available += coin.second;
+    }
+    m_version = version;
+}
+
+void FeeLedger::add(const COutPoint & out, const CAmount & amount)
+{
+    ++m_changes;
+    if (m_spent.count(out) || !m_coins.emplace(out, amount).second)
+        return; // already known
+    if (!m_held.count(out))
+        m_available += amount;
+}
+
+void FeeLedger::spend(const COutPoint & out)
+{
+    ++m_changes;
+    auto it = m_coins.find(out);
+    if (it == m_coins.end())
+        return;
+    if (!m_held.count(out))
+        m_available -= it->second;
+    m_spent.emplace(out, it->second);
+    m_coins.erase(it);
+}
+
+void FeeLedger::unspend(const COutPoint & out)
+{
+    ++m_changes;
+    auto it = m_spent.find(out);
+    if (it == m_spent.end())
+        return;
+    const auto amount = it->second;
+    m_spent.erase(it);
+    add(out, amount);
+}
+
+void FeeLedger::remove(const COutPoint & out)
+{
+    spend(out);
+    m_spent.erase(out);
+}
+
+bool FeeLedger::reserve(const std::vector<COutPoint> & outs)
+{
+    for (const auto & out : outs) {
+        if (m_held.count(out))
+            return false;
+    }
+    hold(outs);
+    return true;
+}
+
+void FeeLedger::hold(const std::vector<COutPoint> & outs)
+{
+    for (const auto & out : outs) {
+        if (m_held[out]++ > 0)
+            continue;
+        auto it = m_coins.find(out);
+        if (it != m_coins.end())
+            m_available -= it->second;
+    }
+}
+
+void FeeLedger::release(const std::vector<COutPoint> & outs)
+{
+    for (const auto & out : outs) {
+        auto h = m_held.find(out);
+        if (h == m_held.end() || --h->second > 0)
+            continue;
+        m_held.erase(h);
+        auto it = m_coins.find(out);
+        if (it != m_coins.end())
+            m_available += it->second;
+    }
+}
+
+}
@@ -0,0 +1,77 @@
+// Copyright (c) 2021 The Blocknet developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BLOCKNET_XBRIDGE_XBRIDGEFEELEDGER_H
+#define BLOCKNET_XBRIDGE_XBRIDGEFEELEDGER_H
+
+#include <amount.h>
+#include <primitives/transaction.h>
+#include <uint256.h>
+
+#include <map>
+#include <utility>
+#include <vector>
+
+namespace xbridge {
+
+/**
+ * Pool of confirmed BLOCK outputs that can pay XRouter and XBridge service
+ * node fees. Outputs held by fee transactions or orders are tracked with a
+ * reference count and the spendable total is kept up to date, which makes
+ * affordability checks O(1). The pool follows the chain and the mempool
+ * through add, spend, unspend and remove. It is rebuilt from the wallets when
+ * its version (the loaded wallets) changes or it is invalidated, holds survive
+ * rebuilds. Not thread safe, callers lock.
+ */
+class FeeLedger
+{
+public:
+    typedef std::vector<std::pair<COutPoint, CAmount>> Coins;
+
+    /** Replaces the pool with the specified coins and records the pool version. */
+    void reset(const Coins & coins, const uint256 & version);
+    /** Returns true if the pool was built for the specified version. */
+    bool current(const uint256 & version) const { return m_version == version && !m_version.IsNull(); }
+    /** Forces a rebuild on the next check. */
+    void invalidate() { m_version.SetNull(); ++m_changes; }
+    /** Number of updates since construction, a rebuild is stale if this moved while the wallets were read. */
+    uint64_t changes() const { return m_changes; }
+
+    /** Adds a confirmed output to the pool. */
+    void add(const COutPoint & out, const CAmount & amount);
+    /** Takes an output spent by a mempool transaction out of the pool until unspend or remove. */
+    void spend(const COutPoint & out);
+    /** Returns an output to the pool after the mempool transaction spending it was dropped. */
+    void unspend(const COutPoint & out);
+    /** Removes an output spent in a block. */
+    void remove(const COutPoint & out);
+
+    /** Returns true if the outputs that aren't held cover the fee. */
+    bool canAfford(const CAmount & fee) const { return m_available >= fee; }
+    CAmount available() const { return m_available; }
+    size_t size() const { return m_coins.size(); }
+
+    /**
+     * Holds the outputs for a fee payment. All or nothing, returns false
+     * without holding anything if one of the outputs is already held.
+     */
+    bool reserve(const std::vector<COutPoint> & outs);
+    /** Holds the outputs, outputs already held are counted again. */
+    void hold(const std::vector<COutPoint> & outs);
+    /** Releases one hold on each of the outputs. */
+    void release(const std::vector<COutPoint> & outs);
+    bool held(const COutPoint & out) const { return m_held.count(out) > 0; }
+
+private:
+    std::map<COutPoint, CAmount> m_coins;
+    std::map<COutPoint, CAmount> m_spent; // spent in the mempool
+    std::map<COutPoint, uint32_t> m_held;
+    CAmount m_available{0};
+    uint256 m_version;
+    uint64_t m_changes{0};
+};
+
+}
+
+#endif // BLOCKNET_XBRIDGE_XBRIDGEFEELEDGER_H
@@ -9,9 +9,14 @@
 #include <xbridge/xbridgepacket.h>
 
 #include <crypto/sha256.h>
+#include <cuckoocache.h>
 #include <random.h>
+#include <script/sigcache.h>
 #include <secp256k1.h>
 #include <support/allocators/secure.h>
+#include <uint256.h>
+
+#include <boost/thread/shared_mutex.hpp>
 
 //******************************************************************************
 //******************************************************************************
@@ -52,6 +57,50 @@ public:
 };
 static SecpInstance secpInstance;
 
+//! Size of the packet signature cache in bytes (2 MiB)
+static const size_t PACKET_SIGNATURE_CACHE_BYTES = 2 << 20;
+
+/**
+ * Valid packet signature cache. Packets are relayed between snodes and clients
+ * and each session verifies them again, this avoids repeating the ECDSA
+ * verification for packets that were already seen.
+ */
+class PacketSignatureCache
+{
+private:
+    //! Entries are SHA256(nonce || body hash || signature)
+    uint256 nonce;
+    typedef CuckooCache::cache<uint256, SignatureCacheHasher> map_type;
+    map_type setValid;
+    boost::shared_mutex cs_cache;
+
+public:
+    PacketSignatureCache()
+    {
+        GetRandBytes(nonce.begin(), 32);
+        setValid.setup_bytes(PACKET_SIGNATURE_CACHE_BYTES);
+    }
+
+    void ComputeEntry(uint256 & entry, const uint256 & hash, const unsigned char * signature)
+    {
+        CSHA256().Write(nonce.begin(), 32).Write(hash.begin(), 32)
+                 .Write(signature, XBridgePacket::rawSignatureSize).Finalize(entry.begin());
+    }
+
+    bool Get(const uint256 & entry)
+    {
+        boost::shared_lock<boost::shared_mutex> lock(cs_cache);
+        return setValid.contains(entry, false);
+    }
+
+    void Set(uint256 & entry)
+    {
+        boost::unique_lock<boost::shared_mutex> lock(cs_cache);
+        setValid.insert(entry);
+    }
+};
+static PacketSignatureCache packetSignatureCache;
+
 } // namespace
 
 //******************************************************************************
@@ -91,22 +140,29 @@ bool XBridgePacket::sign(const std::vector<unsigned char> & pubkey,
 //******************************************************************************
 // verify signature
 //******************************************************************************
-bool XBridgePacket::verify()
+bool XBridgePacket::verify() const
 {
-    unsigned char signature[rawSignatureSize];
-    memcpy(signature, signatureField(), rawSignatureSize);
-    memset(signatureField(), 0, rawSignatureSize);
-
-    unsigned char hash[CSHA256::OUTPUT_SIZE];
-
+    if (m_body.size() < headerSize)
     {
-        CSHA256 sha256;
-        sha256.Write(&m_body[0], m_body.size());
-        sha256.Finalize(hash);
+        return false;
     }
 
-    // restore signature
-    memcpy(signatureField(), signature, rawSignatureSize);
+    // hash the body with a zeroed signature field, as it was signed
+    static const unsigned char emptySignature[rawSignatureSize] = {0};
+    const size_t sigOffset = signatureField() - &m_body[0];
+    uint256 hash;
+    CSHA256().Write(&m_body[0], sigOffset)
+             .Write(emptySignature, rawSignatureSize)
+             .Write(&m_body[sigOffset + rawSignatureSize], m_body.size() - sigOffset - rawSignatureSize)
+             .Finalize(hash.begin());
+
+    // the body hash covers the pubkey field
+    uint256 entry;
+    packetSignatureCache.ComputeEntry(entry, hash, signatureField());
+    if (packetSignatureCache.Get(entry))
+    {
+        return true;
+    }
 
     secp256k1_ecdsa_signature sig;
     if (secp256k1_ecdsa_signature_parse_compact(secpContext, &sig, signatureField()) == 0)
@@ -115,6 +171,8 @@ bool XBridgePacket::verify()
         return false;
     }
 
+    // only the 33 byte compressed encoding parses at this size, so there's
+    // no need to serialize the key again and compare it with the field
     secp256k1_pubkey scpubkey;
     if (secp256k1_ec_pubkey_parse(secpContext, &scpubkey, pubkeyField(), pubkeySize) == 0)
     {
@@ -122,36 +180,21 @@ bool XBridgePacket::verify()
         return false;
     }
 
-    if (secp256k1_ecdsa_verify(secpContext, &sig, hash, &scpubkey) != 1)
+    if (secp256k1_ecdsa_verify(secpContext, &sig, hash.begin(), &scpubkey) != 1)
     {
         LOG() << "bad signature " << __FUNCTION__;
         return false;
     }
 
-    // correct signature, check pubkey
-    unsigned char pub[pubkeySize];
-    size_t len = pubkeySize;
-    secp256k1_ec_pubkey_serialize(secpContext, pub, &len, &scpubkey, SECP256K1_EC_COMPRESSED);
-
-    if (memcmp(pub, pubkeyField(), pubkeySize))
-    {
-        LOG() << "signature correct, but different pubkeys " << __FUNCTION__;
-        return false;
-    }
-    if (len != pubkeySize)
-    {
-        LOG() << "incorrect pubkey lengtn returned " << __FUNCTION__;
-        return false;
-    }
-
     // all correct
+    packetSignatureCache.Set(entry);
     return true;
 }
 
 //******************************************************************************
 // verify signature and pubkey
 //******************************************************************************
-bool XBridgePacket::verify(const std::vector<unsigned char> & pubkey)
+bool XBridgePacket::verify(const std::vector<unsigned char> & pubkey) const
 {
     if (pubkey.size() != pubkeySize || memcmp(pubkeyField(), &pubkey[0], pubkeySize))
     {
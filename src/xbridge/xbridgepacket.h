@@ -528,8 +528,8 @@ public:
 
     bool sign(const std::vector<unsigned char> & pubkey,
               const std::vector<unsigned char> & privkey);
-    bool verify();
-    bool verify(const std::vector<unsigned char> & pubkey);
+    bool verify() const;
+    bool verify(const std::vector<unsigned char> & pubkey) const;
 
 protected:
     template<uint32_t INDEX>
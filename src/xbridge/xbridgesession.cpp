@@ -757,6 +757,7 @@ bool Session::Impl::processPendingTransaction(XBridgePacketPtr packet) const
         {
             xbridge::LogOrderMsg(ptr->id.GetHex(), "received confirmed order from snode, setting status to pending", __FUNCTION__);
             ptr->state = TransactionDescr::trPending;
+            xapp.markOrderDirty(ptr->id);
         }
 
         offset += XBridgePacket::addressSize; // hub address
@@ -774,6 +775,7 @@ bool Session::Impl::processPendingTransaction(XBridgePacketPtr packet) const
 
         // update timestamp
         ptr->updateTimestamp();
+        xapp.markOrderDirty(ptr->id);
 
         xbridge::LogOrderMsg(ptr, __FUNCTION__);
 
@@ -803,6 +805,7 @@ bool Session::Impl::processPendingTransaction(XBridgePacketPtr packet) const
     offset += sizeof(uint64_t);
 
     ptr->state        = TransactionDescr::trPending;
+    xapp.markOrderDirty(ptr->id);
     ptr->sPubKey      = spubkey;
 
     std::vector<unsigned char> sblockhash(packet->data()+offset, packet->data()+offset+XBridgePacket::hashSize);
@@ -1498,6 +1501,7 @@ bool Session::Impl::processTransactionHold(XBridgePacketPtr packet) const
     if (!xtx->isLocal())
     {
         xtx->state = TransactionDescr::trFinished;
+        xapp.markOrderDirty(xtx->id);
 
         xbridge::LogOrderMsg(id.GetHex(), "tx moving to history", __FUNCTION__);
 
@@ -1522,6 +1526,7 @@ bool Session::Impl::processTransactionHold(XBridgePacketPtr packet) const
     }
 
     xtx->state = TransactionDescr::trHold;
+    xapp.markOrderDirty(xtx->id);
     xbridge::LogOrderMsg(xtx, __FUNCTION__);
     xuiConnector.NotifyXBridgeTransactionChanged(id);
 
@@ -1755,6 +1760,7 @@ bool Session::Impl::processTransactionInit(XBridgePacketPtr packet) const
     }
 
     xtx->state = TransactionDescr::trInitialized;
+    xapp.markOrderDirty(xtx->id);
     xuiConnector.NotifyXBridgeTransactionChanged(xtx->id);
 
     // send initialized
@@ -2162,6 +2168,7 @@ bool Session::Impl::processTransactionCreateA(XBridgePacketPtr packet) const
     } // refundTx
 
     xtx->state = TransactionDescr::trCreated;
+    xapp.markOrderDirty(xtx->id);
     xuiConnector.NotifyXBridgeTransactionChanged(txid);
     
     // Sending deposit
@@ -2181,7 +2188,7 @@ bool Session::Impl::processTransactionCreateA(XBridgePacketPtr packet) const
             LogOrderMsg(log_obj,  "successfully submitted p2sh deposit", __FUNCTION__);
             // Save db state after updating watch state on this order
             xapp.watchForSpentDeposit(xtx);
-            xapp.saveOrders(true);
+            xapp.saveOrders();
         }
         else
         {
@@ -2663,6 +2670,7 @@ bool Session::Impl::processTransactionCreateB(XBridgePacketPtr packet) const
         }
         
         xtx->state = TransactionDescr::trCreated;
+        xapp.markOrderDirty(xtx->id);
         xuiConnector.NotifyXBridgeTransactionChanged(txid);
 
         // Mark deposit as sent
@@ -2679,9 +2687,10 @@ bool Session::Impl::processTransactionCreateB(XBridgePacketPtr packet) const
             log_obj.pushKV("sent_id", sentid);
             LogOrderMsg(log_obj,  "successfully submitted p2sh deposit", __FUNCTION__);
             xtx->setWatchBlock(blockCount);
+            xapp.markOrderDirty(xtx->id);
             xapp.watchForSpentDeposit(xtx);
             // Save db state after updating watch state on this order
-            xapp.saveOrders(true);
+            xapp.saveOrders();
         }
         else
         {
@@ -2963,6 +2972,7 @@ bool Session::Impl::processTransactionConfirmA(XBridgePacketPtr packet) const
     } // payTx
 
     xtx->state = TransactionDescr::trFinished;
+    xapp.markOrderDirty(xtx->id);
     xuiConnector.NotifyXBridgeTransactionChanged(txid);
 
     // send reply
@@ -3146,6 +3156,7 @@ bool Session::Impl::processTransactionConfirmB(XBridgePacketPtr packet) const
     } // payTx
 
     xtx->state = TransactionDescr::trFinished;
+    xapp.markOrderDirty(xtx->id);
     xuiConnector.NotifyXBridgeTransactionChanged(txid);
 
     // send reply
@@ -3333,6 +3344,7 @@ bool Session::Impl::processTransactionCancel(XBridgePacketPtr packet) const
         if (xtx->state < TransactionDescr::trInitialized)
             xapp.unlockFeeUtxos(xtx->feeUtxos);
         xtx->state  = TransactionDescr::trCancelled;
+        xapp.markOrderDirty(xtx->id);
         xtx->reason = reason;
         write_log(o, errMsg);
     };
@@ -3342,6 +3354,7 @@ bool Session::Impl::processTransactionCancel(XBridgePacketPtr packet) const
     if (xtx->isLocal() && xtx->state <= TransactionDescr::trPending && !iCanceled) {
         auto requireUpdateTime = boost::posix_time::second_clock::universal_time() - boost::posix_time::seconds(241);
         xtx->setUpdateTime(requireUpdateTime); // will trigger an update (240 seconds stale)
+        xapp.markOrderDirty(xtx->id);
         write_log(log_obj, "cancel received, rebroadcasting order on another service node");
         return true;
     } else if (xtx->state < TransactionDescr::trCreated) { // if no deposits yet
@@ -3371,6 +3384,7 @@ bool Session::Impl::processTransactionCancel(XBridgePacketPtr packet) const
 
     // Set rollback state
     xtx->state = TransactionDescr::trRollback;
+    xapp.markOrderDirty(xtx->id);
     xtx->reason = reason;
 
     // Attempt to rollback transaction and redeem deposit (this can take time since locktime needs to expire)
@@ -3424,6 +3438,7 @@ bool Session::Impl::processTransactionReject(XBridgePacketPtr packet) const
 
     // restore state on rejection
     xtx->state = TransactionDescr::trPending;
+    xapp.markOrderDirty(xtx->id);
     // unlock coins
     xapp.unlockCoins(xtx->fromCurrency, xtx->usedCoins);
     xapp.unlockFeeUtxos(xtx->feeUtxos);
@@ -3781,6 +3796,7 @@ bool Session::Impl::processTransactionFinished(XBridgePacketPtr packet) const
         }
         // update transaction state for gui
         xtx->state = TransactionDescr::trFinished;
+        xapp.markOrderDirty(xtx->id);
         LogOrderMsg(xtx, __FUNCTION__);
     }
 
@@ -3869,9 +3885,11 @@ bool Session::Impl::redeemOrderDeposit(const TransactionDescrPtr & xtx, int32_t
             log_obj.pushKV("to_amount", xbridge::xBridgeStringValueFromAmount(xtx->toAmount));
             LogOrderMsg(log_obj, "failed to rollback locked deposit for order, trying again later", __FUNCTION__);
             xtx->state = TransactionDescr::trRollbackFailed;
+            xapp.markOrderDirty(xtx->id);
             return false;
         } else {
             xtx->state = TransactionDescr::trRollback;
+            xapp.markOrderDirty(xtx->id);
         }
     }
 
@@ -3916,7 +3934,7 @@ bool Session::Impl::redeemOrderCounterpartyDeposit(const TransactionDescrPtr & x
         // done watching for spent pay tx
         xtx->doneWatching();
         xapp.unwatchSpentDeposit(xtx);
-        xapp.saveOrders(true);
+        xapp.saveOrders();
     }
 
     auto fromAddr = connFrom->fromXAddr(xtx->from);
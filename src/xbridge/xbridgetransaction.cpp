@@ -8,6 +8,7 @@
 #include <xbridge/xbridgetransaction.h>
 
 #include <xbridge/util/logger.h>
+#include <xbridge/util/posixtimeconversion.h>
 #include <xbridge/util/settings.h>
 #include <xbridge/util/xutil.h>
 #include <xbridge/xbridgewalletconnector.h>
@@ -17,6 +18,8 @@
 #include <util/strencodings.h>
 #include <validation.h>
 
+#include <algorithm>
+
 #include <boost/date_time/posix_time/conversion.hpp>
 #include <boost/lexical_cast.hpp>
 
@@ -310,6 +313,39 @@ bool Transaction::isExpiredByBlockNumber() const
     return false;
 }
 
+//*****************************************************************************
+//*****************************************************************************
+int64_t Transaction::expiryTime() const
+{
+    LOCK(m_lock);
+    const int64_t last = boost::posix_time::to_time_t(m_last);
+    if (m_state == trNew)
+    {
+        const int64_t created = boost::posix_time::to_time_t(m_created);
+        return std::min(created + deadlineTTL, last + pendingTTL) + 1;
+    }
+    return last + TTL + 1;
+}
+
+//*****************************************************************************
+//*****************************************************************************
+int Transaction::expiryBlockHeight() const
+{
+    uint256 blockHash;
+    {
+        LOCK(m_lock);
+        blockHash = m_blockHash;
+    }
+
+    LOCK(cs_main);
+
+    CBlockIndex* blockindex = LookupBlockIndex(blockHash);
+    if (!blockindex)
+        return -1;
+
+    return blockindex->nHeight + blocksTTL + 1;
+}
+
 bool Transaction::isPartialAllowed()
 {
     LOCK(m_lock);
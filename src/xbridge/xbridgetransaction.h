@@ -176,6 +176,18 @@ public:
     bool isExpired() const;
     bool isExpiredByBlockNumber() const;
 
+    /**
+     * @brief expiryTime
+     * @return earliest time (seconds since epoch) at which isExpired() can be true
+     */
+    int64_t expiryTime() const;
+    /**
+     * @brief expiryBlockHeight
+     * @return chain height at which isExpiredByBlockNumber() is true, -1 if the
+     * transaction's block is unknown
+     */
+    int expiryBlockHeight() const;
+
     /**
      * @brief cancel - set transaction state to trCancelled
      */
@@ -10,6 +10,10 @@
 
 #include <base58.h>
 
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
 //*****************************************************************************
 //*****************************************************************************
 namespace xbridge
@@ -31,6 +35,9 @@ std::string UtxoEntry::toString() const
 
 } // namespace wallet
 
+/** Most signmessage requests in flight to a wallet at once, matches the default -rpcthreads */
+static const size_t MAX_SIGNING_THREADS = 4;
+
 //*****************************************************************************
 //*****************************************************************************
 WalletConnector::WalletConnector()
@@ -87,4 +94,86 @@ std::string WalletConnector::getNewTokenAddress()
     return newaddress;
 }
 
+//******************************************************************************
+//******************************************************************************
+bool WalletConnector::signUtxo(const wallet::UtxoEntry & entry, std::string & signature)
+{
+    const COutPoint outpoint = entry.outpoint();
+    const std::string message = entry.toString();
+    {
+        LOCK(m_utxoSignaturesLock);
+        auto it = m_utxoSignatures.find(outpoint);
+        if (it != m_utxoSignatures.end() && it->second.first == message)
+        {
+            signature = it->second.second;
+            return true;
+        }
+    }
+
+    if (!signMessage(entry.address, message, signature))
+    {
+        return false;
+    }
+
+    LOCK(m_utxoSignaturesLock);
+    m_utxoSignatures[outpoint] = std::make_pair(message, signature);
+    return true;
+}
+
+//******************************************************************************
+//******************************************************************************
+void WalletConnector::signUtxos(const std::vector<wallet::UtxoEntry> & entries)
+{
+    std::vector<const wallet::UtxoEntry *> pending;
+    {
+        LOCK(m_utxoSignaturesLock);
+        for (const wallet::UtxoEntry & entry : entries)
+        {
+            auto it = m_utxoSignatures.find(entry.outpoint());
+            if (it == m_utxoSignatures.end() || it->second.first != entry.toString())
+                pending.push_back(&entry);
+        }
+    }
+
+    // A single signature is left to signUtxo
+    if (pending.size() < 2)
+    {
+        return;
+    }
+
+    // Failures are not reported here, signUtxo retries them
+    std::atomic<size_t> next{0};
+    auto sign = [this, &pending, &next]() {
+        std::string signature;
+        for (size_t i = next++; i < pending.size(); i = next++)
+            signUtxo(*pending[i], signature);
+    };
+
+    std::vector<std::thread> threads;
+    const size_t count = std::min(pending.size(), MAX_SIGNING_THREADS);
+    for (size_t i = 1; i < count; ++i)
+        threads.emplace_back(sign);
+    sign();
+    for (std::thread & t : threads)
+        t.join();
+}
+
+//******************************************************************************
+//******************************************************************************
+void WalletConnector::pruneUtxoSignatures(const std::vector<wallet::UtxoEntry> & unspent) const
+{
+    std::set<COutPoint> outpoints;
+    for (const wallet::UtxoEntry & entry : unspent)
+        outpoints.insert(entry.outpoint());
+
+    LOCK(m_utxoSignaturesLock);
+    for (auto it = m_utxoSignatures.begin(); it != m_utxoSignatures.end(); )
+    {
+        if (outpoints.count(it->first))
+            ++it;
+        else
+            it = m_utxoSignatures.erase(it);
+    }
+}
+
 } // namespace xbridge
@@ -12,8 +12,10 @@
 
 #include <primitives/transaction.h>
 #include <script/script.h>
+#include <sync.h>
 #include <uint256.h>
 
+#include <map>
 #include <vector>
 #include <string>
 #include <memory>
@@ -110,6 +112,27 @@ public:
     virtual bool signMessage(const std::string & address, const std::string & message, std::string & signature) = 0;
     virtual bool verifyMessage(const std::string & address, const std::string & message, const std::string & signature) = 0;
 
+    /**
+     * @brief signUtxo sign the ownership message of a utxo, reusing an earlier signature of the same message
+     * @param entry utxo to sign
+     * @param signature base64 signature
+     * @return true if signed
+     */
+    bool signUtxo(const wallet::UtxoEntry & entry, std::string & signature);
+
+    /**
+     * @brief signUtxos sign the utxos that have no cached signature yet, several requests at a time,
+     * so that the following signUtxo calls are served from the cache
+     * @param entries utxos to sign
+     */
+    void signUtxos(const std::vector<wallet::UtxoEntry> & entries);
+
+    /**
+     * @brief pruneUtxoSignatures drop cached signatures of utxos that are no longer unspent
+     * @param unspent all unspent utxos of the wallet
+     */
+    void pruneUtxoSignatures(const std::vector<wallet::UtxoEntry> & unspent) const;
+
     virtual bool getRawMempool(std::vector<std::string> & txids) = 0;
 
     virtual bool getBlockCount(uint32_t & blockCount) = 0;
@@ -193,6 +216,11 @@ public:
                                  const uint32_t & utxoVoutN, bool & isSpent) = 0;
 
     virtual bool getTransactionsInBlock(const std::string & blockHash, std::vector<std::string> & txids) = 0;
+
+private:
+    //! Signed message and signature of each utxo signed through signUtxo
+    mutable CCriticalSection m_utxoSignaturesLock;
+    mutable std::map<COutPoint, std::pair<std::string, std::string>> m_utxoSignatures GUARDED_BY(m_utxoSignaturesLock);
 };
 
 } // namespace xbridge
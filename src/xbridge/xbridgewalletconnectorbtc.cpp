@@ -15,6 +15,11 @@
 
 #include <base58.h>
 #include <primitives/transaction.h>
+#include <util/time.h>
+
+#include <algorithm>
+#include <cmath>
+#include <map>
 
 #include <json/json_spirit_reader_template.h>
 #include <json/json_spirit_writer_template.h>
@@ -876,6 +881,70 @@ bool getRawTransaction(const std::string & rpcuser,
     return true;
 }
 
+//*****************************************************************************
+// Fetch several verbose transactions in one batch request. Transactions the
+// wallet does not have are left out of txs. Wallets that do not accept batch
+// requests are asked for one transaction at a time.
+//*****************************************************************************
+bool getRawTransactions(const std::string & rpcuser,
+                        const std::string & rpcpasswd,
+                        const std::string & rpcip,
+                        const std::string & rpcport,
+                        const std::vector<std::string> & txids,
+                        std::map<std::string, Object> & txs)
+{
+    txs.clear();
+    if (txids.empty())
+        return true;
+
+    try
+    {
+        LOG() << "rpc call <getrawtransaction> batch of " << txids.size();
+
+        std::vector<Array> paramsList;
+        for (const auto & txid : txids)
+        {
+            Array params;
+            params.push_back(txid);
+            params.push_back(1);
+            paramsList.push_back(params);
+        }
+        const Array replies = CallRPCBatch(rpcuser, rpcpasswd, rpcip, rpcport, "getrawtransaction", paramsList);
+
+        for (const Value & reply : replies)
+        {
+            if (reply.type() != obj_type)
+                continue;
+            const Value & id     = find_value(reply.get_obj(), "id");
+            const Value & result = find_value(reply.get_obj(), "result");
+            const Value & error  = find_value(reply.get_obj(), "error");
+            if (id.type() != int_type || id.get_int() < 0 || id.get_int() >= static_cast<int>(txids.size()))
+                continue;
+            if (error.type() != null_type || result.type() != obj_type)
+                continue;
+            txs[txids[id.get_int()]] = result.get_obj();
+        }
+        return true;
+    }
+    catch (std::exception & e)
+    {
+        LOG() << "getrawtransaction batch exception " << e.what() << ", requesting transactions one by one";
+    }
+
+    for (const auto & txid : txids)
+    {
+        std::string json;
+        Value txv;
+        if (!getRawTransaction(rpcuser, rpcpasswd, rpcip, rpcport, txid, true, json))
+            continue;
+        if (!read_string(json, txv) || txv.type() != obj_type)
+            return false;
+        txs[txid] = txv.get_obj();
+    }
+
+    return true;
+}
+
 //*****************************************************************************
 //*****************************************************************************
 bool getNewAddress(const std::string & rpcuser,
@@ -1505,6 +1574,131 @@ uint256 SignatureHash(const CScript& scriptCode, const CTransactionPtr & txTo,
     return ss.GetHash();
 }
 
+/**
+ * @brief DecodeTransaction decode a raw transaction in the bitcoin format
+ * @param rawtx hex of the transaction
+ * @param txid expected id, guards against chains with a different format that happen to parse
+ * @param txWithTimeField true if the chain serializes nTime after nVersion
+ * @param tx decoded transaction
+ * @return true if rawtx is a transaction in this format with id txid
+ */
+bool DecodeTransaction(const std::string & rawtx, const std::string & txid,
+                       const bool txWithTimeField, CMutableTransaction & tx)
+{
+    if (!IsHex(rawtx))
+        return false;
+
+    try
+    {
+        CDataStream ss(ParseHex(rawtx), SER_NETWORK, PROTOCOL_VERSION);
+        if (txWithTimeField)
+        {
+            CTransaction xtx(true);
+            ss >> xtx;
+            if (!ss.empty() || xtx.GetHash() != uint256S(txid))
+                return false;
+
+            tx.nVersion  = xtx.nVersion;
+            tx.vin       = std::move(xtx.vin);
+            tx.vout      = std::move(xtx.vout);
+            tx.nLockTime = xtx.nLockTime;
+        }
+        else
+        {
+            ss >> tx;
+            if (!ss.empty() || tx.GetHash() != uint256S(txid))
+                return false;
+        }
+    }
+    catch (const std::exception &)
+    {
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief ParseDecodedTransaction read the inputs and outputs of a
+ * decoderawtransaction or verbose getrawtransaction reply
+ * @param txo reply object
+ * @param COIN units per coin on the chain
+ * @param tx transaction holding the parsed inputs and outputs
+ * @return false if the reply is missing required fields
+ */
+bool ParseDecodedTransaction(const json_spirit::Object & txo, const uint64_t COIN, CMutableTransaction & tx)
+{
+    using namespace json_spirit;
+
+    const Value & vins  = find_value(txo, "vin");
+    const Value & vouts = find_value(txo, "vout");
+    if (vins.type() != array_type || vouts.type() != array_type)
+        return false;
+
+    tx.vin.clear();
+    for (const Value & vin : vins.get_array())
+    {
+        if (vin.type() != obj_type)
+            return false;
+        const Value & txid = find_value(vin.get_obj(), "txid");
+        const Value & n    = find_value(vin.get_obj(), "vout");
+        if (txid.type() != str_type || n.type() != int_type)
+            return false;
+
+        CTxIn in(COutPoint(uint256S(txid.get_str()), static_cast<uint32_t>(n.get_int())));
+
+        // sequence is not reported by every wallet, leave it final if missing
+        const Value & sequence = find_value(vin.get_obj(), "sequence");
+        if (sequence.type() == int_type)
+            in.nSequence = static_cast<uint32_t>(sequence.get_int64());
+        else if (sequence.type() != null_type)
+            return false;
+
+        const Value & scriptSig = find_value(vin.get_obj(), "scriptSig");
+        if (scriptSig.type() == obj_type)
+        {
+            const Value & hex = find_value(scriptSig.get_obj(), "hex");
+            if (hex.type() == str_type)
+            {
+                const auto script = ParseHex(hex.get_str());
+                in.scriptSig = CScript(script.begin(), script.end());
+            }
+        }
+
+        tx.vin.push_back(in);
+    }
+
+    tx.vout.clear();
+    for (const Value & vout : vouts.get_array())
+    {
+        if (vout.type() != obj_type)
+            return false;
+        const Value & value = find_value(vout.get_obj(), "value");
+        const Value & n     = find_value(vout.get_obj(), "n");
+        if (value.type() != real_type || n.type() != int_type ||
+            n.get_int() != static_cast<int>(tx.vout.size()) || value.get_real() < 0)
+        {
+            return false;
+        }
+
+        CScript script;
+        const Value & scriptPubKey = find_value(vout.get_obj(), "scriptPubKey");
+        if (scriptPubKey.type() == obj_type)
+        {
+            const Value & hex = find_value(scriptPubKey.get_obj(), "hex");
+            if (hex.type() == str_type)
+            {
+                const auto bytes = ParseHex(hex.get_str());
+                script = CScript(bytes.begin(), bytes.end());
+            }
+        }
+
+        tx.vout.push_back(CTxOut(static_cast<CAmount>(std::llround(value.get_real() * COIN)), script));
+    }
+
+    return true;
+}
+
 } // namespace
 
 //*****************************************************************************
@@ -1605,36 +1799,96 @@ template <class CryptoProvider>
 bool BtcWalletConnector<CryptoProvider>::getUnspent(std::vector<wallet::UtxoEntry> & inputs,
                                                     const std::set<wallet::UtxoEntry> & excluded) const
 {
-    if (!rpc::listUnspent(m_user, m_passwd, m_ip, m_port, inputs))
+    LOCK(m_utxoMirrorLock);
+
+    // Only go back to listunspent if the wallet may have new or spent outputs.
+    // Unconfirmed outputs are not listed, so a new block is the main trigger.
+    // The age limit picks up spends made outside of xbridge.
+    uint32_t blocks{0};
+    const int64_t now = GetTime();
+    const bool haveBlocks = rpc::getblockcount(m_user, m_passwd, m_ip, m_port, blocks);
+    if (!m_utxoMirrorValid || !haveBlocks || blocks != m_utxoMirrorBlocks ||
+        now - m_utxoMirrorTime >= UTXO_MIRROR_MAX_AGE)
     {
-        LOG() << "rpc::listUnspent failed " << __FUNCTION__;
-        return false;
+        std::vector<wallet::UtxoEntry> entries;
+        if (!rpc::listUnspent(m_user, m_passwd, m_ip, m_port, entries))
+        {
+            LOG() << "rpc::listUnspent failed " << __FUNCTION__;
+            m_utxoMirrorValid = false;
+            return false;
+        }
+
+        // Only accept p2pkh (like 76a91476bba472620ff0ecbfbf93d0d3909c6ca84ac81588ac)
+        entries.erase(
+            std::remove_if(entries.begin(), entries.end(), [this](xbridge::wallet::UtxoEntry & u) {
+                std::vector<unsigned char> script = ParseHex(u.scriptPubKey);
+                if (script.size() == 25 &&
+                    script[0] == 0x76 && script[1] == 0xa9 && script[2] == 0x14 &&
+                    script[23] == 0x88 && script[24] == 0xac)
+                {
+                    script.erase(script.begin(), script.begin()+3);
+                    script.erase(script.end()-2, script.end());
+                    u.address = fromXAddr(script);
+                    return false; // keep
+                }
+
+                return true; // remove if script invalid
+            }),
+            entries.end()
+        );
+
+        m_utxoMirror.swap(entries);
+        pruneUtxoSignatures(m_utxoMirror);
+        m_utxoMirrorBlocks = blocks;
+        m_utxoMirrorTime = now;
+        m_utxoMirrorValid = haveBlocks;
+    }
+
+    // Copy out all but the excluded utxos
+    inputs.reserve(inputs.size() + m_utxoMirror.size());
+    for (const wallet::UtxoEntry & u : m_utxoMirror)
+    {
+        if (!excluded.count(u))
+            inputs.push_back(u);
     }
 
-    // Remove all the excluded utxos
-    inputs.erase(
-        std::remove_if(inputs.begin(), inputs.end(), [&excluded, this](xbridge::wallet::UtxoEntry & u) {
-            if (excluded.count(u))
-                return true; // remove if in excluded list
+    return true;
+}
 
-            // Only accept p2pkh (like 76a91476bba472620ff0ecbfbf93d0d3909c6ca84ac81588ac)
-            std::vector<unsigned char> script = ParseHex(u.scriptPubKey);
-            if (script.size() == 25 &&
-                script[0] == 0x76 && script[1] == 0xa9 && script[2] == 0x14 &&
-                script[23] == 0x88 && script[24] == 0xac)
-            {
-                script.erase(script.begin(), script.begin()+3);
-                script.erase(script.end()-2, script.end());
-                u.address = fromXAddr(script);
-                return false; // keep
-            }
+//******************************************************************************
+//******************************************************************************
+template <class CryptoProvider>
+void BtcWalletConnector<CryptoProvider>::removeSpentFromUtxoMirror(const std::string & rawtx,
+                                                                   const std::string & txid)
+{
+    LOCK(m_utxoMirrorLock);
+    if (!m_utxoMirrorValid)
+        return;
+
+    CMutableTransaction tx;
+    if (!DecodeTransaction(rawtx, txid, txWithTimeField, tx))
+    {
+        // Unknown format, reload on next use
+        m_utxoMirrorValid = false;
+        return;
+    }
+
+    std::set<wallet::UtxoEntry> spent;
+    for (const CTxIn & in : tx.vin)
+    {
+        wallet::UtxoEntry u;
+        u.txId = in.prevout.hash.GetHex();
+        u.vout = in.prevout.n;
+        spent.insert(u);
+    }
 
-            return true; // remove if script invalid
+    m_utxoMirror.erase(
+        std::remove_if(m_utxoMirror.begin(), m_utxoMirror.end(), [&spent](const wallet::UtxoEntry & u) {
+            return spent.count(u) > 0;
         }),
-        inputs.end()
+        m_utxoMirror.end()
     );
-
-    return true;
+    pruneUtxoSignatures(m_utxoMirror);
 }
 
 //******************************************************************************
@@ -1691,6 +1945,8 @@ bool BtcWalletConnector<CryptoProvider>::sendRawTransaction(const std::string &
         return false;
     }
 
+    removeSpentFromUtxoMirror(rawtx, txid);
+
     return true;
 }
 
@@ -1971,6 +2227,78 @@ double BtcWalletConnector<CryptoProvider>::minTxFee2(const uint32_t inputCount,
     return (double)fee / COIN;
 }
 
+//******************************************************************************
+//******************************************************************************
+template <class CryptoProvider>
+bool BtcWalletConnector<CryptoProvider>::decodeTransactionReply(const json_spirit::Object & txo,
+                                                                const std::string & txid,
+                                                                CMutableTransaction & tx,
+                                                                int64_t * confirmations) const
+{
+    if (confirmations)
+    {
+        const json_spirit::Value & confs = json_spirit::find_value(txo, "confirmations");
+        *confirmations = confs.type() == json_spirit::int_type ? confs.get_int64() : -1;
+    }
+
+    const json_spirit::Value & hex = json_spirit::find_value(txo, "hex");
+    if (hex.type() == json_spirit::str_type && DecodeTransaction(hex.get_str(), txid, txWithTimeField, tx))
+        return true;
+
+    // Not in the bitcoin format, use the wallet's own decoding from the same reply
+    return ParseDecodedTransaction(txo, COIN, tx);
+}
+
+//******************************************************************************
+//******************************************************************************
+template <class CryptoProvider>
+bool BtcWalletConnector<CryptoProvider>::getDecodedTransaction(const std::string & txid,
+                                                               CMutableTransaction & tx,
+                                                               bool & found,
+                                                               int64_t * confirmations) const
+{
+    found = false;
+
+    std::string rawtx;
+    if (!rpc::getRawTransaction(m_user, m_passwd, m_ip, m_port, txid, false, rawtx))
+        return false;
+
+    found = true;
+
+    if (DecodeTransaction(rawtx, txid, txWithTimeField, tx))
+    {
+        if (!confirmations)
+            return true;
+
+        // Confirmations of the first unspent output
+        *confirmations = -1;
+        for (uint32_t n = 0; n < tx.vout.size(); ++n)
+        {
+            wallet::UtxoEntry utxo;
+            utxo.txId = txid;
+            utxo.vout = n;
+            if (rpc::gettxout(m_user, m_passwd, m_ip, m_port, utxo) && utxo.hasConfirmations)
+            {
+                *confirmations = utxo.confirmations;
+                return true;
+            }
+        }
+        // All outputs spent, the verbose reply below reports confirmations
+    }
+
+    // Not in the bitcoin format (or confirmations still unknown), use the
+    // wallet's verbose reply
+    std::string json;
+    if (!rpc::getRawTransaction(m_user, m_passwd, m_ip, m_port, txid, true, json))
+        return false;
+
+    json_spirit::Value txv;
+    if (!json_spirit::read_string(json, txv) || txv.type() != json_spirit::obj_type)
+        return false;
+
+    return decodeTransactionReply(txv.get_obj(), txid, tx, confirmations);
+}
+
 //******************************************************************************
 // return false if deposit tx not found (need wait tx)
 // true if tx found and checked
@@ -1990,51 +2318,31 @@ bool BtcWalletConnector<CryptoProvider>::checkDepositTransaction(const std::stri
     isGood  = false;
     excessAmount = 0;
 
-    std::string tx;
-    if (!rpc::getRawTransaction(m_user, m_passwd, m_ip, m_port, depositTxId, false, tx))
+    bool found{false};
+    int64_t txConfirmations{-1};
+    CMutableTransaction tx;
+    if (!getDecodedTransaction(depositTxId, tx, found, &txConfirmations))
     {
-        LOG() << "no tx found " << depositTxId << " ...waiting " << __FUNCTION__;
-        return false;
-    }
-
-    std::string rawtx;
-    std::string reftxid;
-    if (!rpc::decodeRawTransaction(m_user, m_passwd, m_ip, m_port, tx, reftxid, rawtx))
-    {
-        LOG() << "bad counterparty deposit, decode transaction failed " << depositTxId << " " << tx << " " << __FUNCTION__;
+        if (!found)
+        {
+            LOG() << "no tx found " << depositTxId << " ...waiting " << __FUNCTION__;
+            return false;
+        }
+        LOG() << "bad counterparty deposit, decode transaction failed " << depositTxId << " " << __FUNCTION__;
         return true; // done
     }
 
     // check confirmations
-    json_spirit::Value txv;
-    if (!json_spirit::read_string(rawtx, txv))
-    {
-        LOG() << "json read error for " << depositTxId << " " << rawtx << " ...waiting " << __FUNCTION__;
-        return false;
-    }
-
-    json_spirit::Object txo = txv.get_obj();
-
     if (requiredConfirmations > 0)
     {
         uint32_t confs{0};
 
-        // Check for confirmations in raw transaction output
-        json_spirit::Value txvConfCount = json_spirit::find_value(txo, "confirmations");
-        if (txvConfCount.type() != json_spirit::int_type) { // If not found check gettxout for confirmations
-            wallet::UtxoEntry utxo;
-            utxo.txId = depositTxId;
-            utxo.vout = depositTxVout;
-            if (rpc::gettxout(m_user, m_passwd, m_ip, m_port, utxo) && utxo.hasConfirmations) {
-                confs = utxo.confirmations;
-            } else { // confirmation field not found, fail
-                LOG() << "confirmations data not found in gettxout for " << depositTxId
-                      << " this order may be stuck and may need to be canceled " << __FUNCTION__;
-                return false;
-            }
-        } else {
-            confs = static_cast<uint32_t>(txvConfCount.get_int());
+        if (txConfirmations < 0) { // confirmation field not found, fail
+            LOG() << "confirmations data not found for " << depositTxId
+                  << " this order may be stuck and may need to be canceled " << __FUNCTION__;
+            return false;
         }
+        confs = static_cast<uint32_t>(txConfirmations);
 
         if (confs < requiredConfirmations)
         {
@@ -2047,120 +2355,89 @@ bool BtcWalletConnector<CryptoProvider>::checkDepositTransaction(const std::stri
     // Ensure p2sh accounts for fees
 
     // Check vins
-    json_spirit::Value vinso = json_spirit::find_value(txo, "vin");
-    if (vinso.type() != json_spirit::array_type || vinso.get_array().empty()) {
+    if (tx.vin.empty()) {
         LOG() << "tx " << depositTxId << " no vins " << __FUNCTION__;
         return true; // done
     }
-    json_spirit::Array vins = vinso.get_array();
 
     // Check vouts
-    json_spirit::Value voutso = json_spirit::find_value(txo, "vout");
-    if (voutso.type() != json_spirit::array_type || voutso.get_array().empty()) {
+    if (tx.vout.empty()) {
         LOG() << "tx " << depositTxId << " no vouts " << __FUNCTION__;
         return true; // done
     }
-    json_spirit::Array vouts = voutso.get_array();
 
-    // Add up all vin amounts (prevouts)
-    double totalVinAmount{0};
-    for (auto & vin : vins) {
-        const json_spirit::Value & txidObj = json_spirit::find_value(vin.get_obj(), "txid");
-        if (txidObj.type() != json_spirit::str_type) {
+    // Check vin sequences and collect the distinct prevout txids
+    std::vector<std::string> vinTxIds;
+    for (const CTxIn & vin : tx.vin) {
+        if (vin.prevout.IsNull()) {
             LOG() << "tx " << depositTxId << " bad vin txid " << __FUNCTION__;
             return true; // done
         }
-        const json_spirit::Value & txSequence = json_spirit::find_value(vin.get_obj(), "sequence");
-        if (txSequence.type() != json_spirit::null_type) { // if sequence is available, then enforce
-            if (txSequence.type() != json_spirit::int_type) {
-                LOG() << "tx " << depositTxId << " bad sequence type " << __FUNCTION__;
-                return true; // done
-            } else if (txSequence.get_int64() != xbridge::SEQUENCE_FINAL) {
-                LOG() << "tx " << depositTxId << " sequence " << txSequence.get_int64()
-                      << " bad sequence for input, expected " << xbridge::SEQUENCE_FINAL
-                      << " " << __FUNCTION__;
-                return true; // done
-            }
-        }
-        const json_spirit::Value & txVoutObj = json_spirit::find_value(vin.get_obj(), "vout");
-        if (txVoutObj.type() != json_spirit::int_type) {
-            LOG() << "tx " << depositTxId << " bad input vout " << __FUNCTION__;
+        if (vin.nSequence != xbridge::SEQUENCE_FINAL) {
+            LOG() << "tx " << depositTxId << " sequence " << vin.nSequence
+                  << " bad sequence for input, expected " << xbridge::SEQUENCE_FINAL
+                  << " " << __FUNCTION__;
             return true; // done
         }
-        // Check prevout amount
-        const auto & vinTxId = txidObj.get_str();
-        const auto & vinTxVout = txVoutObj.get_int();
-        std::string vinTx;
-        if (!rpc::getRawTransaction(m_user, m_passwd, m_ip, m_port, vinTxId, true, vinTx)) {
+        const std::string vinTxId = vin.prevout.hash.GetHex();
+        if (std::find(vinTxIds.begin(), vinTxIds.end(), vinTxId) == vinTxIds.end())
+            vinTxIds.push_back(vinTxId);
+    }
+
+    // Fetch all prevout transactions in one request
+    std::map<std::string, json_spirit::Object> vinReplies;
+    if (!rpc::getRawTransactions(m_user, m_passwd, m_ip, m_port, vinTxIds, vinReplies)) {
+        LOG() << "vin txs not available for deposit " << depositTxId << " ...waiting " << __FUNCTION__;
+        return false;
+    }
+    std::map<std::string, CMutableTransaction> vinTxs;
+    for (const auto & vinTxId : vinTxIds) {
+        const auto it = vinReplies.find(vinTxId);
+        if (it == vinReplies.end()) {
             LOG() << "vin tx not found for deposit " << depositTxId << " vin txid: " << vinTxId << " ...waiting " << __FUNCTION__;
             return false;
         }
-        json_spirit::Value vinTxv;
-        if (!json_spirit::read_string(vinTx, vinTxv)) {
-            LOG() << "vin json read error for deposit " << depositTxId << " vin raw tx: " << vinTx << " ...waiting " << __FUNCTION__;
+        if (!decodeTransactionReply(it->second, vinTxId, vinTxs[vinTxId], nullptr)) {
+            LOG() << "vin tx decode failed for deposit " << depositTxId << " vin txid: " << vinTxId << " ...waiting " << __FUNCTION__;
             return false;
         }
-        json_spirit::Object vinTxo = vinTxv.get_obj();
-        json_spirit::Array vinOuts = json_spirit::find_value(vinTxo, "vout").get_array();
-        if (vinOuts.empty() || vinTxVout >= static_cast<int>(vinOuts.size())) {
+    }
+
+    // Add up all vin amounts (prevouts)
+    double totalVinAmount{0};
+    for (const CTxIn & vin : tx.vin) {
+        // Check prevout amount
+        const CMutableTransaction & vinTx = vinTxs[vin.prevout.hash.GetHex()];
+        if (vin.prevout.n >= vinTx.vout.size()) {
             LOG() << "tx " << depositTxId << " bad vin, missing outputs " << __FUNCTION__;
             return true; // done
         }
-        bool foundVout{false};
-        double vinAmount{0};
-        for (const auto & vout : vinOuts) {
-            const json_spirit::Value & valObj = json_spirit::find_value(vout.get_obj(), "value");
-            const json_spirit::Value & nObj = json_spirit::find_value(vout.get_obj(), "n");
-            if (valObj.type() != json_spirit::real_type || nObj.type() != json_spirit::int_type)
-                continue;
-            if (nObj.get_int() == vinTxVout) {
-                vinAmount = valObj.get_real();
-                foundVout = true;
-                break;
-            }
-        }
-        if (!foundVout) {
-            LOG() << "tx " << depositTxId << " bad prevout " << vinTxId << " " << __FUNCTION__;
-            return true; // done
-        }
-        totalVinAmount += vinAmount;
+        totalVinAmount += static_cast<double>(vinTx.vout[vin.prevout.n].nValue) / COIN;
     }
 
     // Add up all vout amounts
     double totalVoutAmount{0};
     double depositP2SHAmount{0};
-    for (auto & vout : vouts) {
-        const json_spirit::Value & amountObj = json_spirit::find_value(vout.get_obj(), "value");
-        if (amountObj.type() != json_spirit::real_type) {
-            LOG() << "tx " << depositTxId << " bad vout amount " << __FUNCTION__;
-            return true; // done
-        }
-        const json_spirit::Value & nObj = json_spirit::find_value(vout.get_obj(), "n");
-        if (nObj.type() != json_spirit::int_type) {
-            LOG() << "tx " << depositTxId << " bad vout n " << __FUNCTION__;
-            return true; // done
-        }
-        if (amountObj.get_real() < 0) {
+    CAmount depositP2SHValue{0};
+    bool foundScript{false};
+    const std::vector<unsigned char> expected = ParseHex(expectedScript);
+    for (uint32_t n = 0; n < tx.vout.size(); ++n) {
+        const CTxOut & vout = tx.vout[n];
+        if (vout.nValue < 0) {
             LOG() << "tx " << depositTxId << " bad vout, has negative amount " << __FUNCTION__;
             return true; // done
         }
-        totalVoutAmount += amountObj.get_real();
+        const double value = static_cast<double>(vout.nValue) / COIN;
+        totalVoutAmount += value;
 
-        // Check all vouts for valid deposit
-        const json_spirit::Value & scriptPubKey = json_spirit::find_value(vout.get_obj(), "scriptPubKey");
-        const json_spirit::Value & hex = json_spirit::find_value(scriptPubKey.get_obj(), "hex");
-        if (scriptPubKey.type() == json_spirit::null_type || hex.type() == json_spirit::null_type)
+        // Check that expected script and amounts match, only the first match counts
+        if (foundScript || vout.scriptPubKey != CScript(expected.begin(), expected.end()))
             continue;
-
-        // Check that expected script and amounts match
-        if (expectedScript == hex.get_str()) {
-            const json_spirit::Value & vamount = json_spirit::find_value(vout.get_obj(), "value");
-            const json_spirit::Value & n = json_spirit::find_value(vout.get_obj(), "n");
-            if (amount <= vamount.get_real() + std::numeric_limits<double>::epsilon()) {
-                depositP2SHAmount = vamount.get_real();
-                depositTxVout = static_cast<uint32_t>(n.get_int());
-            }
-            break; // done searching
+        foundScript = true;
+        if (amount <= value + std::numeric_limits<double>::epsilon()) {
+            depositP2SHAmount = value;
+            depositP2SHValue = vout.nValue;
+            depositTxVout = n;
         }
     }
 
@@ -2171,7 +2448,7 @@ bool BtcWalletConnector<CryptoProvider>::checkDepositTransaction(const std::stri
 
     // Check if there's enough to cover fees
     const double counterpartyFees = totalVinAmount - totalVoutAmount;
-    const double fee1 = minTxFee1(static_cast<uint32_t>(vins.size()), static_cast<uint32_t>(vouts.size())); // p2sh deposit fee
+    const double fee1 = minTxFee1(static_cast<uint32_t>(tx.vin.size()), static_cast<uint32_t>(tx.vout.size())); // p2sh deposit fee
     const double fee2 = minTxFee2(1, 1); // p2sh redeem fee
     const double ourMinimumFees = fee1 * 0.95; // Allow 5% margin of error in fee amount
     // Check that counterparty provided enough to cover deposit network fee
@@ -2188,7 +2465,7 @@ bool BtcWalletConnector<CryptoProvider>::checkDepositTransaction(const std::stri
     if (depositP2SHAmount > amount + fee2)
         excessAmount = depositP2SHAmount - amount - fee2;
 
-    p2shAmount = depositP2SHAmount * COIN;
+    p2shAmount = static_cast<uint64_t>(depositP2SHValue);
     isGood = true;
     return true; // done
 }
@@ -2218,48 +2495,21 @@ bool BtcWalletConnector<CryptoProvider>::getSecretFromPaymentTransaction(const s
 {
     isGood = false;
 
-    std::string rawtx;
-    if (!rpc::getRawTransaction(m_user, m_passwd, m_ip, m_port, paymentTxId, true, rawtx))
-    {
-        LOG() << "no tx found " << paymentTxId << " " << __FUNCTION__;
-        return false;
-    }
-
-    json_spirit::Value txv;
-    if (!json_spirit::read_string(rawtx, txv))
+    bool found{false};
+    CMutableTransaction tx;
+    if (!getDecodedTransaction(paymentTxId, tx, found))
     {
-        LOG() << "json read error for " << paymentTxId << " " << rawtx << " " << __FUNCTION__;
+        LOG() << (found ? "decode failed for tx " : "no tx found ") << paymentTxId << " " << __FUNCTION__;
         return false;
     }
 
-    json_spirit::Object txo = txv.get_obj();
-
-    // extract secret from vins
-    json_spirit::Array vins = json_spirit::find_value(txo, "vin").get_array();
-
     // Check all vins for secret
-    for (auto & vin : vins) {
-        const json_spirit::Value & depositId = json_spirit::find_value(vin.get_obj(), "txid");
-        if (depositId.type() == json_spirit::null_type)
-            continue;
-
-        const json_spirit::Value & voutN = json_spirit::find_value(vin.get_obj(), "vout");
-        if (voutN.type() == json_spirit::null_type)
-            continue;
-
-        if (depositId.get_str() != depositTxId || voutN.get_int() != depositTxVOut)
-            continue;
-
-        const json_spirit::Value & scriptPubKey = json_spirit::find_value(vin.get_obj(), "scriptSig");
-        if (scriptPubKey.type() == json_spirit::null_type)
-            continue;
-
-        const json_spirit::Value & hex = json_spirit::find_value(scriptPubKey.get_obj(), "hex");
-        if (hex.type() == json_spirit::null_type)
+    const uint256 depositHash = uint256S(depositTxId);
+    for (const CTxIn & vin : tx.vin) {
+        if (vin.prevout.hash != depositHash || vin.prevout.n != depositTxVOut)
             continue;
 
-        auto ssig = ParseHex(hex.get_str());
-        CScript scriptSig(ssig.begin(), ssig.end());
+        const CScript & scriptSig = vin.scriptSig;
         std::vector<unsigned char> chk;
         opcodetype op;
         CScript::const_iterator pc = scriptSig.begin();
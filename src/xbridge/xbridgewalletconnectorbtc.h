@@ -14,12 +14,14 @@
 #include <rpc/protocol.h>
 #include <rpc/client.h>
 #include <support/events.h>
+#include <sync.h>
 #include <tinyformat.h>
 #include <util/strencodings.h>
 #include <util/system.h>
 #include <univalue.h>
 
 #include <memory>
+#include <vector>
 
 #include <json/json_spirit.h>
 #include <json/json_spirit_reader_template.h>
@@ -108,10 +110,9 @@ static UniValue XBridgeJSONRPCRequestObj(const std::string& strMethod, const Uni
     return request;
 }
 
-static json_spirit::Object CallRPC(const std::string & rpcuser, const std::string & rpcpasswd,
+static std::string PostRPC(const std::string & rpcuser, const std::string & rpcpasswd,
                       const std::string & rpcip, const std::string & rpcport,
-                      const std::string & strMethod, const json_spirit::Array & params,
-                      const std::string & jsonver="", const std::string & contenttype="")
+                      const std::string & strRequest, const std::string & contenttype)
 {
     const std::string & host = rpcip;
     const int port = boost::lexical_cast<int>(rpcport);
@@ -145,12 +146,6 @@ static json_spirit::Object CallRPC(const std::string & rpcuser, const std::strin
     }
 
     // Attach request data
-    const auto tostring = json_spirit::write_string(json_spirit::Value(params), json_spirit::none, 8);
-    UniValue toval;
-    if (!toval.read(tostring))
-        throw std::runtime_error(strprintf("failed to decode json_spirit data: %s", tostring));
-    const auto reqobj = XBridgeJSONRPCRequestObj(strMethod, toval.get_array(), 1, jsonver);
-    std::string strRequest = reqobj.write() + "\n";
     struct evbuffer* output_buffer = evhttp_request_get_output_buffer(req.get());
     assert(output_buffer);
     evbuffer_add(output_buffer, strRequest.data(), strRequest.size());
@@ -178,9 +173,29 @@ static json_spirit::Object CallRPC(const std::string & rpcuser, const std::strin
     else if (response.body.empty())
         throw std::runtime_error("no response from server");
 
+    return response.body;
+}
+
+static UniValue XBridgeJSONRPCParams(const json_spirit::Array & params)
+{
+    const auto tostring = json_spirit::write_string(json_spirit::Value(params), json_spirit::none, 8);
+    UniValue toval;
+    if (!toval.read(tostring))
+        throw std::runtime_error(strprintf("failed to decode json_spirit data: %s", tostring));
+    return toval;
+}
+
+static json_spirit::Object CallRPC(const std::string & rpcuser, const std::string & rpcpasswd,
+                      const std::string & rpcip, const std::string & rpcport,
+                      const std::string & strMethod, const json_spirit::Array & params,
+                      const std::string & jsonver="", const std::string & contenttype="")
+{
+    const auto reqobj = XBridgeJSONRPCRequestObj(strMethod, XBridgeJSONRPCParams(params), 1, jsonver);
+    const std::string body = PostRPC(rpcuser, rpcpasswd, rpcip, rpcport, reqobj.write() + "\n", contenttype);
+
     // Parse reply
     json_spirit::Value valReply;
-    if (!json_spirit::read_string(response.body, valReply))
+    if (!json_spirit::read_string(body, valReply))
         throw std::runtime_error("couldn't parse reply from server");
     const json_spirit::Object& reply = valReply.get_obj();
     if (reply.empty())
@@ -189,6 +204,34 @@ static json_spirit::Object CallRPC(const std::string & rpcuser, const std::strin
     return reply;
 }
 
+/**
+ * Send several calls of the same method in one JSON-RPC batch request.
+ * The reply holds one object per call, the id of each is its index in paramsList.
+ * Throws if the server does not answer with a batch, callers should fall back to CallRPC.
+ */
+static json_spirit::Array CallRPCBatch(const std::string & rpcuser, const std::string & rpcpasswd,
+                      const std::string & rpcip, const std::string & rpcport,
+                      const std::string & strMethod, const std::vector<json_spirit::Array> & paramsList,
+                      const std::string & jsonver="", const std::string & contenttype="")
+{
+    UniValue batch(UniValue::VARR);
+    for (size_t i = 0; i < paramsList.size(); ++i)
+        batch.push_back(XBridgeJSONRPCRequestObj(strMethod, XBridgeJSONRPCParams(paramsList[i]), static_cast<int>(i), jsonver));
+    const std::string body = PostRPC(rpcuser, rpcpasswd, rpcip, rpcport, batch.write() + "\n", contenttype);
+
+    // Parse reply
+    json_spirit::Value valReply;
+    if (!json_spirit::read_string(body, valReply))
+        throw std::runtime_error("couldn't parse reply from server");
+    if (valReply.type() != json_spirit::array_type)
+        throw std::runtime_error("server does not support batch requests");
+
+    return valReply.get_array();
+}
+
+/** Seconds a connector trusts its utxo mirror while the wallet's block count is unchanged */
+static constexpr int64_t UTXO_MIRROR_MAX_AGE = 15;
+
 //*****************************************************************************
 //*****************************************************************************
 template <class CryptoProvider>
@@ -312,8 +355,52 @@ public:
 
     bool getTransactionsInBlock(const std::string & blockHash, std::vector<std::string> & txids);
 
+protected:
+    /**
+     * @brief getDecodedTransaction fetch a raw transaction from the wallet and decode it in-process,
+     * falling back to the wallet's verbose decoding for chains not using the bitcoin format
+     * @param txid transaction id
+     * @param tx decoded transaction
+     * @param found false if the wallet does not have the transaction
+     * @param confirmations if set, receives the confirmations (from gettxout, or the verbose reply if
+     * all outputs are spent) or -1 if the wallet did not report any
+     * @return true if the transaction was found and decoded
+     */
+    bool getDecodedTransaction(const std::string & txid, CMutableTransaction & tx, bool & found,
+                               int64_t * confirmations = nullptr) const;
+
+    /**
+     * @brief decodeTransactionReply decode a verbose getrawtransaction reply
+     * @param txo reply object
+     * @param txid transaction id
+     * @param tx decoded transaction
+     * @param confirmations if set, receives the reported confirmations or -1 if the wallet did not report any
+     * @return true if the reply holds a valid transaction
+     */
+    bool decodeTransactionReply(const json_spirit::Object & txo, const std::string & txid,
+                                CMutableTransaction & tx, int64_t * confirmations) const;
+
 protected:
     CryptoProvider m_cp;
+
+private:
+    /**
+     * @brief removeSpentFromUtxoMirror drop the inputs of a transaction we broadcast from the utxo mirror
+     * @param rawtx hex of the transaction
+     * @param txid id of the transaction
+     */
+    void removeSpentFromUtxoMirror(const std::string & rawtx, const std::string & txid);
+
+    /**
+     * Parsed listunspent p2pkh outputs. Refreshed from the wallet when its block count
+     * changes or the copy is older than UTXO_MIRROR_MAX_AGE, and updated locally when
+     * this connector broadcasts a transaction.
+     */
+    mutable CCriticalSection m_utxoMirrorLock;
+    mutable std::vector<wallet::UtxoEntry> m_utxoMirror GUARDED_BY(m_utxoMirrorLock);
+    mutable uint32_t m_utxoMirrorBlocks GUARDED_BY(m_utxoMirrorLock){0};
+    mutable int64_t m_utxoMirrorTime GUARDED_BY(m_utxoMirrorLock){0};
+    mutable bool m_utxoMirrorValid GUARDED_BY(m_utxoMirrorLock){false};
 };
 
 } // namespace xbridge
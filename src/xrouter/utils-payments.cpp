@@ -164,9 +164,13 @@ bool createAndSignTransaction(const std::string & toaddress, const CAmount & toa
     const CTransaction txConst(mtx);
     raw_tx = EncodeHexTx(txConst);
 
-    // lock used coins
+    // lock used coins, fails if a concurrent fee payment took one of them
     std::set<xbridge::wallet::UtxoEntry> feeUtxos{outputsForUse.begin(), outputsForUse.end()};
-    xbridge::App::instance().lockFeeUtxos(feeUtxos);
+    if (!xbridge::App::instance().lockFeeUtxos(feeUtxos)) {
+        ERR() << "Fee tx inputs are already in use";
+        raw_tx.clear();
+        return false;
+    }
 
     return true;
 #endif // ENABLE_WALLET
@@ -65,7 +65,8 @@ static std::vector<CNode*> CopyNodes() {
 
 //*****************************************************************************
 //*****************************************************************************
-App::App() : timerThread(boost::bind(&boost::asio::io_service::run, &timerIo))
+App::App() : timerIoWork(std::make_shared<boost::asio::io_service::work>(timerIo))
+           , timerThread(boost::bind(&boost::asio::io_service::run, &timerIo))
            , timer(timerIo, boost::posix_time::seconds(XROUTER_TIMER_SECONDS))
 {
 }
@@ -133,6 +134,12 @@ bool App::init(const boost::filesystem::path & xrouterDir)
     }
 
     LOG() << "Loading xrouter config from file " << xrouterpath.string();
+
+    // Servicenode configs from previous sessions
+    configCache = std::unique_ptr<XRouterConfigCache>(new XRouterConfigCache(GetDataDir() / "xrouterconfigs.dat"));
+    if (configCache->load())
+        LOG() << "Loaded " << configCache->size() << " servicenode configs from cache";
+
     return true;
 }
 
@@ -169,6 +176,11 @@ bool App::start()
     }
 
     stopped = false;
+
+    // Keep the warm connection pool filled
+    timer.expires_from_now(boost::posix_time::seconds(XROUTER_TIMER_SECONDS));
+    timer.async_wait(boost::bind(&App::onTimer, this));
+
     return true;
 }
 
@@ -372,16 +384,19 @@ bool App::openConnections(enum XRouterCommand command, const std::string & servi
         CAddress addr(snode.getHostAddr(), NODE_NONE);
         CNode *node = g_connman->OpenXRouterConnection(addr, snodeAddr.c_str()); // Filters out bad nodes (banned, etc)
         if (node) {
-            const auto startTime = GetTime();
-            while (!node->fSuccessfullyConnected) { // wait n seconds for node to become available
-                const auto currentTime = GetTime();
-                if (ShutdownRequested() || currentTime - startTime > 3) { // wait 3 seconds
-                    checkSnodeBan(snodeAddr, queryMgr.updateScore(snodeAddr, -5));
-                    pendingConnMgr.notify(snodeAddr);
-                    return;
-                }
-                boost::this_thread::interruption_point();
-                boost::this_thread::sleep_for(boost::chrono::milliseconds(10));
+            bool handshake{false};
+            { // wait 3 seconds for the version handshake, onNodeConnected() signals completion
+                boost::mutex::scoped_lock lock(connMu);
+                handshake = connCond.timed_wait(lock, boost::posix_time::seconds(3), [node]() {
+                    return ShutdownRequested() || node->fSuccessfullyConnected || node->fDisconnect
+                                               || boost::this_thread::interruption_requested();
+                }) && node->fSuccessfullyConnected;
+            }
+            boost::this_thread::interruption_point();
+            if (!handshake) {
+                checkSnodeBan(snodeAddr, queryMgr.updateScore(snodeAddr, -5));
+                pendingConnMgr.notify(snodeAddr);
+                return;
             }
             LOG() << "Connected to servicenode " << EncodeDestination(CTxDestination(snode.getPaymentAddress()));
             addNode(node); // store the node connection
@@ -399,7 +414,8 @@ bool App::openConnections(enum XRouterCommand command, const std::string & servi
 
     // Check if existing snode connections have what we need
     std::set<NodeAddr> snodesConnected;
-    for (auto & s : snodes) {
+    const auto & serviceSnodes = sn::ServiceNodeMgr::instance().listWithServices({xr, fqServiceAdjusted}); // has xrouter and the service
+    for (auto & s : serviceSnodes) {
         const auto & snodeAddr = s.getHostPort();
         if (!nodec.count(snodeAddr)) // skip non-connected nodes
             continue;
@@ -413,12 +429,6 @@ bool App::openConnections(enum XRouterCommand command, const std::string & servi
         if (connectedSnodes.count(snodeAddr)) // skip already selected nodes
             continue;
 
-        if (!s.hasService(xr)) // has xrouter
-            continue;
-
-        if (!s.hasService(fqServiceAdjusted)) // has the service
-            continue;
-
         if (hasConfig(snodeAddr)) // has config, count it
             snodesConnected.insert(snodeAddr);
     }
@@ -585,9 +595,13 @@ bool App::stop(const bool safeCleanup)
         LOG() << "stopping xrouter threads...";
 
     timer.cancel();
+    timerIoWork.reset();
     timerIo.stop();
     timerThread.join();
 
+    if (configCache)
+        configCache->save();
+
     if (safeCleanup && (!isEnabled() || !isReady()))
         return false;
 
@@ -845,43 +859,9 @@ bool App::processConfigReply(CNode *node, XRouterPacketPtr packet, CValidationSt
     std::string reply((const char *)packet->data()+offset);
     offset += reply.size() + 1;
 
-    try {
-        Value reply_val;
-        read_string(reply, reply_val);
-        Object reply_obj = reply_val.get_obj();
-        std::string config = find_value(reply_obj, "config").get_str();
-        Object plugins = find_value(reply_obj, "plugins").get_obj();
-
-        auto settings = std::make_shared<XRouterSettings>(CPubKey(spubkey.begin(), spubkey.end()), false); // not our config
-        auto configInit = settings->init(config);
-        if (!configInit) {
-            ERR() << "Failed to read config on query " << uuid << " from node " << nodeAddr;
-            checkSnodeBan(nodeAddr, queryMgr.updateScore(nodeAddr, -10));
-            reply = "Failed to parse config from XRouter node " + nodeAddr + "\n" + reply;
-            queryMgr.addReply(uuid, nodeAddr, reply);
-            queryMgr.purge(uuid, nodeAddr);
-            return false;
-        }
-
-        for (const auto & plugin : plugins) {
-            try {
-                auto psettings = std::make_shared<XRouterPluginSettings>(false); // not our config
-                psettings->read(plugin.value_.get_str());
-                // Exclude open tier paid services
-                if (!(snode.getTier() == sn::ServiceNode::OPEN && psettings->fee() > std::numeric_limits<double>::epsilon()))
-                    settings->addPlugin(plugin.name_, psettings);
-            } catch (...) {
-                ERR() << "Failed to read plugin " << plugin.name_ << " on query " << uuid << " from node " << nodeAddr;
-                checkSnodeBan(nodeAddr, queryMgr.updateScore(nodeAddr, -2));
-            }
-        }
-
-        // Update settings for node
-        updateConfig(snode, settings);
-        queryMgr.addReply(uuid, nodeAddr, reply);
-        queryMgr.purge(uuid, nodeAddr);
-
-    } catch (...) {
+    XRouterSettingsPtr settings;
+    int badPlugins{0};
+    if (!configFromReply(snode, CPubKey(spubkey.begin(), spubkey.end()), reply, settings, badPlugins)) {
         ERR() << "Failed to read config on query " << uuid << " from node " << nodeAddr;
         checkSnodeBan(nodeAddr, queryMgr.updateScore(nodeAddr, -10));
         reply = "Failed to parse config from XRouter node " + nodeAddr + "\n" + reply;
@@ -889,6 +869,15 @@ bool App::processConfigReply(CNode *node, XRouterPacketPtr packet, CValidationSt
         queryMgr.purge(uuid, nodeAddr);
         return false;
     }
+    if (badPlugins > 0)
+        checkSnodeBan(nodeAddr, queryMgr.updateScore(nodeAddr, -2 * badPlugins));
+
+    // Update settings for node
+    updateConfig(snode, settings);
+    if (configCache && !snode.isNull())
+        configCache->put(snode.getSnodePubKey(), snodeConfigVersion(snode), reply);
+    queryMgr.addReply(uuid, nodeAddr, reply);
+    queryMgr.purge(uuid, nodeAddr);
 
     LOG() << "Received reply to query " << uuid << " from node " << nodeAddr << "\n" << reply;
 
@@ -900,20 +889,36 @@ bool App::processConfigMessage(const sn::ServiceNode & snode) {
     if (smgr.hasActiveSn() && smgr.getActiveSn().key.GetPubKey() == snode.getSnodePubKey())
         return false; // do not process own config
 
+    // Fall back on the config this snode sent in its last xrGetConfig reply, if
+    // the snode hasn't changed its config since. Saves a config request.
+    auto fromCache = [this,&snode]() -> bool {
+        std::string reply;
+        if (!configCache || !configCache->get(snode.getSnodePubKey(), snodeConfigVersion(snode), reply))
+            return false;
+        XRouterSettingsPtr settings;
+        int badPlugins{0};
+        if (!configFromReply(snode, snode.getSnodePubKey(), reply, settings, badPlugins)) {
+            configCache->erase(snode.getSnodePubKey());
+            return false;
+        }
+        updateConfig(snode, settings);
+        return true;
+    };
+
     const auto & rawconfig = snode.getConfig("xrouter");
     UniValue uv;
     if (!uv.read(rawconfig))
-        return false;
+        return fromCache();
 
     auto settings = std::make_shared<XRouterSettings>(snode.getSnodePubKey(), false); // not our config
     try {
         const auto uvconf = find_value(uv, "config");
         if (uvconf.isNull() || !uvconf.isStr())
-            return false;
+            return fromCache();
         if (!settings->init(uvconf.get_str()))
-            return false;
+            return fromCache();
     } catch (...) {
-        return false;
+        return fromCache();
     }
 
     const auto & plugins = find_value(uv, "plugins");
@@ -937,6 +942,45 @@ bool App::processConfigMessage(const sn::ServiceNode & snode) {
     return true;
 }
 
+bool App::configFromReply(const sn::ServiceNode & snode, const CPubKey & spubkey, const std::string & reply,
+                          XRouterSettingsPtr & settings, int & badPlugins)
+{
+    badPlugins = 0;
+    try {
+        Value reply_val;
+        read_string(reply, reply_val);
+        Object reply_obj = reply_val.get_obj();
+        std::string config = find_value(reply_obj, "config").get_str();
+        Object plugins = find_value(reply_obj, "plugins").get_obj();
+
+        settings = std::make_shared<XRouterSettings>(spubkey, false); // not our config
+        if (!settings->init(config))
+            return false;
+
+        for (const auto & plugin : plugins) {
+            try {
+                auto psettings = std::make_shared<XRouterPluginSettings>(false); // not our config
+                psettings->read(plugin.value_.get_str());
+                // Exclude open tier paid services
+                if (!(snode.getTier() == sn::ServiceNode::OPEN && psettings->fee() > std::numeric_limits<double>::epsilon()))
+                    settings->addPlugin(plugin.name_, psettings);
+            } catch (...) {
+                ERR() << "Failed to read plugin " << plugin.name_ << " from node " << snode.getHostPort();
+                ++badPlugins;
+            }
+        }
+    } catch (...) {
+        return false;
+    }
+    return true;
+}
+
+uint256 App::snodeConfigVersion(const sn::ServiceNode & snode) {
+    CHashWriter ss(SER_GETHASH, 0);
+    ss << snode.getConfig();
+    return ss.GetHash();
+}
+
 //*****************************************************************************
 //*****************************************************************************
 void App::onMessageReceived(CNode* node, const std::vector<unsigned char> & message)
@@ -1874,6 +1918,120 @@ void App::getLatestNodeContainers(std::vector<sn::ServiceNode> & snodes, std::ve
     }
 }
 
+void App::onNodeConnected(CNode *pnode) {
+    {
+        boost::mutex::scoped_lock lock(connMu);
+        connCond.notify_all(); // wake connections waiting on the handshake
+    }
+
+    if (!isReady() || stopped)
+        return;
+
+    // Fetch the config of warm snodes that aren't already handled by openConnections
+    const auto & nodeAddr = pnode->GetAddrName();
+    {
+        LOCK(mu);
+        if (!warmNodes.count(nodeAddr))
+            return;
+    }
+    if (!pendingConnMgr.hasPendingConnection(nodeAddr))
+        requestWarmConfig(pnode);
+}
+
+void App::requestWarmConfig(CNode *pnode) {
+    const auto & nodeAddr = pnode->GetAddrName();
+    if (hasConfig(nodeAddr) || !needConfigUpdate(nodeAddr))
+        return;
+    queryMgr.updateSentRequest(nodeAddr, XRouterCommand_ToString(xrGetConfig));
+    const auto uuid = sendXRouterConfigRequest(pnode);
+    LOG() << "Requesting config from warm snode " << nodeAddr << " query " << uuid;
+    LOCK(mu);
+    warmConfigQueries.push_back(uuid);
+}
+
+void App::onTimer() {
+    if (stopped || ShutdownRequested())
+        return;
+
+    maintainConnectionPool();
+    if (configCache)
+        configCache->save();
+
+    if (stopped)
+        return;
+    timer.expires_at(timer.expires_at() + boost::posix_time::seconds(XROUTER_TIMER_SECONDS));
+    timer.async_wait(boost::bind(&App::onTimer, this));
+}
+
+void App::maintainConnectionPool() {
+    // Replies to the previous round of config requests have arrived by now
+    std::vector<std::string> queries;
+    {
+        LOCK(mu);
+        queries.swap(warmConfigQueries);
+    }
+    for (const auto & uuid : queries)
+        queryMgr.purge(uuid);
+
+    const auto services = xrsettings->warmServices();
+    const auto perService = xrsettings->warmConnections();
+    if (services.empty() || perService <= 0) {
+        LOCK(mu);
+        warmNodes.clear();
+        return;
+    }
+
+    std::vector<sn::ServiceNode> snodes;
+    std::vector<CNode*> nodes;
+    std::map<NodeAddr, sn::ServiceNode> snodec;
+    std::map<NodeAddr, CNode*> nodec;
+    getLatestNodeContainers(snodes, nodes, snodec, nodec);
+
+    // Select the highest scoring snodes for each service
+    std::map<NodeAddr, sn::ServiceNode> warm;
+    for (const auto & service : services) {
+        std::vector<sn::ServiceNode> candidates;
+        for (const auto & s : sn::ServiceNodeMgr::instance().listWithServices({xr, service})) {
+            if (snodec.count(s.getHostPort()) && s.running() && !s.isEXRCompatible()) // skip banned, self and EXR snodes
+                candidates.push_back(s);
+        }
+        const auto n = std::min(candidates.size(), static_cast<size_t>(perService));
+        std::partial_sort(candidates.begin(), candidates.begin() + n, candidates.end(),
+            [this](const sn::ServiceNode & a, const sn::ServiceNode & b) {
+                return queryMgr.getScore(a.getHostPort()) > queryMgr.getScore(b.getHostPort());
+            });
+        for (size_t i = 0; i < n; ++i)
+            warm[candidates[i].getHostPort()] = candidates[i];
+    }
+
+    {
+        LOCK(mu);
+        warmNodes.clear();
+        for (const auto & item : warm)
+            warmNodes.insert(item.first);
+    }
+
+    // Connect to the snodes that aren't connected, the handshake and the
+    // config request complete in onNodeConnected
+    for (const auto & item : warm) {
+        if (stopped || ShutdownRequested())
+            break;
+        const auto & snodeAddr = item.first;
+        if (nodec.count(snodeAddr)) {
+            auto pnode = nodec[snodeAddr];
+            if (pnode->fSuccessfullyConnected && !pnode->fDisconnect)
+                requestWarmConfig(pnode);
+            continue;
+        }
+        if (pendingConnMgr.hasPendingConnection(snodeAddr))
+            continue; // openConnections is on it
+        CAddress addr(item.second.getHostAddr(), NODE_NONE);
+        g_connman->OpenXRouterConnection(addr, snodeAddr.c_str()); // Filters out bad nodes (banned, etc)
+    }
+
+    releaseNodes(nodes);
+}
+
 void App::runTests() {
     server->runPerformanceTests();
 }
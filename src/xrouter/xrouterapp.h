@@ -5,6 +5,7 @@
 #ifndef BLOCKNET_XROUTER_XROUTERAPP_H
 #define BLOCKNET_XROUTER_XROUTERAPP_H
 
+#include <xrouter/xrouterconfigcache.h>
 #include <xrouter/xrouterdef.h>
 #include <xrouter/xrouterpacket.h>
 #include <xrouter/xrouterquerymgr.h>
@@ -430,6 +431,12 @@ public:
      */
     void onMessageReceived(CNode* node, const std::vector<unsigned char> & message);
     
+    /**
+     * @brief onNodeConnected call when the version handshake with an xrouter node completes
+     * @param pnode connected node
+     */
+    void onNodeConnected(CNode *pnode);
+
     /**
      * @brief run performance tests (xrTest)
      */
@@ -608,6 +615,38 @@ private:
             pnode->Release();
     }
 
+    /**
+     * Parses an xrGetConfig reply.
+     * @param snode Servicenode that sent the reply
+     * @param spubkey Servicenode pubkey
+     * @param reply Config reply
+     * @param settings Parsed config
+     * @param badPlugins Number of plugin configs that failed to parse
+     * @return false if the config is invalid
+     */
+    bool configFromReply(const sn::ServiceNode & snode, const CPubKey & spubkey, const std::string & reply,
+                         XRouterSettingsPtr & settings, int & badPlugins);
+    /**
+     * Returns the version of the config the servicenode is advertising in its ping.
+     * @param snode
+     * @return
+     */
+    static uint256 snodeConfigVersion(const sn::ServiceNode & snode);
+
+    /**
+     * Timer handler, runs every XROUTER_TIMER_SECONDS.
+     */
+    void onTimer();
+    /**
+     * Keeps connections open to the highest scoring servicenodes of the warm services.
+     */
+    void maintainConnectionPool();
+    /**
+     * Requests the config of a connected warm servicenode if it's missing.
+     * @param pnode
+     */
+    void requestWarmConfig(CNode *pnode);
+
     /**
      * DoS any bad nodes based on specified validation state.
      * @param state
@@ -753,9 +792,17 @@ private:
 
     // timer
     boost::asio::io_service timerIo;
+    std::shared_ptr<boost::asio::io_service::work> timerIoWork;
     boost::thread timerThread;
     boost::asio::deadline_timer timer;
 
+    // warm connection pool
+    std::set<NodeAddr> warmNodes;
+    std::vector<std::string> warmConfigQueries;
+    std::unique_ptr<XRouterConfigCache> configCache;
+    boost::mutex connMu;
+    boost::condition_variable connCond;
+
     // Key management
     std::vector<unsigned char> cpubkey;
     std::vector<unsigned char> cprivkey;
@@ -585,10 +585,10 @@ UniValue XRouterClient::uret(const std::string & res, const std::string & uuid)
 }
 
 int XRouterClient::runningCount(const std::string & service) {
-    const auto & list = smgr.list();
+    const auto & list = smgr.listWithService(service);
     int count{0};
     for (const auto & snode : list) {
-        if (snode.running() && snode.hasService(service) && snode.isEXRCompatible())
+        if (snode.running() && snode.isEXRCompatible())
             ++count;
     }
     return count;
@@ -651,12 +651,8 @@ std::string XRouterClient::xrouterCall(enum XRouterCommand command, std::string
                                                               : walletCommandKey(service);
 
         std::vector<sn::ServiceNode> listSelectedSnodes;
-        auto list = smgr.list();
+        auto list = smgr.listWithServices({xr, fqServiceAdjusted}); // has xrouter and the service
         for (const auto & s : list) {
-            if (!s.hasService(xr)) // has xrouter
-                continue;
-            if (!s.hasService(fqServiceAdjusted)) // has the service
-                continue;
             if (!s.running() || !s.isEXRCompatible())
                 continue; // only running snodes and exr compatible snodes
             listSelectedSnodes.push_back(s);
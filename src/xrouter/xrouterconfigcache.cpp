@@ -0,0 +1,133 @@
+// Copyright (c) 2021 The Blocknet developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <xrouter/xrouterconfigcache.h>
+
+#include <xrouter/xrouterlogger.h>
+
+#include <chainparams.h>
+#include <clientversion.h>
+#include <hash.h>
+#include <protocol.h>
+#include <streams.h>
+#include <util/system.h>
+
+namespace xrouter {
+
+bool XRouterConfigCache::load() {
+    FILE *file = fsbridge::fopen(path, "rb");
+    CAutoFile filein(file, SER_DISK, CLIENT_VERSION);
+    if (filein.IsNull())
+        return false;
+
+    std::map<CPubKey, Entry> loaded;
+    try {
+        CHashVerifier<CAutoFile> verifier(&filein);
+        unsigned char magic[CMessageHeader::MESSAGE_START_SIZE];
+        int version{0};
+        verifier >> magic >> version;
+        if (memcmp(magic, Params().MessageStart(), sizeof(magic)) != 0 || version != CURRENT_VERSION) {
+            LOG() << "Discarding servicenode config cache " << path.string() << ", unsupported version " << version;
+            return false;
+        }
+        verifier >> loaded;
+        uint256 hashTmp;
+        filein >> hashTmp;
+        if (hashTmp != verifier.GetHash()) {
+            ERR() << "Discarding servicenode config cache " << path.string() << ", checksum mismatch";
+            return false;
+        }
+    } catch (const std::exception & e) {
+        ERR() << "Failed to read servicenode config cache " << path.string() << ": " << e.what();
+        return false;
+    }
+
+    LOCK(mu);
+    entries = std::move(loaded);
+    dirty = false;
+    return true;
+}
+
+bool XRouterConfigCache::save() {
+    std::map<CPubKey, Entry> copy;
+    {
+        LOCK(mu);
+        if (!dirty)
+            return true;
+        copy = entries;
+        dirty = false;
+    }
+
+    auto failed = [this]() -> bool {
+        LOCK(mu);
+        dirty = true; // try again on the next save
+        return false;
+    };
+
+    const fs::path pathTmp = path.string() + ".new";
+    FILE *file = fsbridge::fopen(pathTmp, "wb");
+    CAutoFile fileout(file, SER_DISK, CLIENT_VERSION);
+    if (fileout.IsNull()) {
+        ERR() << "Failed to open servicenode config cache " << pathTmp.string();
+        return failed();
+    }
+    try {
+        const int version{CURRENT_VERSION};
+        CHashWriter hasher(SER_DISK, CLIENT_VERSION);
+        fileout << Params().MessageStart() << version << copy;
+        hasher << Params().MessageStart() << version << copy;
+        fileout << hasher.GetHash();
+    } catch (const std::exception & e) {
+        ERR() << "Failed to write servicenode config cache " << pathTmp.string() << ": " << e.what();
+        return failed();
+    }
+    if (!FileCommit(fileout.Get())) {
+        ERR() << "Failed to flush servicenode config cache " << pathTmp.string();
+        return failed();
+    }
+    fileout.fclose();
+
+    if (!RenameOver(pathTmp, path)) {
+        ERR() << "Failed to replace servicenode config cache " << path.string();
+        return failed();
+    }
+    return true;
+}
+
+void XRouterConfigCache::put(const CPubKey & snode, const uint256 & version, const std::string & reply) {
+    LOCK(mu);
+    auto & entry = entries[snode];
+    if (entry.version == version && entry.reply == reply)
+        return;
+    entry.version = version;
+    entry.reply = reply;
+    dirty = true;
+}
+
+bool XRouterConfigCache::get(const CPubKey & snode, const uint256 & version, std::string & reply) {
+    LOCK(mu);
+    auto it = entries.find(snode);
+    if (it == entries.end())
+        return false;
+    if (it->second.version != version) { // servicenode changed its config
+        entries.erase(it);
+        dirty = true;
+        return false;
+    }
+    reply = it->second.reply;
+    return true;
+}
+
+void XRouterConfigCache::erase(const CPubKey & snode) {
+    LOCK(mu);
+    if (entries.erase(snode))
+        dirty = true;
+}
+
+size_t XRouterConfigCache::size() {
+    LOCK(mu);
+    return entries.size();
+}
+
+}
@@ -0,0 +1,66 @@
+// Copyright (c) 2021 The Blocknet developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BLOCKNET_XROUTER_XROUTERCONFIGCACHE_H
+#define BLOCKNET_XROUTER_XROUTERCONFIGCACHE_H
+
+#include <fs.h>
+#include <pubkey.h>
+#include <serialize.h>
+#include <sync.h>
+#include <uint256.h>
+
+#include <map>
+#include <string>
+
+namespace xrouter {
+
+/**
+ * Servicenode configs received in xrGetConfig replies, persisted across
+ * restarts so that the replies don't have to be requested again. Each entry
+ * is stored with the version of the servicenode's ping config it was fetched
+ * for and is only returned while the servicenode advertises that version.
+ */
+class XRouterConfigCache
+{
+public:
+    /** Bump when the entry format changes, older caches are discarded */
+    static const int CURRENT_VERSION = 1;
+
+    explicit XRouterConfigCache(fs::path path) : path(std::move(path)) {}
+
+    /** Reads the cache from disk, returns false if there's no usable cache. */
+    bool load();
+    /** Writes the cache to disk if it changed since the last write. */
+    bool save();
+
+    /** Stores the config reply of the servicenode for the specified version. */
+    void put(const CPubKey & snode, const uint256 & version, const std::string & reply);
+    /** Returns false if nothing is cached for the servicenode or the version changed. */
+    bool get(const CPubKey & snode, const uint256 & version, std::string & reply);
+    void erase(const CPubKey & snode);
+    size_t size();
+
+private:
+    struct Entry {
+        uint256 version;
+        std::string reply;
+
+        ADD_SERIALIZE_METHODS;
+        template <typename Stream, typename Operation>
+        inline void SerializationOp(Stream& s, Operation ser_action) {
+            READWRITE(version);
+            READWRITE(reply);
+        }
+    };
+
+    Mutex mu;
+    const fs::path path;
+    std::map<CPubKey, Entry> entries GUARDED_BY(mu);
+    bool dirty GUARDED_BY(mu){false};
+};
+
+}
+
+#endif // BLOCKNET_XROUTER_XROUTERCONFIGCACHE_H
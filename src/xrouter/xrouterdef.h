@@ -15,5 +15,6 @@
 #define XROUTER_DEFAULT_FETCHLIMIT 50
 #define XROUTER_DEFAULT_CONFIRMATIONS 1
 #define XROUTER_TIMER_SECONDS 15
+#define XROUTER_WARM_CONNECTIONS 3   // per warm service
 
 #endif // BLOCKNET_XROUTER_XROUTERDEF_H
@@ -221,6 +221,7 @@ static bool ProcessMessage(XRouterPeerMgr & peerMgr, CNode* pfrom, const std::st
                       (fLogIPs ? strprintf(", peeraddr=%s", pfrom->addr.ToString()) : ""));
         }
         pfrom->fSuccessfullyConnected = true;
+        xrouter::App::instance().onNodeConnected(pfrom);
     }
 
     // Make sure we're connected to the peer
@@ -530,8 +531,9 @@ bool XRouterPeerMgr::ProcessMessages(CNode* pfrom, std::atomic<bool>& interruptM
         return false;
     }
 
-    // If VERACK we're ready to ask for snode list
-    if (strCommand == NetMsgType::VERACK) {
+    // If VERACK we're ready to ask for snode list. Servicenode links are only used
+    // for calls, the list is fetched from the other peers.
+    if (strCommand == NetMsgType::VERACK && sn::ServiceNodeMgr::instance().getSn(pfrom->GetAddrName()).isNull()) {
         const CNetMsgMaker msgMaker(pfrom->GetSendVersion());
         connman->PushMessage(pfrom, msgMaker.Make(NetMsgType::SNLIST));
     }
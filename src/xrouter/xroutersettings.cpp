@@ -482,6 +482,26 @@ int XRouterSettings::configSyncTimeout()
     return res;
 }
 
+std::vector<std::string> XRouterSettings::warmServices()
+{
+    std::vector<std::string> services;
+    std::vector<std::string> parts;
+    std::string ws = get<std::string>("Main.warmservices", "");
+    boost::split(parts, ws, boost::is_any_of(","));
+    for (auto & s : parts) {
+        boost::trim(s);
+        if (hasWalletNamespace(s) || hasPluginNamespace(s))
+            services.push_back(s);
+    }
+    return services;
+}
+
+int XRouterSettings::warmConnections()
+{
+    auto res = get<int>("Main.warmconnections", XROUTER_WARM_CONNECTIONS);
+    return std::max(0, std::min(res, 50)); // openConnections limit
+}
+
 std::map<std::string, double> XRouterSettings::feeSchedule() {
 
     double fee = defaultFee();
@@ -785,6 +805,12 @@ bool createConf(const boost::filesystem::path & confDir, const bool & skipPlugin
                      "#! timeout is the maximum time in seconds you're willing to wait for an XRouter response"          + eol +
                      "timeout=30"                                                                                        + eol +
                      ""                                                                                                  + eol +
+                     "#! warmservices keeps connections open to the best service nodes of the listed services so"        + eol +
+                     "#! that calls don't have to wait for new connections (optional)."                                  + eol +
+                     "#! warmconnections is the number of connections kept per service (default 3)."                    + eol +
+                     "#! warmservices=xr::BLOCK,xrs::ExampleRPC"                                                         + eol +
+                     "#! warmconnections=3"                                                                              + eol +
+                     ""                                                                                                  + eol +
                      "#! Optionally set per-call config options:"                                                        + eol +
                      "#! [xrGetBlockCount]"                                                                              + eol +
                      "#! maxfee=0.01"                                                                                    + eol +
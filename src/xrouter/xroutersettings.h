@@ -202,6 +202,8 @@ public:
     int confirmations(XRouterCommand c, std::string currency="", int def=XROUTER_DEFAULT_CONFIRMATIONS); // 1 confirmation default
     std::string paymentAddress(XRouterCommand c, const std::string & service="");
     int configSyncTimeout();
+    std::vector<std::string> warmServices();
+    int warmConnections();
 
     double defaultFee();
     std::map<std::string, double> feeSchedule();
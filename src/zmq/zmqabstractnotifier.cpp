@@ -21,3 +21,33 @@ bool CZMQAbstractNotifier::NotifyTransaction(const CTransaction &/*transaction*/
 {
     return true;
 }
+
+bool CZMQAbstractNotifier::NotifyProposal(const gov::Proposal &/*proposal*/)
+{
+    return true;
+}
+
+bool CZMQAbstractNotifier::NotifyVote(const gov::Vote &/*vote*/)
+{
+    return true;
+}
+
+bool CZMQAbstractNotifier::NotifyServiceNodeRegistered(const sn::ServiceNode &/*snode*/)
+{
+    return true;
+}
+
+bool CZMQAbstractNotifier::NotifyServiceNodePing(const sn::ServiceNodePing &/*ping*/)
+{
+    return true;
+}
+
+bool CZMQAbstractNotifier::NotifyServiceNodeStateChanged(const sn::ServiceNode &/*snode*/)
+{
+    return true;
+}
+
+bool CZMQAbstractNotifier::NotifyXBridgeOrder(const xbridge::TransactionDescr &/*order*/)
+{
+    return true;
+}
@@ -10,6 +10,18 @@
 class CBlockIndex;
 class CZMQAbstractNotifier;
 
+namespace gov {
+class Proposal;
+class Vote;
+}
+namespace sn {
+class ServiceNode;
+class ServiceNodePing;
+}
+namespace xbridge {
+struct TransactionDescr;
+}
+
 typedef CZMQAbstractNotifier* (*CZMQNotifierFactory)();
 
 class CZMQAbstractNotifier
@@ -43,6 +55,13 @@ public:
     virtual bool NotifyBlock(const CBlockIndex *pindex);
     virtual bool NotifyTransaction(const CTransaction &transaction);
 
+    virtual bool NotifyProposal(const gov::Proposal &proposal);
+    virtual bool NotifyVote(const gov::Vote &vote);
+    virtual bool NotifyServiceNodeRegistered(const sn::ServiceNode &snode);
+    virtual bool NotifyServiceNodePing(const sn::ServiceNodePing &ping);
+    virtual bool NotifyServiceNodeStateChanged(const sn::ServiceNode &snode);
+    virtual bool NotifyXBridgeOrder(const xbridge::TransactionDescr &order);
+
 protected:
     void *psocket;
     std::string type;
@@ -23,6 +23,7 @@ CZMQNotificationInterface::~CZMQNotificationInterface()
 {
     Shutdown();
 
+    LOCK(cs_notifiers);
     for (std::list<CZMQAbstractNotifier*>::iterator i=notifiers.begin(); i!=notifiers.end(); ++i)
     {
         delete *i;
@@ -32,6 +33,7 @@ CZMQNotificationInterface::~CZMQNotificationInterface()
 std::list<const CZMQAbstractNotifier*> CZMQNotificationInterface::GetActiveNotifiers() const
 {
     std::list<const CZMQAbstractNotifier*> result;
+    LOCK(cs_notifiers);
     for (const auto* n : notifiers) {
         result.push_back(n);
     }
@@ -48,6 +50,9 @@ CZMQNotificationInterface* CZMQNotificationInterface::Create()
     factories["pubhashtx"] = CZMQAbstractNotifier::Create<CZMQPublishHashTransactionNotifier>;
     factories["pubrawblock"] = CZMQAbstractNotifier::Create<CZMQPublishRawBlockNotifier>;
     factories["pubrawtx"] = CZMQAbstractNotifier::Create<CZMQPublishRawTransactionNotifier>;
+    factories["pubgovernance"] = CZMQAbstractNotifier::Create<CZMQPublishGovernanceNotifier>;
+    factories["pubservicenode"] = CZMQAbstractNotifier::Create<CZMQPublishServiceNodeNotifier>;
+    factories["pubxbridgeorder"] = CZMQAbstractNotifier::Create<CZMQPublishXBridgeOrderNotifier>;
 
     for (const auto& entry : factories)
     {
@@ -67,7 +72,10 @@ CZMQNotificationInterface* CZMQNotificationInterface::Create()
     if (!notifiers.empty())
     {
         notificationInterface = new CZMQNotificationInterface();
-        notificationInterface->notifiers = notifiers;
+        {
+            LOCK(notificationInterface->cs_notifiers);
+            notificationInterface->notifiers = notifiers;
+        }
 
         if (!notificationInterface->Initialize())
         {
@@ -97,6 +105,7 @@ bool CZMQNotificationInterface::Initialize()
         return false;
     }
 
+    LOCK(cs_notifiers);
     std::list<CZMQAbstractNotifier*>::iterator i=notifiers.begin();
     for (; i!=notifiers.end(); ++i)
     {
@@ -126,6 +135,7 @@ void CZMQNotificationInterface::Shutdown()
     LogPrint(BCLog::ZMQ, "zmq: Shutdown notification interface\n");
     if (pcontext)
     {
+        LOCK(cs_notifiers);
         for (std::list<CZMQAbstractNotifier*>::iterator i=notifiers.begin(); i!=notifiers.end(); ++i)
         {
             CZMQAbstractNotifier *notifier = *i;
@@ -138,15 +148,14 @@ void CZMQNotificationInterface::Shutdown()
     }
 }
 
-void CZMQNotificationInterface::UpdatedBlockTip(const CBlockIndex *pindexNew, const CBlockIndex *pindexFork, bool fInitialDownload)
+template <typename Function>
+void CZMQNotificationInterface::TryForEachAndRemoveFailed(const Function& func)
 {
-    if (fInitialDownload || pindexNew == pindexFork) // In IBD or blocks were disconnected without any new ones
-        return;
-
+    LOCK(cs_notifiers);
     for (std::list<CZMQAbstractNotifier*>::iterator i = notifiers.begin(); i!=notifiers.end(); )
     {
         CZMQAbstractNotifier *notifier = *i;
-        if (notifier->NotifyBlock(pindexNew))
+        if (func(notifier))
         {
             i++;
         }
@@ -158,25 +167,25 @@ void CZMQNotificationInterface::UpdatedBlockTip(const CBlockIndex *pindexNew, co
     }
 }
 
+void CZMQNotificationInterface::UpdatedBlockTip(const CBlockIndex *pindexNew, const CBlockIndex *pindexFork, bool fInitialDownload)
+{
+    if (fInitialDownload || pindexNew == pindexFork) // In IBD or blocks were disconnected without any new ones
+        return;
+
+    TryForEachAndRemoveFailed([pindexNew](CZMQAbstractNotifier* notifier) {
+        return notifier->NotifyBlock(pindexNew);
+    });
+}
+
 void CZMQNotificationInterface::TransactionAddedToMempool(const CTransactionRef& ptx)
 {
     // Used by BlockConnected and BlockDisconnected as well, because they're
     // all the same external callback.
     const CTransaction& tx = *ptx;
 
-    for (std::list<CZMQAbstractNotifier*>::iterator i = notifiers.begin(); i!=notifiers.end(); )
-    {
-        CZMQAbstractNotifier *notifier = *i;
-        if (notifier->NotifyTransaction(tx))
-        {
-            i++;
-        }
-        else
-        {
-            notifier->Shutdown();
-            i = notifiers.erase(i);
-        }
-    }
+    TryForEachAndRemoveFailed([&tx](CZMQAbstractNotifier* notifier) {
+        return notifier->NotifyTransaction(tx);
+    });
 }
 
 void CZMQNotificationInterface::BlockConnected(const std::shared_ptr<const CBlock>& pblock, const CBlockIndex* pindexConnected, const std::vector<CTransactionRef>& vtxConflicted)
@@ -195,4 +204,46 @@ void CZMQNotificationInterface::BlockDisconnected(const std::shared_ptr<const CB
     }
 }
 
+void CZMQNotificationInterface::NotifyProposal(const gov::Proposal& proposal)
+{
+    TryForEachAndRemoveFailed([&proposal](CZMQAbstractNotifier* notifier) {
+        return notifier->NotifyProposal(proposal);
+    });
+}
+
+void CZMQNotificationInterface::NotifyVote(const gov::Vote& vote)
+{
+    TryForEachAndRemoveFailed([&vote](CZMQAbstractNotifier* notifier) {
+        return notifier->NotifyVote(vote);
+    });
+}
+
+void CZMQNotificationInterface::NotifyServiceNodeRegistered(const sn::ServiceNode& snode)
+{
+    TryForEachAndRemoveFailed([&snode](CZMQAbstractNotifier* notifier) {
+        return notifier->NotifyServiceNodeRegistered(snode);
+    });
+}
+
+void CZMQNotificationInterface::NotifyServiceNodePing(const sn::ServiceNodePing& ping)
+{
+    TryForEachAndRemoveFailed([&ping](CZMQAbstractNotifier* notifier) {
+        return notifier->NotifyServiceNodePing(ping);
+    });
+}
+
+void CZMQNotificationInterface::NotifyServiceNodeStateChanged(const sn::ServiceNode& snode)
+{
+    TryForEachAndRemoveFailed([&snode](CZMQAbstractNotifier* notifier) {
+        return notifier->NotifyServiceNodeStateChanged(snode);
+    });
+}
+
+void CZMQNotificationInterface::NotifyXBridgeOrder(const xbridge::TransactionDescr& order)
+{
+    TryForEachAndRemoveFailed([&order](CZMQAbstractNotifier* notifier) {
+        return notifier->NotifyXBridgeOrder(order);
+    });
+}
+
 CZMQNotificationInterface* g_zmq_notification_interface = nullptr;
@@ -5,6 +5,7 @@
 #ifndef BITCOIN_ZMQ_ZMQNOTIFICATIONINTERFACE_H
 #define BITCOIN_ZMQ_ZMQNOTIFICATIONINTERFACE_H
 
+#include <sync.h>
 #include <validationinterface.h>
 #include <string>
 #include <map>
@@ -13,6 +14,18 @@
 class CBlockIndex;
 class CZMQAbstractNotifier;
 
+namespace gov {
+class Proposal;
+class Vote;
+}
+namespace sn {
+class ServiceNode;
+class ServiceNodePing;
+}
+namespace xbridge {
+struct TransactionDescr;
+}
+
 class CZMQNotificationInterface final : public CValidationInterface
 {
 public:
@@ -22,6 +35,14 @@ public:
 
     static CZMQNotificationInterface* Create();
 
+    // Blocknet events, these may be called from any thread
+    void NotifyProposal(const gov::Proposal& proposal);
+    void NotifyVote(const gov::Vote& vote);
+    void NotifyServiceNodeRegistered(const sn::ServiceNode& snode);
+    void NotifyServiceNodePing(const sn::ServiceNodePing& ping);
+    void NotifyServiceNodeStateChanged(const sn::ServiceNode& snode);
+    void NotifyXBridgeOrder(const xbridge::TransactionDescr& order);
+
 protected:
     bool Initialize();
     void Shutdown();
@@ -35,8 +56,15 @@ protected:
 private:
     CZMQNotificationInterface();
 
+    /** Calls func on every notifier, notifiers that fail are shut down and removed */
+    template <typename Function>
+    void TryForEachAndRemoveFailed(const Function& func);
+
     void *pcontext;
-    std::list<CZMQAbstractNotifier*> notifiers;
+    // Notifiers are used by the validation callbacks and by the blocknet
+    // subsystems on their own threads, zmq sockets are not thread safe.
+    mutable Mutex cs_notifiers;
+    std::list<CZMQAbstractNotifier*> notifiers GUARDED_BY(cs_notifiers);
 };
 
 extern CZMQNotificationInterface* g_zmq_notification_interface;
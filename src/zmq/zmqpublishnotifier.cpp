@@ -4,11 +4,14 @@
 
 #include <chain.h>
 #include <chainparams.h>
+#include <governance/governance.h>
+#include <servicenode/servicenode.h>
 #include <streams.h>
 #include <zmq/zmqpublishnotifier.h>
 #include <validation.h>
 #include <util/system.h>
 #include <rpc/server.h>
+#include <xbridge/xbridgetransactiondescr.h>
 
 static std::multimap<std::string, CZMQAbstractPublishNotifier*> mapPublishNotifiers;
 
@@ -16,6 +19,12 @@ static const char *MSG_HASHBLOCK = "hashblock";
 static const char *MSG_HASHTX    = "hashtx";
 static const char *MSG_RAWBLOCK  = "rawblock";
 static const char *MSG_RAWTX     = "rawtx";
+static const char *MSG_GOVPROPOSAL  = "govproposal";
+static const char *MSG_GOVVOTE      = "govvote";
+static const char *MSG_SNODEREG     = "snodereg";
+static const char *MSG_SNODEPING    = "snodeping";
+static const char *MSG_SNODESTATE   = "snodestate";
+static const char *MSG_XBRIDGEORDER = "xbridgeorder";
 
 // Internal function to send multipart message
 static int zmq_send_multipart(void *sock, const void* data, size_t size, ...)
@@ -181,6 +190,15 @@ bool CZMQPublishRawBlockNotifier::NotifyBlock(const CBlockIndex *pindex)
 {
     LogPrint(BCLog::ZMQ, "zmq: Publish rawblock %s\n", pindex->GetBlockHash().GetHex());
 
+    CRawBlockRef rawBlock;
+    if (!ReadRawBlockFromDiskCached(rawBlock, pindex, Params().MessageStart()))
+    {
+        zmqError("Can't read block from disk");
+        return false;
+    }
+    if (!(RPCSerializationFlags() & SERIALIZE_TRANSACTION_NO_WITNESS) || !rawBlock->fHasWitness)
+        return SendMessage(MSG_RAWBLOCK, rawBlock->data.data(), rawBlock->data.size());
+
     const Consensus::Params& consensusParams = Params().GetConsensus();
     CDataStream ss(SER_NETWORK, PROTOCOL_VERSION | RPCSerializationFlags());
     {
@@ -206,3 +224,55 @@ bool CZMQPublishRawTransactionNotifier::NotifyTransaction(const CTransaction &tr
     ss << transaction;
     return SendMessage(MSG_RAWTX, &(*ss.begin()), ss.size());
 }
+
+bool CZMQPublishGovernanceNotifier::NotifyProposal(const gov::Proposal &proposal)
+{
+    LogPrint(BCLog::ZMQ, "zmq: Publish govproposal %s\n", proposal.getHash().GetHex());
+    CDataStream ss(SER_NETWORK, PROTOCOL_VERSION);
+    ss << proposal.getHash() << proposal.getSuperblock() << proposal.getAmount()
+       << proposal.getBlockNumber() << proposal.getName();
+    return SendMessage(MSG_GOVPROPOSAL, &(*ss.begin()), ss.size());
+}
+
+bool CZMQPublishGovernanceNotifier::NotifyVote(const gov::Vote &vote)
+{
+    LogPrint(BCLog::ZMQ, "zmq: Publish govvote %s\n", vote.getHash().GetHex());
+    CDataStream ss(SER_NETWORK, PROTOCOL_VERSION);
+    ss << vote.getHash() << vote.getProposal() << static_cast<uint8_t>(vote.getVote())
+       << vote.getUtxo() << vote.getAmount() << vote.getBlockNumber();
+    return SendMessage(MSG_GOVVOTE, &(*ss.begin()), ss.size());
+}
+
+bool CZMQPublishServiceNodeNotifier::NotifyServiceNodeRegistered(const sn::ServiceNode &snode)
+{
+    LogPrint(BCLog::ZMQ, "zmq: Publish snodereg %s\n", HexStr(snode.getSnodePubKey()));
+    CDataStream ss(SER_NETWORK, PROTOCOL_VERSION);
+    ss << snode.getSnodePubKey() << static_cast<uint8_t>(snode.getTier())
+       << snode.getPaymentAddress() << snode.getBestBlock();
+    return SendMessage(MSG_SNODEREG, &(*ss.begin()), ss.size());
+}
+
+bool CZMQPublishServiceNodeNotifier::NotifyServiceNodePing(const sn::ServiceNodePing &ping)
+{
+    LogPrint(BCLog::ZMQ, "zmq: Publish snodeping %s\n", HexStr(ping.getSnodePubKey()));
+    CDataStream ss(SER_NETWORK, PROTOCOL_VERSION);
+    ss << ping.getSnodePubKey() << ping.getPingTime() << ping.getHash();
+    return SendMessage(MSG_SNODEPING, &(*ss.begin()), ss.size());
+}
+
+bool CZMQPublishServiceNodeNotifier::NotifyServiceNodeStateChanged(const sn::ServiceNode &snode)
+{
+    LogPrint(BCLog::ZMQ, "zmq: Publish snodestate %s\n", HexStr(snode.getSnodePubKey()));
+    CDataStream ss(SER_NETWORK, PROTOCOL_VERSION);
+    ss << snode.getSnodePubKey() << snode.getInvalid() << snode.getInvalidBlockNumber();
+    return SendMessage(MSG_SNODESTATE, &(*ss.begin()), ss.size());
+}
+
+bool CZMQPublishXBridgeOrderNotifier::NotifyXBridgeOrder(const xbridge::TransactionDescr &order)
+{
+    LogPrint(BCLog::ZMQ, "zmq: Publish xbridgeorder %s\n", order.id.GetHex());
+    CDataStream ss(SER_NETWORK, PROTOCOL_VERSION);
+    ss << order.id << static_cast<int32_t>(order.state)
+       << order.fromCurrency << order.fromAmount << order.toCurrency << order.toAmount;
+    return SendMessage(MSG_XBRIDGEORDER, &(*ss.begin()), ss.size());
+}
@@ -52,4 +52,28 @@ public:
     bool NotifyTransaction(const CTransaction &transaction) override;
 };
 
+/** Publishes proposals and votes accepted on the chain tip */
+class CZMQPublishGovernanceNotifier : public CZMQAbstractPublishNotifier
+{
+public:
+    bool NotifyProposal(const gov::Proposal &proposal) override;
+    bool NotifyVote(const gov::Vote &vote) override;
+};
+
+/** Publishes servicenode registrations, pings and state changes */
+class CZMQPublishServiceNodeNotifier : public CZMQAbstractPublishNotifier
+{
+public:
+    bool NotifyServiceNodeRegistered(const sn::ServiceNode &snode) override;
+    bool NotifyServiceNodePing(const sn::ServiceNodePing &ping) override;
+    bool NotifyServiceNodeStateChanged(const sn::ServiceNode &snode) override;
+};
+
+/** Publishes XBridge order state transitions */
+class CZMQPublishXBridgeOrderNotifier : public CZMQAbstractPublishNotifier
+{
+public:
+    bool NotifyXBridgeOrder(const xbridge::TransactionDescr &order) override;
+};
+
 #endif // BITCOIN_ZMQ_ZMQPUBLISHNOTIFIER_H